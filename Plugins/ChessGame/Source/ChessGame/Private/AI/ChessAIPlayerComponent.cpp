@@ -0,0 +1,291 @@
+#include "AI/ChessAIPlayerComponent.h"
+#include "AI/ChessISMCTS.h"
+#include "AI/ChessParallelSearch.h"
+#include "AI/ChessTranspositionTable.h"
+#include "Async/Async.h"
+#include "Tasks/Task.h"
+#include "TimerManager.h"
+#include "Logic/ChessBoardState.h"
+#include "Logic/ChessEvalWeights.h"
+#include "Logic/ChessEvaluation.h"
+#include "Logic/ChessGameModel.h"
+#include "Logic/ChessNNUE.h"
+#include "Presentation/ChessBoardActor.h"
+#include "Presentation/ChessPlayerController.h"
+
+/**
+ * One search in flight. Shared between the game thread and the workers; the workers only read the limits, play
+ * on SearchBoards, which nothing else references, and use the lock-free table. The boards are rooted for the
+ * job's lifetime and released on the game thread once the workers are done with them.
+ */
+struct FChessAISearchJob
+{
+	std::atomic<bool> bStop{ false };
+	TArray<UChessBoardState*> SearchBoards;
+	TSharedPtr<FChessTranspositionTable, ESPMode::ThreadSafe> Table;
+	TSharedPtr<FChessEvalParams, ESPMode::ThreadSafe> EvalParams;
+	TSharedPtr<const FChessNNUENetwork, ESPMode::ThreadSafe> Network;
+	TArray<TUniquePtr<FChessNNUEAccumulator>> Accumulators;
+	uint64 RootHash = 0;
+	FChessSearchLimits Limits;
+
+	// Positions played before the root since the last irreversible move, so the search sees repetitions of them
+	TArray<uint64> GameHistory;
+
+	// Search with ISMCTS rather than alpha-beta, because the opponent's masks hide what the boards know
+	bool bHiddenInformation = false;
+
+	// The AI's read on those masks when the search started
+	FChessMaskBelief Belief;
+};
+
+UChessAIPlayerComponent::UChessAIPlayerComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+void UChessAIPlayerComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (bAutoStart)
+	{
+		StartPlaying();
+	}
+}
+
+void UChessAIPlayerComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	StopPlaying();
+	Super::EndPlay(EndPlayReason);
+}
+
+void UChessAIPlayerComponent::StartPlaying()
+{
+	if (!GetOwner() || !GetOwner()->HasAuthority()) return;
+	if (BoundModel) return;
+
+	if (!Board)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("ChessAIPlayerComponent: %s has no Board to play on"), *GetName());
+		return;
+	}
+
+	// The board builds its game model in its own BeginPlay, which may not have run yet
+	if (!Board->GameModel)
+	{
+		if (StartRetries++ < MaxStartRetries)
+		{
+			GetWorld()->GetTimerManager().SetTimerForNextTick(this, &UChessAIPlayerComponent::StartPlaying);
+		}
+		else
+		{
+			UE_LOG(LogTemp, Warning, TEXT("ChessAIPlayerComponent: %s never got a game model; not playing"), *Board->GetName());
+			StartRetries = 0;
+		}
+		return;
+	}
+
+	StartRetries = 0;
+	PlayOn(Board->GameModel);
+}
+
+void UChessAIPlayerComponent::PlayOn(UChessGameModel* Model)
+{
+	if (!Model || BoundModel) return;
+
+	if (!Model->RuleSet || !Model->RuleSet->UsesStandardRules())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("ChessAIPlayerComponent: %s uses custom rules, which the AI cannot search"), *(Board ? Board->GetName() : Model->GetName()));
+		return;
+	}
+
+	BoundModel = Model;
+	Table = MakeShared<FChessTranspositionTable, ESPMode::ThreadSafe>(HashSizeMB);
+	EvalParams = MakeShared<FChessEvalParams, ESPMode::ThreadSafe>(FChessEvalParams::GetDefault());
+	if (EvalWeights)
+	{
+		EvalWeights->BuildParams(*EvalParams);
+	}
+	if (!NeuralNetworkFile.FilePath.IsEmpty())
+	{
+		Network = FChessNNUENetwork::LoadFromFile(NeuralNetworkFile.FilePath);
+		if (!Network.IsValid())
+		{
+			UE_LOG(LogTemp, Warning, TEXT("ChessAIPlayerComponent: falling back to the hand-tuned evaluation"));
+		}
+	}
+	BoundModel->OnTurnChanged.AddDynamic(this, &UChessAIPlayerComponent::OnTurnChanged);
+	BoundModel->OnGameEnded.AddDynamic(this, &UChessAIPlayerComponent::OnGameEnded);
+
+	// The opening turn may already belong to us
+	OnTurnChanged(BoundModel->BoardState->SideToMove);
+}
+
+void UChessAIPlayerComponent::StopPlaying()
+{
+	CancelSearch();
+
+	if (BoundModel)
+	{
+		BoundModel->OnTurnChanged.RemoveDynamic(this, &UChessAIPlayerComponent::OnTurnChanged);
+		BoundModel->OnGameEnded.RemoveDynamic(this, &UChessAIPlayerComponent::OnGameEnded);
+		BoundModel = nullptr;
+	}
+	Table.Reset();
+	EvalParams.Reset();
+	Network.Reset();
+
+	if (UWorld* World = GetWorld())
+	{
+		World->GetTimerManager().ClearAllTimersForObject(this);
+	}
+}
+
+void UChessAIPlayerComponent::OnTurnChanged(EPieceColor SideToMove)
+{
+	// Whatever was being searched belongs to a position that no longer exists
+	CancelSearch();
+
+	if (SideToMove == AIColor && BoundModel && !BoundModel->BoardState->bIsGameOver)
+	{
+		StartSearch();
+	}
+}
+
+void UChessAIPlayerComponent::OnGameEnded(bool bIsDraw, EPieceColor Winner)
+{
+	CancelSearch();
+}
+
+void UChessAIPlayerComponent::StartSearch()
+{
+	const UChessBoardState* LiveBoard = BoundModel->BoardState;
+
+	TSharedRef<FChessAISearchJob, ESPMode::ThreadSafe> Job = MakeShared<FChessAISearchJob, ESPMode::ThreadSafe>();
+	Job->RootHash = LiveBoard->GetHash();
+	Job->Limits.MaxDepth = MaxDepth;
+	Job->Limits.MaxSeconds = SearchTimeSeconds;
+	Job->Limits.MaxNodes = (uint64)FMath::Max<int64>(MaxNodes, 0);
+
+	// The model's window ends with the root itself, which the search tracks on its own path
+	BoundModel->GetPositionKeys(Job->GameHistory);
+	if (Job->GameHistory.Num() > 0)
+	{
+		Job->GameHistory.Pop();
+	}
+
+	// Results from earlier moves stay usable but give way to this search's
+	Table->NewSearch();
+	Job->Table = Table;
+	Job->EvalParams = EvalParams;
+	Job->Network = Network;
+	Job->bHiddenInformation = bRespectMasks && FChessISMCTS::HasHiddenPieces(LiveBoard, AIColor);
+	if (Job->bHiddenInformation)
+	{
+		Job->Belief = BoundModel->GetMaskBelief(AIColor);
+	}
+
+	// Each search thread gets its own board built from the value snapshot, so the live one is never shared across threads
+	const FChessBoardStateData Snapshot = LiveBoard->ToStruct();
+	const int32 NumThreads = FChessParallelSearch::ResolveThreadCount(SearchThreads);
+	for (int32 i = 0; i < NumThreads; ++i)
+	{
+		UChessBoardState* SearchBoard = NewObject<UChessBoardState>(GetTransientPackage());
+		SearchBoard->SetEvalParams(Job->EvalParams.Get());
+		SearchBoard->FromStruct(Snapshot);
+		if (Job->Network.IsValid())
+		{
+			SearchBoard->SetNNUEAccumulator(Job->Accumulators.Add_GetRef(MakeUnique<FChessNNUEAccumulator>(*Job->Network)).Get());
+		}
+		SearchBoard->AddToRoot();
+		Job->SearchBoards.Add(SearchBoard);
+	}
+	ActiveJob = Job;
+
+	TWeakObjectPtr<UChessAIPlayerComponent> WeakThis(this);
+	UE::Tasks::Launch(UE_SOURCE_LOCATION, [WeakThis, Job]()
+	{
+		FChessSearchResult Result;
+		if (Job->bHiddenInformation)
+		{
+			FChessISMCTS Search(Job->SearchBoards);
+			Search.SetBelief(&Job->Belief);
+			Result = Search.Search(Job->Limits, &Job->bStop);
+		}
+		else
+		{
+			FChessParallelSearch Search(Job->SearchBoards, Job->Table.Get());
+			Search.SetGameHistory(Job->GameHistory);
+			Result = Search.Search(Job->Limits, &Job->bStop);
+		}
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, Job, BestMove = Result.BestMove]()
+		{
+			for (UChessBoardState* SearchBoard : Job->SearchBoards)
+			{
+				SearchBoard->SetNNUEAccumulator(nullptr);
+				SearchBoard->RemoveFromRoot();
+			}
+			Job->SearchBoards.Reset();
+
+			if (UChessAIPlayerComponent* This = WeakThis.Get())
+			{
+				This->OnSearchFinished(Job, BestMove);
+			}
+		});
+	}, ETaskPriority::BackgroundNormal);
+}
+
+void UChessAIPlayerComponent::CancelSearch()
+{
+	// Never waits: the worker notices the flag within a thousand or so nodes and its result is dropped on arrival
+	if (ActiveJob.IsValid())
+	{
+		ActiveJob->bStop = true;
+		ActiveJob.Reset();
+	}
+}
+
+void UChessAIPlayerComponent::OnSearchFinished(const TSharedRef<FChessAISearchJob, ESPMode::ThreadSafe>& Job, FChessPackedMove BestMove)
+{
+	if (ActiveJob != Job || Job->bStop)
+	{
+		return;
+	}
+	ActiveJob.Reset();
+
+	if (!BoundModel || BoundModel->BoardState->bIsGameOver || BoundModel->BoardState->SideToMove != AIColor)
+	{
+		return;
+	}
+
+	// A card effect changed the position mid-search without passing the turn; think again
+	if (BoundModel->BoardState->GetHash() != Job->RootHash)
+	{
+		StartSearch();
+		return;
+	}
+
+	if (!BestMove.IsNull())
+	{
+		SubmitMove(BestMove);
+	}
+}
+
+void UChessAIPlayerComponent::SubmitMove(FChessPackedMove Move)
+{
+	if (!Board)
+	{
+		// Bound with PlayOn: there is no board actor to route through
+		BoundModel->TryApplyMove(Move.ToMove(BoundModel->BoardState));
+	}
+	else if (AChessPlayerController* PC = Cast<AChessPlayerController>(GetOwner()))
+	{
+		PC->Server_SubmitMove(Board, Move);
+	}
+	else
+	{
+		Board->ProcessMove(Move);
+	}
+}
@@ -0,0 +1,527 @@
+#include "AI/ChessISMCTS.h"
+#include "AI/ChessMovePicker.h"
+#include "AI/ChessStaticExchange.h"
+#include "Logic/ChessBoardState.h"
+#include "Logic/ChessEvaluation.h"
+#include "Logic/ChessLegalMoveGenerator.h"
+#include "Logic/ChessMaskBelief.h"
+
+namespace
+{
+	// Rewards are summed in fixed point so they can live in a plain atomic
+	constexpr int64 RewardOne = 1 << 16;
+
+	// Iterations between clock reads on the main thread
+	constexpr uint64 LimitCheckInterval = 64;
+
+	// Playouts longer than this are cut short whatever the settings ask for
+	constexpr int32 MaxPlayoutPlies = 32;
+
+	// Iteration budget when the caller sets neither a time nor an iteration limit
+	constexpr uint64 DefaultIterations = 100000;
+
+	// Draws tried before an iteration is given up as having no possible determinization
+	constexpr int32 MaxDeterminizeAttempts = 8;
+}
+
+struct FChessISMCTS::FNode
+{
+	// The move that leads here from the parent
+	FChessPackedMove Move;
+
+	// Written before the node is published and never changed after, so readers need no lock
+	int32 NextSibling = INDEX_NONE;
+	std::atomic<int32> FirstChild{ INDEX_NONE };
+
+	std::atomic<int32> Visits{ 0 };
+	std::atomic<int32> VirtualLosses{ 0 };
+
+	// Iterations in which this node's move was legal when its parent was reached
+	std::atomic<int32> Availability{ 0 };
+
+	// Sum of rewards for the side that played Move, in RewardOne units
+	std::atomic<int64> RewardSum{ 0 };
+
+	// Held while a child is being added
+	std::atomic<bool> bChildLock{ false };
+
+	void Reset(FChessPackedMove InMove)
+	{
+		Move = InMove;
+		NextSibling = INDEX_NONE;
+		FirstChild.store(INDEX_NONE, std::memory_order_relaxed);
+		Visits.store(0, std::memory_order_relaxed);
+		VirtualLosses.store(0, std::memory_order_relaxed);
+		Availability.store(0, std::memory_order_relaxed);
+		RewardSum.store(0, std::memory_order_relaxed);
+		bChildLock.store(false, std::memory_order_relaxed);
+	}
+};
+
+struct FChessISMCTS::FWorker
+{
+	UChessBoardState* Board = nullptr;
+	FRandomStream Rng;
+
+	// Nodes visited by the current iteration, root first
+	int32 Path[ChessSearch::MaxPly + 1];
+	int32 PathLength = 0;
+
+	// Every move the current iteration made, tree and playout alike
+	FMoveUndoRecord Undo[ChessSearch::MaxPly + MaxPlayoutPlies];
+	int32 NumUndo = 0;
+
+	int32 MaxPathLength = 0;
+};
+
+FChessISMCTS::FChessISMCTS(TArrayView<UChessBoardState* const> InBoards, const FChessISMCTSSettings& InSettings)
+	: Settings(InSettings)
+{
+	Settings.MaxTreeNodes = FMath::Max(Settings.MaxTreeNodes, 1);
+	Settings.PlayoutPlies = FMath::Clamp(Settings.PlayoutPlies, 0, MaxPlayoutPlies);
+	Nodes = new FNode[Settings.MaxTreeNodes];
+
+	Boards.Append(InBoards.GetData(), FMath::Min(InBoards.Num(), ChessSearch::MaxThreads));
+	for (int32 i = 0; i < Boards.Num(); ++i)
+	{
+		TUniquePtr<FWorker> Worker = MakeUnique<FWorker>();
+		Worker->Board = Boards[i];
+		Worker->Rng.Initialize(0x5EED + i);
+		Workers.Add(MoveTemp(Worker));
+	}
+}
+
+FChessISMCTS::~FChessISMCTS()
+{
+	delete[] Nodes;
+}
+
+bool FChessISMCTS::HasHiddenPieces(const UChessBoardState* Board, EPieceColor InObserver)
+{
+	const EPieceColor Opponent = (InObserver == EPieceColor::White) ? EPieceColor::Black : EPieceColor::White;
+	uint64 Masked = 0;
+	for (int32 Type = 0; Type < ChessBitboard::NumPieceTypes; ++Type)
+	{
+		Masked |= Board->GetMaskOccupancy((EPieceType)Type);
+	}
+	return (Masked & Board->GetColorOccupancy(Opponent)) != 0;
+}
+
+FChessSearchResult FChessISMCTS::Search(const FChessSearchLimits& Limits, const std::atomic<bool>* StopFlag)
+{
+	FChessSearchResult Result;
+	if (Boards.Num() == 0)
+	{
+		return Result;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	UChessBoardState* RootBoard = Boards[0];
+	Observer = RootBoard->SideToMove;
+
+	RootMoves.Reset();
+	FChessCheckInfo Info;
+	if (!Info.Init(RootBoard, Observer))
+	{
+		return Result;
+	}
+	FChessLegalMoveGenerator::GenerateAllMoves(RootBoard, Info, RootMoves);
+	if (RootMoves.Num() == 0)
+	{
+		return Result;
+	}
+	Result.BestMove = RootMoves[0];
+	if (RootMoves.Num() == 1)
+	{
+		return Result;
+	}
+
+	HiddenIds.Reset();
+	HiddenTypes.Reset();
+	const EPieceColor Opponent = (Observer == EPieceColor::White) ? EPieceColor::Black : EPieceColor::White;
+	for (uint64 Ids = RootBoard->GetPieceIds(Opponent); Ids; )
+	{
+		const int32 PieceId = ChessBitboard::PopLsb(Ids);
+		const FPieceInstance* Piece = RootBoard->GetPiece(PieceId);
+		if (ChessBitboard::IsValidType(Piece->MaskType) && RootBoard->GetPieceSquare(PieceId) >= 0)
+		{
+			HiddenIds.Add(PieceId);
+			HiddenTypes.Add(Piece->Type);
+		}
+	}
+	bOpponentHasKing = RootBoard->GetPieceOccupancy(Opponent, EPieceType::King) != 0;
+
+	Nodes[0].Reset(FChessPackedMove());
+	NumNodes.store(1, std::memory_order_relaxed);
+	Iterations.store(0, std::memory_order_relaxed);
+	bStop.store(false, std::memory_order_relaxed);
+	MaxIterations = (Limits.MaxNodes == 0 && Limits.MaxSeconds <= 0.0) ? DefaultIterations : Limits.MaxNodes;
+	for (TUniquePtr<FWorker>& Worker : Workers)
+	{
+		Worker->MaxPathLength = 0;
+	}
+
+	// The main thread owns the limits; helpers just run until it says stop
+	ChessSearch::RunWithHelpers(Workers.Num(), bStop,
+		[this](int32 Index)
+		{
+			RunWorker(*Workers[Index]);
+		},
+		[this, &Limits, StopFlag, StartTime]()
+		{
+			FWorker& Main = *Workers[0];
+			while (!bStop.load(std::memory_order_relaxed))
+			{
+				RunIteration(Main);
+
+				const uint64 Done = Iterations.fetch_add(1, std::memory_order_relaxed) + 1;
+				if ((MaxIterations > 0 && Done >= MaxIterations)
+					|| (StopFlag && StopFlag->load(std::memory_order_relaxed)))
+				{
+					bStop = true;
+				}
+				else if ((Done & (LimitCheckInterval - 1)) == 0 && Limits.MaxSeconds > 0.0 && FPlatformTime::Seconds() - StartTime >= Limits.MaxSeconds)
+				{
+					bStop = true;
+				}
+			}
+		});
+
+	// Leave the boards as they were found
+	for (UChessBoardState* Board : Boards)
+	{
+		for (int32 i = 0; i < HiddenIds.Num(); ++i)
+		{
+			if (Board->GetPiece(HiddenIds[i])->Type != HiddenTypes[i])
+			{
+				Board->SetPieceType(HiddenIds[i], HiddenTypes[i]);
+			}
+		}
+	}
+
+	// The most visited move is the most robust choice; its average reward is only reported
+	int32 Best = INDEX_NONE;
+	for (int32 Child = Nodes[0].FirstChild.load(std::memory_order_acquire); Child != INDEX_NONE; Child = Nodes[Child].NextSibling)
+	{
+		if (Best == INDEX_NONE || Nodes[Child].Visits.load(std::memory_order_relaxed) > Nodes[Best].Visits.load(std::memory_order_relaxed))
+		{
+			Best = Child;
+		}
+	}
+	if (Best != INDEX_NONE && Nodes[Best].Visits.load(std::memory_order_relaxed) > 0)
+	{
+		const FNode& Node = Nodes[Best];
+		const float Reward = FMath::Clamp((float)Node.RewardSum.load() / (float)(RewardOne * Node.Visits.load()), 0.001f, 0.999f);
+		Result.BestMove = Node.Move;
+		Result.Score = FMath::RoundToInt(-Settings.RewardScale * FMath::LogX(10.0f, 1.0f / Reward - 1.0f));
+	}
+
+	for (const TUniquePtr<FWorker>& Worker : Workers)
+	{
+		Result.Depth = FMath::Max(Result.Depth, Worker->MaxPathLength);
+	}
+	Result.Nodes = Iterations.load();
+	Result.Seconds = FPlatformTime::Seconds() - StartTime;
+	return Result;
+}
+
+void FChessISMCTS::RunWorker(FWorker& Worker)
+{
+	while (!bStop.load(std::memory_order_relaxed))
+	{
+		RunIteration(Worker);
+		Iterations.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+void FChessISMCTS::RunIteration(FWorker& Worker)
+{
+	UChessBoardState* Board = Worker.Board;
+	if (!Determinize(Worker))
+	{
+		return;
+	}
+
+	Worker.PathLength = 0;
+	Worker.NumUndo = 0;
+	Worker.Path[Worker.PathLength++] = 0;
+
+	// Reward for the side to move in the position the descent stops at
+	float Reward = 0.5f;
+	int32 NodeIndex = 0;
+	while (true)
+	{
+		FChessCheckInfo Info;
+		FChessPackedMoveList Moves;
+		const bool bHasKing = Info.Init(Board, Board->SideToMove);
+		if (bHasKing)
+		{
+			FChessLegalMoveGenerator::GenerateAllMoves(Board, Info, Moves);
+		}
+
+		// The observer can only play what the real position allows
+		if (NodeIndex == 0)
+		{
+			for (int32 i = Moves.Num() - 1; i >= 0; --i)
+			{
+				if (!RootMoves.Contains(Moves[i]))
+				{
+					Moves.RemoveAtSwap(i);
+				}
+			}
+			if (Moves.Num() == 0)
+			{
+				// This determinization contradicts the legal moves the observer can see
+				return;
+			}
+		}
+
+		if (Moves.Num() == 0)
+		{
+			// A side without a king has lost it, not run out of moves
+			Reward = (!bHasKing || Info.IsInCheck()) ? 0.0f : 0.5f;
+			break;
+		}
+		if (Worker.PathLength > ChessSearch::MaxPly)
+		{
+			Reward = Playout(Worker);
+			break;
+		}
+
+		// Score the children this determinization allows, and note which legal moves have none yet
+		bool bHasChild[ChessMoves::MaxMoves] = {};
+		int32 NumWithChild = 0;
+		int32 Best = INDEX_NONE;
+		float BestScore = -1.0f;
+		FNode& Node = Nodes[NodeIndex];
+		for (int32 Child = Node.FirstChild.load(std::memory_order_acquire); Child != INDEX_NONE; Child = Nodes[Child].NextSibling)
+		{
+			FNode& ChildNode = Nodes[Child];
+			const int32 MoveIndex = Moves.Find(ChildNode.Move);
+			if (MoveIndex == INDEX_NONE)
+			{
+				continue;
+			}
+			bHasChild[MoveIndex] = true;
+			++NumWithChild;
+
+			const int32 Availability = ChildNode.Availability.fetch_add(1, std::memory_order_relaxed) + 1;
+			const int32 Visits = ChildNode.Visits.load(std::memory_order_relaxed) + ChildNode.VirtualLosses.load(std::memory_order_relaxed);
+			float Score = TNumericLimits<float>::Max();
+			if (Visits > 0)
+			{
+				// Virtual losses count as visits that earned nothing
+				const float Mean = (float)ChildNode.RewardSum.load(std::memory_order_relaxed) / (float)(RewardOne * Visits);
+				Score = Mean + Settings.Exploration * FMath::Sqrt(FMath::Loge((float)Availability) / (float)Visits);
+			}
+			if (Score > BestScore)
+			{
+				BestScore = Score;
+				Best = Child;
+			}
+		}
+
+		// Expand one untried move, then play out from it
+		if (NumWithChild < Moves.Num() && NumNodes.load(std::memory_order_relaxed) < Settings.MaxTreeNodes)
+		{
+			int32 Pick = Worker.Rng.RandRange(0, Moves.Num() - NumWithChild - 1);
+			int32 MoveIndex = 0;
+			while (bHasChild[MoveIndex] || Pick-- > 0)
+			{
+				++MoveIndex;
+			}
+
+			const int32 Child = FindOrAddChild(NodeIndex, Moves[MoveIndex]);
+			if (Child != INDEX_NONE)
+			{
+				Nodes[Child].Availability.fetch_add(1, std::memory_order_relaxed);
+				Nodes[Child].VirtualLosses.fetch_add(1, std::memory_order_relaxed);
+				Board->MakeMove(Moves[MoveIndex], Worker.Undo[Worker.NumUndo++]);
+				Worker.Path[Worker.PathLength++] = Child;
+				Reward = Playout(Worker);
+				break;
+			}
+		}
+
+		if (Best == INDEX_NONE)
+		{
+			Reward = Playout(Worker);
+			break;
+		}
+
+		Nodes[Best].VirtualLosses.fetch_add(1, std::memory_order_relaxed);
+		Board->MakeMove(Nodes[Best].Move, Worker.Undo[Worker.NumUndo++]);
+		Worker.Path[Worker.PathLength++] = Best;
+		NodeIndex = Best;
+	}
+
+	// Back up: each node is scored for the side that played into it, which alternates up the path
+	float Value = Reward;
+	for (int32 i = Worker.PathLength - 1; i >= 1; --i)
+	{
+		Value = 1.0f - Value;
+		FNode& Node = Nodes[Worker.Path[i]];
+		Node.RewardSum.fetch_add((int64)(Value * RewardOne), std::memory_order_relaxed);
+		Node.Visits.fetch_add(1, std::memory_order_relaxed);
+		Node.VirtualLosses.fetch_sub(1, std::memory_order_relaxed);
+	}
+	Nodes[0].Visits.fetch_add(1, std::memory_order_relaxed);
+	Worker.MaxPathLength = FMath::Max(Worker.MaxPathLength, Worker.PathLength - 1);
+
+	while (Worker.NumUndo > 0)
+	{
+		Board->UnmakeMove(Worker.Undo[--Worker.NumUndo]);
+	}
+}
+
+bool FChessISMCTS::Determinize(FWorker& Worker)
+{
+	const int32 NumHidden = HiddenIds.Num();
+	if (NumHidden == 0)
+	{
+		return true;
+	}
+
+	UChessBoardState* Board = Worker.Board;
+	const EPieceColor Opponent = (Observer == EPieceColor::White) ? EPieceColor::Black : EPieceColor::White;
+	for (int32 Attempt = 0; Attempt < MaxDeterminizeAttempts; ++Attempt)
+	{
+		EPieceType Types[UChessBoardState::MaxPieces];
+		if (Belief)
+		{
+			// Pieces the belief has no doubt about keep the type the observer already knows
+			EPieceType Drawn[FChessMaskBelief::MaxSlots];
+			Belief->Sample(Worker.Rng, Drawn);
+			for (int32 i = 0; i < NumHidden; ++i)
+			{
+				Types[i] = Belief->IsHidden(HiddenIds[i]) ? Drawn[HiddenIds[i]] : HiddenTypes[i];
+			}
+		}
+		else
+		{
+			for (int32 i = 0; i < NumHidden; ++i)
+			{
+				Types[i] = HiddenTypes[i];
+			}
+			for (int32 i = NumHidden - 1; i > 0; --i)
+			{
+				Swap(Types[i], Types[Worker.Rng.RandRange(0, i)]);
+			}
+		}
+
+		// A pawn on its promotion rank would already have promoted
+		bool bPlausible = true;
+		for (int32 i = 0; i < NumHidden && bPlausible; ++i)
+		{
+			const int32 Rank = Board->GetPieceSquare(HiddenIds[i]) / 8;
+			bPlausible = Types[i] != EPieceType::Pawn || Rank != (Observer == EPieceColor::White ? 0 : 7);
+		}
+		if (!bPlausible)
+		{
+			continue;
+		}
+
+		for (int32 i = 0; i < NumHidden; ++i)
+		{
+			if (Board->GetPiece(HiddenIds[i])->Type != Types[i])
+			{
+				Board->SetPieceType(HiddenIds[i], Types[i]);
+			}
+		}
+
+		// The observer is to move, so the opponent's one king cannot be standing in check
+		if (bOpponentHasKing)
+		{
+			const uint64 Kings = Board->GetPieceOccupancy(Opponent, EPieceType::King);
+			if (ChessBitboard::PopCount(Kings) != 1 || Board->IsSquareAttacked(ChessBitboard::Lsb(Kings), Observer))
+			{
+				continue;
+			}
+		}
+		return true;
+	}
+	return false;
+}
+
+float FChessISMCTS::Playout(FWorker& Worker)
+{
+	UChessBoardState* Board = Worker.Board;
+	const EPieceColor StartSide = Board->SideToMove;
+
+	for (int32 Ply = 0; Ply < Settings.PlayoutPlies; ++Ply)
+	{
+		FChessCheckInfo Info;
+		FChessPackedMoveList Moves;
+		const bool bHasKing = Info.Init(Board, Board->SideToMove);
+		if (bHasKing)
+		{
+			FChessLegalMoveGenerator::GenerateAllMoves(Board, Info, Moves);
+		}
+		if (Moves.Num() == 0)
+		{
+			const float Reward = (!bHasKing || Info.IsInCheck()) ? 0.0f : 0.5f;
+			return Board->SideToMove == StartSide ? Reward : 1.0f - Reward;
+		}
+
+		// Take whatever wins material outright, otherwise play anything; keeps playouts from hanging pieces at random
+		FChessPackedMove Move = Moves[Worker.Rng.RandRange(0, Moves.Num() - 1)];
+		int32 BestGain = 0;
+		for (const FChessPackedMove Candidate : Moves)
+		{
+			if (FChessMovePicker::IsTactical(Board, Candidate))
+			{
+				const int32 Gain = FChessStaticExchange::Evaluate(Board, Candidate);
+				if (Gain > BestGain)
+				{
+					BestGain = Gain;
+					Move = Candidate;
+				}
+			}
+		}
+
+		Board->MakeMove(Move, Worker.Undo[Worker.NumUndo++]);
+	}
+
+	const float Eval = (float)FChessEvaluation::Evaluate(Board);
+	const float Reward = 1.0f / (1.0f + FMath::Pow(10.0f, -Eval / Settings.RewardScale));
+	return Board->SideToMove == StartSide ? Reward : 1.0f - Reward;
+}
+
+int32 FChessISMCTS::AllocateNode(FChessPackedMove Move)
+{
+	const int32 Index = NumNodes.fetch_add(1, std::memory_order_relaxed);
+	if (Index >= Settings.MaxTreeNodes)
+	{
+		return INDEX_NONE;
+	}
+	Nodes[Index].Reset(Move);
+	return Index;
+}
+
+int32 FChessISMCTS::FindOrAddChild(int32 Parent, FChessPackedMove Move)
+{
+	FNode& Node = Nodes[Parent];
+	while (Node.bChildLock.exchange(true, std::memory_order_acquire))
+	{
+	}
+
+	// Another thread may have added the same move since the caller looked
+	int32 Child = Node.FirstChild.load(std::memory_order_relaxed);
+	while (Child != INDEX_NONE && Nodes[Child].Move != Move)
+	{
+		Child = Nodes[Child].NextSibling;
+	}
+
+	if (Child == INDEX_NONE)
+	{
+		Child = AllocateNode(Move);
+		if (Child != INDEX_NONE)
+		{
+			Nodes[Child].NextSibling = Node.FirstChild.load(std::memory_order_relaxed);
+			Node.FirstChild.store(Child, std::memory_order_release);
+		}
+	}
+
+	Node.bChildLock.store(false, std::memory_order_release);
+	return Child;
+}
@@ -0,0 +1,163 @@
+#include "AI/ChessMovePicker.h"
+#include "AI/ChessStaticExchange.h"
+#include "Logic/ChessBoardState.h"
+
+namespace
+{
+	// Score bands, highest first; each band's own scores stay well inside the gap to the next
+	constexpr int32 TableMoveScore = 1 << 30;
+	constexpr int32 TacticalScore = 1 << 24;
+	constexpr int32 KillerScore = 1 << 20;
+
+	// Captures that lose material go after every quiet move
+	constexpr int32 LosingCaptureScore = -(1 << 20);
+
+	// MVV-LVA victim weights by EPieceType; the attacker only breaks ties between equal victims
+	constexpr int32 VictimWeights[ChessBitboard::NumPieceTypes] = { 1, 3, 3, 5, 9, 0 };
+}
+
+void FChessSearchHeuristics::Clear()
+{
+	for (auto& PlyKillers : Killers)
+	{
+		PlyKillers[0] = PlyKillers[1] = FChessPackedMove();
+	}
+	FMemory::Memzero(History, sizeof(History));
+}
+
+void FChessSearchHeuristics::NewSearch()
+{
+	for (auto& PlyKillers : Killers)
+	{
+		PlyKillers[0] = PlyKillers[1] = FChessPackedMove();
+	}
+
+	// Still mostly right one move later, but should not outvote what this search learns
+	for (auto& BySide : History)
+	{
+		for (auto& ByFrom : BySide)
+		{
+			for (int32& Score : ByFrom)
+			{
+				Score /= 2;
+			}
+		}
+	}
+}
+
+void FChessSearchHeuristics::UpdateQuietCutoff(EPieceColor Side, int32 Ply, int32 Depth, FChessPackedMove Best, const FChessPackedMove* TriedQuiets, int32 NumTriedQuiets)
+{
+	if (Ply < ChessSearch::MaxPly && Killers[Ply][0] != Best)
+	{
+		Killers[Ply][1] = Killers[Ply][0];
+		Killers[Ply][0] = Best;
+	}
+
+	// Deep cutoffs say more than shallow ones. The gravity term pulls scores back toward zero as they grow,
+	// which keeps them bounded without periodic rescaling.
+	const int32 Bonus = FMath::Min(Depth * Depth, 400);
+	auto Apply = [this, Side](FChessPackedMove Move, int32 Delta)
+	{
+		int32& Score = History[(uint8)Side][Move.GetFrom()][Move.GetTo()];
+		Score += Delta - Score * FMath::Abs(Delta) / MaxHistory;
+	};
+
+	Apply(Best, Bonus);
+	for (int32 i = 0; i < NumTriedQuiets; ++i)
+	{
+		Apply(TriedQuiets[i], -Bonus);
+	}
+}
+
+FChessMovePicker::FChessMovePicker(const UChessBoardState* Board, FChessPackedMoveList& InMoves, FChessPackedMove TableMove,
+	const FChessSearchHeuristics& Heuristics, int32 Ply)
+	: Moves(InMoves)
+{
+	const FChessBitboards& Bitboards = Board->GetBitboards();
+	const EPieceColor Side = Board->SideToMove;
+	const FChessPackedMove Killer0 = Ply < ChessSearch::MaxPly ? Heuristics.Killers[Ply][0] : FChessPackedMove();
+	const FChessPackedMove Killer1 = Ply < ChessSearch::MaxPly ? Heuristics.Killers[Ply][1] : FChessPackedMove();
+
+	Scores.SetNumUninitialized(Moves.Num());
+	for (int32 i = 0; i < Moves.Num(); ++i)
+	{
+		const FChessPackedMove Move = Moves[i];
+		int32 Score = 0;
+
+		if (Move == TableMove)
+		{
+			Score = TableMoveScore;
+		}
+		else if (IsTactical(Board, Move))
+		{
+			const EPieceType Victim = Move.GetSpecialType() == ESpecialMoveType::EnPassant ? EPieceType::Pawn : Bitboards.TypeAt(Move.GetTo());
+			const EPieceType Attacker = Bitboards.TypeAt(Move.GetFrom());
+			const int32 VictimWeight = ChessBitboard::IsValidType(Victim) ? VictimWeights[(uint8)Victim] : 0;
+			const int32 AttackerWeight = ChessBitboard::IsValidType(Attacker) ? VictimWeights[(uint8)Attacker] : 0;
+			const int32 MvvLva = VictimWeight * 64 - (ChessBitboard::IsValidType(Attacker) ? (int32)Attacker : 0);
+
+			// Taking something at least as valuable never loses; only the rest needs the exchange worked out
+			const bool bLosing = Move.GetSpecialType() != ESpecialMoveType::Promotion && VictimWeight < AttackerWeight
+				&& FChessStaticExchange::Evaluate(Board, Move) < 0;
+			Score = (bLosing ? LosingCaptureScore : TacticalScore) + MvvLva;
+
+			// Only queen promotions jump the queue; underpromotions are almost never best
+			if (Move.GetSpecialType() == ESpecialMoveType::Promotion)
+			{
+				Score += Move.GetPromotionType() == EPieceType::Queen ? VictimWeights[(uint8)EPieceType::Queen] * 64 : -TacticalScore - 2 * FChessSearchHeuristics::MaxHistory;
+			}
+		}
+		else if (Move == Killer0)
+		{
+			Score = KillerScore;
+		}
+		else if (Move == Killer1)
+		{
+			Score = KillerScore - 1;
+		}
+		else
+		{
+			Score = Heuristics.GetHistory(Side, Move);
+		}
+
+		Scores[i] = Score;
+	}
+}
+
+bool FChessMovePicker::Next(FChessPackedMove& OutMove)
+{
+	if (Cursor >= Moves.Num())
+	{
+		return false;
+	}
+
+	// One pass of selection sort: bring the best remaining move to the cursor
+	int32 Best = Cursor;
+	for (int32 i = Cursor + 1; i < Moves.Num(); ++i)
+	{
+		if (Scores[i] > Scores[Best])
+		{
+			Best = i;
+		}
+	}
+	if (Best != Cursor)
+	{
+		Swap(Moves[Cursor], Moves[Best]);
+		Swap(Scores[Cursor], Scores[Best]);
+	}
+
+	OutMove = Moves[Cursor++];
+	return true;
+}
+
+bool FChessMovePicker::IsTactical(const UChessBoardState* Board, FChessPackedMove Move)
+{
+	const ESpecialMoveType Special = Move.GetSpecialType();
+	if (Special == ESpecialMoveType::Promotion || Special == ESpecialMoveType::EnPassant)
+	{
+		return true;
+	}
+
+	// Castling lands on an empty square, so an occupied target is always an enemy piece
+	return Special == ESpecialMoveType::Normal && (Board->GetOccupancy() & ChessBitboard::SquareBit(Move.GetTo())) != 0;
+}
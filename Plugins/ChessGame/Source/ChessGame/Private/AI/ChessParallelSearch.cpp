@@ -0,0 +1,60 @@
+#include "AI/ChessParallelSearch.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarChessAIThreads(
+	TEXT("Chess.AI.Threads"),
+	1,
+	TEXT("Search threads per AI move for components that do not set their own count. 1 searches on a single thread."));
+
+FChessParallelSearch::FChessParallelSearch(TArrayView<UChessBoardState* const> InBoards, FChessTranspositionTable* InTable)
+{
+	Boards.Append(InBoards.GetData(), FMath::Min(InBoards.Num(), ChessSearch::MaxThreads));
+	for (int32 i = 0; i < Boards.Num(); ++i)
+	{
+		Searches.Add(MakeUnique<FChessSearch>(InTable, i));
+	}
+}
+
+FChessSearchResult FChessParallelSearch::Search(const FChessSearchLimits& Limits, const std::atomic<bool>* StopFlag)
+{
+	if (Boards.Num() == 0)
+	{
+		return FChessSearchResult();
+	}
+
+	// Helpers have no budget of their own; they stop when the main thread is done, for whatever reason
+	std::atomic<bool> bStopHelpers{ false };
+	FChessSearchLimits HelperLimits = Limits;
+	HelperLimits.MaxSeconds = 0.0;
+	HelperLimits.MaxNodes = 0;
+
+	// Helpers poll the flag every thousand or so nodes, so the wait once the main thread returns is short
+	FChessSearchResult Result;
+	std::atomic<uint64> HelperNodes{ 0 };
+	ChessSearch::RunWithHelpers(Boards.Num(), bStopHelpers,
+		[this, &HelperLimits, &bStopHelpers, &HelperNodes](int32 Index)
+		{
+			HelperNodes += Searches[Index]->Search(Boards[Index], HelperLimits, &bStopHelpers).Nodes;
+		},
+		[this, &Limits, StopFlag, &Result]()
+		{
+			Result = Searches[0]->Search(Boards[0], Limits, StopFlag);
+		});
+
+	Result.Nodes += HelperNodes;
+	return Result;
+}
+
+void FChessParallelSearch::SetGameHistory(TArrayView<const uint64> Keys)
+{
+	for (TUniquePtr<FChessSearch>& Search : Searches)
+	{
+		Search->SetGameHistory(Keys);
+	}
+}
+
+int32 FChessParallelSearch::ResolveThreadCount(int32 Requested)
+{
+	const int32 Count = Requested > 0 ? Requested : CVarChessAIThreads.GetValueOnAnyThread();
+	return FMath::Clamp(Count, 1, FMath::Min(FPlatformMisc::NumberOfCoresIncludingHyperthreads(), ChessSearch::MaxThreads));
+}
@@ -0,0 +1,359 @@
+#include "AI/ChessSearch.h"
+#include "AI/ChessStaticExchange.h"
+#include "AI/ChessTranspositionTable.h"
+#include "Logic/ChessBoardState.h"
+#include "Logic/ChessEvaluation.h"
+#include "Logic/ChessLegalMoveGenerator.h"
+
+namespace
+{
+	// Nodes between clock reads; a power of two so the test is a mask
+	constexpr uint64 LimitCheckInterval = 1024;
+
+	// Quiet moves remembered per node for the history penalty; later ones are rarely worth demoting
+	constexpr int32 MaxTriedQuiets = 64;
+}
+
+FChessSearchResult FChessSearch::Search(UChessBoardState* InBoard, const FChessSearchLimits& InLimits, const std::atomic<bool>* InStopFlag)
+{
+	Board = InBoard;
+	Limits = InLimits;
+	StopFlag = InStopFlag;
+	StartTime = FPlatformTime::Seconds();
+	Nodes = 0;
+	bStopped = false;
+
+	FChessSearchResult Result;
+
+	FChessCheckInfo Info;
+	if (!Board || !Info.Init(Board, Board->SideToMove))
+	{
+		return Result;
+	}
+
+	FChessPackedMoveList RootMoves;
+	FChessLegalMoveGenerator::GenerateAllMoves(Board, Info, RootMoves);
+	if (RootMoves.Num() == 0)
+	{
+		return Result;
+	}
+
+	// Something legal is always ready, even if the search is stopped before depth 1 completes
+	Result.BestMove = RootMoves[0];
+	if (RootMoves.Num() == 1)
+	{
+		return Result;
+	}
+
+	PathHashes[0] = Board->GetHash();
+	Heuristics.NewSearch();
+
+	// A previous search of this position (or the opponent's, one ply earlier) may already know the best move
+	FChessTTEntry Entry;
+	if (Table && Table->Probe(PathHashes[0], 0, Entry))
+	{
+		const int32 Index = RootMoves.Find(Entry.Move);
+		if (Index != INDEX_NONE)
+		{
+			RootMoves.Swap(0, Index);
+		}
+	}
+
+	// Odd helpers run one iteration ahead of the main thread, so the threads fill the table at different depths
+	const int32 StartDepth = 1 + (ThreadIndex & 1);
+	for (int32 Depth = StartDepth; Depth <= Limits.MaxDepth; ++Depth)
+	{
+		// Polled here too so a search cancelled before it starts does not run a whole iteration first
+		CheckLimits();
+		if (bStopped)
+		{
+			break;
+		}
+
+		int32 Alpha = -ChessSearch::Infinity;
+		int32 BestIndex = 0;
+		for (int32 i = 0; i < RootMoves.Num(); ++i)
+		{
+			FMoveUndoRecord Undo;
+			Board->MakeMove(RootMoves[i], Undo);
+			const int32 Score = -AlphaBeta(Depth - 1, 1, -ChessSearch::Infinity, -Alpha);
+			Board->UnmakeMove(Undo);
+
+			if (bStopped)
+			{
+				break;
+			}
+			if (Score > Alpha)
+			{
+				Alpha = Score;
+				BestIndex = i;
+			}
+		}
+
+		// A partial iteration has not seen every reply, so only completed ones count
+		if (bStopped)
+		{
+			break;
+		}
+
+		// The best move leads the next iteration, which tightens the window for all the others
+		RootMoves.Swap(0, BestIndex);
+		Result.BestMove = RootMoves[0];
+		Result.Score = Alpha;
+		Result.Depth = Depth;
+
+		if (Table)
+		{
+			Table->Store(PathHashes[0], 0, Alpha, Depth, EChessBound::Exact, Result.BestMove);
+		}
+
+		// Iterative deepening finds the shortest mate first; searching deeper cannot improve on it
+		if (FMath::Abs(Alpha) >= ChessSearch::MateThreshold)
+		{
+			break;
+		}
+	}
+
+	Result.Nodes = Nodes;
+	Result.Seconds = FPlatformTime::Seconds() - StartTime;
+	return Result;
+}
+
+int32 FChessSearch::AlphaBeta(int32 Depth, int32 Ply, int32 Alpha, int32 Beta)
+{
+	if (Depth <= 0)
+	{
+		return Quiesce(Ply, Alpha, Beta);
+	}
+
+	if ((++Nodes & (LimitCheckInterval - 1)) == 0)
+	{
+		CheckLimits();
+	}
+	if (bStopped)
+	{
+		return 0;
+	}
+	if (Ply >= ChessSearch::MaxPly)
+	{
+		return Evaluate();
+	}
+
+	const uint64 Hash = Board->GetHash();
+	if (IsDraw(Ply, Hash))
+	{
+		return 0;
+	}
+	PathHashes[Ply] = Hash;
+
+	FChessCheckInfo Info;
+	if (!Info.Init(Board, Board->SideToMove))
+	{
+		return Evaluate();
+	}
+
+	// Checks are searched one ply deeper so forced sequences are not cut off at the horizon
+	if (Info.IsInCheck())
+	{
+		++Depth;
+	}
+
+	FChessPackedMove TableMove;
+	FChessTTEntry Entry;
+	if (Table && Table->Probe(Hash, Ply, Entry))
+	{
+		TableMove = Entry.Move;
+		if (Entry.Depth >= Depth
+			&& (Entry.Bound == EChessBound::Exact
+				|| (Entry.Bound == EChessBound::Lower && Entry.Score >= Beta)
+				|| (Entry.Bound == EChessBound::Upper && Entry.Score <= Alpha)))
+		{
+			return Entry.Score;
+		}
+	}
+
+	FChessPackedMoveList Moves;
+	FChessLegalMoveGenerator::GenerateAllMoves(Board, Info, Moves);
+	if (Moves.Num() == 0)
+	{
+		return Info.IsInCheck() ? -ChessSearch::MateScore + Ply : 0;
+	}
+
+	// The stored move is only a hint; it is tried first only if it is in the legal list, which guards against key collisions
+	FChessMovePicker Picker(Board, Moves, TableMove, Heuristics, Ply);
+
+	const int32 OriginalAlpha = Alpha;
+	FChessPackedMove BestMove;
+	FChessPackedMove TriedQuiets[MaxTriedQuiets];
+	int32 NumTriedQuiets = 0;
+	FChessPackedMove Move;
+	while (Picker.Next(Move))
+	{
+		const bool bQuiet = !FChessMovePicker::IsTactical(Board, Move);
+
+		FMoveUndoRecord Undo;
+		Board->MakeMove(Move, Undo);
+		const int32 Score = -AlphaBeta(Depth - 1, Ply + 1, -Beta, -Alpha);
+		Board->UnmakeMove(Undo);
+
+		if (bStopped)
+		{
+			return 0;
+		}
+		if (Score >= Beta)
+		{
+			if (bQuiet)
+			{
+				Heuristics.UpdateQuietCutoff(Board->SideToMove, Ply, Depth, Move, TriedQuiets, NumTriedQuiets);
+			}
+			if (Table)
+			{
+				Table->Store(Hash, Ply, Beta, Depth, EChessBound::Lower, Move);
+			}
+			return Beta;
+		}
+		if (Score > Alpha)
+		{
+			Alpha = Score;
+			BestMove = Move;
+		}
+		if (bQuiet && NumTriedQuiets < MaxTriedQuiets)
+		{
+			TriedQuiets[NumTriedQuiets++] = Move;
+		}
+	}
+
+	if (Table)
+	{
+		Table->Store(Hash, Ply, Alpha, Depth, Alpha > OriginalAlpha ? EChessBound::Exact : EChessBound::Upper, BestMove);
+	}
+	return Alpha;
+}
+
+int32 FChessSearch::Quiesce(int32 Ply, int32 Alpha, int32 Beta)
+{
+	if ((++Nodes & (LimitCheckInterval - 1)) == 0)
+	{
+		CheckLimits();
+	}
+	if (bStopped)
+	{
+		return 0;
+	}
+	if (Ply >= ChessSearch::MaxPly)
+	{
+		return Evaluate();
+	}
+
+	FChessCheckInfo Info;
+	if (!Info.Init(Board, Board->SideToMove))
+	{
+		return Evaluate();
+	}
+
+	// In check there is no standing pat: every evasion is searched, and having none is mate
+	const bool bInCheck = Info.IsInCheck();
+	FChessPackedMoveList Moves;
+	if (bInCheck)
+	{
+		FChessLegalMoveGenerator::GenerateAllMoves(Board, Info, Moves);
+		if (Moves.Num() == 0)
+		{
+			return -ChessSearch::MateScore + Ply;
+		}
+	}
+	else
+	{
+		// The side to move may decline every capture, so the static score is already a lower bound
+		const int32 StandPat = Evaluate();
+		if (StandPat >= Beta)
+		{
+			return Beta;
+		}
+		Alpha = FMath::Max(Alpha, StandPat);
+
+		FChessLegalMoveGenerator::GenerateTacticalMoves(Board, Info, Moves);
+	}
+
+	FChessMovePicker Picker(Board, Moves, FChessPackedMove(), Heuristics, Ply);
+	FChessPackedMove Move;
+	while (Picker.Next(Move))
+	{
+		if (!bInCheck)
+		{
+			// Underpromotions and exchanges that lose material cannot raise a stand-pat score
+			if (Move.GetSpecialType() == ESpecialMoveType::Promotion && Move.GetPromotionType() != EPieceType::Queen)
+			{
+				continue;
+			}
+			if (FChessStaticExchange::Evaluate(Board, Move) < 0)
+			{
+				continue;
+			}
+		}
+
+		FMoveUndoRecord Undo;
+		Board->MakeMove(Move, Undo);
+		const int32 Score = -Quiesce(Ply + 1, -Beta, -Alpha);
+		Board->UnmakeMove(Undo);
+
+		if (bStopped)
+		{
+			return 0;
+		}
+		if (Score >= Beta)
+		{
+			return Beta;
+		}
+		Alpha = FMath::Max(Alpha, Score);
+	}
+	return Alpha;
+}
+
+void FChessSearch::SetGameHistory(TArrayView<const uint64> Keys)
+{
+	// The fifty-move rule bounds how far back a repetition can reach, so older keys are never needed
+	NumGameHashes = FMath::Min(Keys.Num(), ChessSearch::MaxPly);
+	FMemory::Memcpy(GameHashes, Keys.GetData() + Keys.Num() - NumGameHashes, NumGameHashes * sizeof(uint64));
+}
+
+int32 FChessSearch::Evaluate() const
+{
+	return FChessEvaluation::Evaluate(Board);
+}
+
+bool FChessSearch::IsDraw(int32 Ply, uint64 Hash) const
+{
+	if (Board->HalfmoveClock >= 100)
+	{
+		return true;
+	}
+
+	// Only positions with the same side to move since the last irreversible move can repeat. Negative plies are
+	// the game before the root, which the halfmove clock also counts.
+	const int32 Oldest = FMath::Max(-NumGameHashes, Ply - Board->HalfmoveClock);
+	for (int32 i = Ply - 2; i >= Oldest; i -= 2)
+	{
+		if ((i >= 0 ? PathHashes[i] : GameHashes[NumGameHashes + i]) == Hash)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void FChessSearch::CheckLimits()
+{
+	if (StopFlag && StopFlag->load(std::memory_order_relaxed))
+	{
+		bStopped = true;
+	}
+	else if (Limits.MaxNodes > 0 && Nodes >= Limits.MaxNodes)
+	{
+		bStopped = true;
+	}
+	else if (Limits.MaxSeconds > 0.0 && FPlatformTime::Seconds() - StartTime >= Limits.MaxSeconds)
+	{
+		bStopped = true;
+	}
+}
@@ -0,0 +1,110 @@
+#include "AI/ChessStaticExchange.h"
+#include "AI/ChessSearchTypes.h"
+#include "Logic/ChessBoardState.h"
+#include "Logic/ChessEvaluation.h"
+
+namespace
+{
+	// Exchanges are counted with the evaluation's own built-in material; kings are never exchanged so they carry none
+	const int32 (&PieceValues)[ChessBitboard::NumPieceTypes] = FChessEvalParams::DefaultMaterial;
+}
+
+int32 FChessStaticExchange::Evaluate(const UChessBoardState* Board, FChessPackedMove Move)
+{
+	const FChessBitboards& Bitboards = Board->GetBitboards();
+	const int32 From = Move.GetFrom();
+	const int32 To = Move.GetTo();
+	const ESpecialMoveType Special = Move.GetSpecialType();
+	if (Special == ESpecialMoveType::Castling)
+	{
+		return 0;
+	}
+
+	const EPieceType Mover = Bitboards.TypeAt(From);
+	if (!ChessBitboard::IsValidType(Mover))
+	{
+		return 0;
+	}
+
+	uint64 Occupied = Board->GetOccupancy() ^ ChessBitboard::SquareBit(From);
+	int32 Gain[32];
+
+	if (Special == ESpecialMoveType::EnPassant)
+	{
+		// The captured pawn stands beside the mover, not on the target square
+		Occupied ^= ChessBitboard::SquareBit((From & ~7) | (To & 7));
+		Gain[0] = PieceValues[(uint8)EPieceType::Pawn];
+	}
+	else
+	{
+		const EPieceType Victim = Bitboards.TypeAt(To);
+		Gain[0] = ChessBitboard::IsValidType(Victim) ? PieceValues[(uint8)Victim] : 0;
+	}
+
+	// Value of whatever now stands on the target square, i.e. what the next recapture wins
+	int32 OnSquare = PieceValues[(uint8)Mover];
+	if (Special == ESpecialMoveType::Promotion)
+	{
+		OnSquare = PieceValues[(uint8)Move.GetPromotionType()];
+		Gain[0] += OnSquare - PieceValues[(uint8)EPieceType::Pawn];
+	}
+
+	const bool bMoverIsWhite = (Bitboards.ByColor[(uint8)EPieceColor::White] & ChessBitboard::SquareBit(From)) != 0;
+	EPieceColor Side = bMoverIsWhite ? EPieceColor::Black : EPieceColor::White;
+	uint64 Attackers = Board->GetAttackersTo(To, Occupied) & Occupied;
+
+	int32 Depth = 0;
+	while (Depth < 31)
+	{
+		const uint64 SideAttackers = Attackers & Bitboards.ByColor[(uint8)Side];
+		if (!SideAttackers)
+		{
+			break;
+		}
+
+		// Least valuable attacker recaptures
+		EPieceType Type = EPieceType::Pawn;
+		uint64 Candidates = 0;
+		for (int32 T = 0; T < ChessBitboard::NumPieceTypes; ++T)
+		{
+			Candidates = SideAttackers & Bitboards.ByType[T];
+			if (Candidates)
+			{
+				Type = (EPieceType)T;
+				break;
+			}
+		}
+
+		const EPieceColor Other = (Side == EPieceColor::White) ? EPieceColor::Black : EPieceColor::White;
+		const uint64 Remaining = Occupied ^ ChessBitboard::SquareBit(ChessBitboard::Lsb(Candidates));
+
+		// A king may only recapture if nothing can take it back
+		if (Type == EPieceType::King && (Board->GetAttackersTo(To, Remaining) & Remaining & Bitboards.ByColor[(uint8)Other]))
+		{
+			break;
+		}
+
+		++Depth;
+		Gain[Depth] = OnSquare - Gain[Depth - 1];
+
+		// This recapture leaves its side behind even if nothing answers it, so it is never played
+		if (FMath::Max(-Gain[Depth - 1], Gain[Depth]) < 0)
+		{
+			--Depth;
+			break;
+		}
+
+		OnSquare = PieceValues[(uint8)Type];
+		Occupied = Remaining;
+		Attackers = Board->GetAttackersTo(To, Occupied) & Occupied;
+		Side = Other;
+	}
+
+	// Fold back: each side takes the better of stopping or continuing
+	while (Depth > 0)
+	{
+		Gain[Depth - 1] = -FMath::Max(-Gain[Depth - 1], Gain[Depth]);
+		--Depth;
+	}
+	return Gain[0];
+}
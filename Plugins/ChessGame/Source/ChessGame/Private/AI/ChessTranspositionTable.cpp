@@ -0,0 +1,194 @@
+#include "AI/ChessTranspositionTable.h"
+#include "AI/ChessSearchTypes.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarChessHashBudgetMB(
+	TEXT("Chess.AI.HashBudgetMB"),
+	256,
+	TEXT("Total memory in MB that all chess AI transposition tables in this process may use together. Applies to tables sized after the change."));
+
+namespace
+{
+	// Bytes held by every live table, checked against the process budget
+	std::atomic<int64> GAllocatedBytes{ 0 };
+
+	// Tables never shrink below this, so an exhausted budget degrades strength rather than disabling the table
+	constexpr int64 MinTableBytes = 1 << 20;
+
+	// Data word layout: move 0-15, score 16-31, depth 32-39, bound 40-41, generation 42-47.
+	// The bound is never None for a stored entry, so a zero data word marks an empty slot.
+	FORCEINLINE uint64 PackData(FChessPackedMove Move, int32 Score, int32 Depth, EChessBound Bound, uint8 Generation)
+	{
+		return (uint64)Move.Data
+			| ((uint64)(uint16)(int16)Score << 16)
+			| ((uint64)(uint8)FMath::Clamp(Depth, 0, 255) << 32)
+			| ((uint64)Bound << 40)
+			| ((uint64)Generation << 42);
+	}
+
+	FORCEINLINE int32 UnpackDepth(uint64 Data) { return (int32)((Data >> 32) & 0xFF); }
+	FORCEINLINE EChessBound UnpackBound(uint64 Data) { return (EChessBound)((Data >> 40) & 3); }
+	FORCEINLINE uint8 UnpackGeneration(uint64 Data) { return (uint8)((Data >> 42) & 63); }
+
+	// Mates are stored as distance from this node so a transposition at another ply reads back the right distance
+	FORCEINLINE int32 ScoreToTT(int32 Score, int32 Ply)
+	{
+		return Score >= ChessSearch::MateThreshold ? Score + Ply : (Score <= -ChessSearch::MateThreshold ? Score - Ply : Score);
+	}
+
+	FORCEINLINE int32 ScoreFromTT(int32 Score, int32 Ply)
+	{
+		return Score >= ChessSearch::MateThreshold ? Score - Ply : (Score <= -ChessSearch::MateThreshold ? Score + Ply : Score);
+	}
+}
+
+FChessTranspositionTable::~FChessTranspositionTable()
+{
+	Free();
+}
+
+void FChessTranspositionTable::Resize(int32 SizeMB)
+{
+	Free();
+
+	const int64 Budget = (int64)FMath::Max(CVarChessHashBudgetMB.GetValueOnAnyThread(), 0) << 20;
+	const int64 Requested = (int64)FMath::Max(SizeMB, 0) << 20;
+
+	// Claim the allowance first so concurrent resizes cannot both take the last of the budget
+	int64 Allowed = MinTableBytes;
+	int64 Allocated = GAllocatedBytes.load();
+	do
+	{
+		Allowed = FMath::Max(FMath::Min(Requested, Budget - Allocated), MinTableBytes);
+	}
+	while (!GAllocatedBytes.compare_exchange_weak(Allocated, Allocated + Allowed));
+
+	// Power-of-two bucket count so the index is a mask of the key
+	NumBuckets = 1;
+	while (NumBuckets * 2 * sizeof(FBucket) <= (uint64)Allowed)
+	{
+		NumBuckets *= 2;
+	}
+	GAllocatedBytes -= Allowed - (int64)GetSizeBytes();
+
+	if ((int64)GetSizeBytes() < Requested)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Chess transposition table limited to %lld MB of %d MB requested by Chess.AI.HashBudgetMB"),
+			(long long)(GetSizeBytes() >> 20), SizeMB);
+	}
+
+	Buckets = (FBucket*)FMemory::Malloc(GetSizeBytes(), alignof(FBucket));
+	Clear();
+}
+
+void FChessTranspositionTable::Clear()
+{
+	if (Buckets)
+	{
+		FMemory::Memzero(Buckets, GetSizeBytes());
+	}
+	Generation.store(0, std::memory_order_relaxed);
+}
+
+void FChessTranspositionTable::Free()
+{
+	if (Buckets)
+	{
+		GAllocatedBytes -= (int64)GetSizeBytes();
+		FMemory::Free(Buckets);
+		Buckets = nullptr;
+	}
+	NumBuckets = 0;
+}
+
+bool FChessTranspositionTable::Probe(uint64 Key, int32 Ply, FChessTTEntry& OutEntry) const
+{
+	if (!Buckets)
+	{
+		return false;
+	}
+
+	const FBucket& Bucket = Buckets[Key & (NumBuckets - 1)];
+	for (const FSlot& Slot : Bucket.Slots)
+	{
+		const uint64 Data = Slot.Data.load(std::memory_order_relaxed);
+		if (Data != 0 && (Slot.KeyXorData.load(std::memory_order_relaxed) ^ Data) == Key)
+		{
+			OutEntry.Move = FChessPackedMove((uint16)Data);
+			OutEntry.Score = ScoreFromTT((int16)(uint16)(Data >> 16), Ply);
+			OutEntry.Depth = UnpackDepth(Data);
+			OutEntry.Bound = UnpackBound(Data);
+			return true;
+		}
+	}
+	return false;
+}
+
+void FChessTranspositionTable::Store(uint64 Key, int32 Ply, int32 Score, int32 Depth, EChessBound Bound, FChessPackedMove Move)
+{
+	if (!Buckets)
+	{
+		return;
+	}
+
+	FBucket& Bucket = Buckets[Key & (NumBuckets - 1)];
+	const uint8 CurrentGeneration = Generation.load(std::memory_order_relaxed);
+
+	// Prefer the slot already holding this position; otherwise evict the shallowest, oldest entry
+	FSlot* Victim = nullptr;
+	int32 VictimWorth = INT32_MAX;
+	for (FSlot& Slot : Bucket.Slots)
+	{
+		const uint64 Data = Slot.Data.load(std::memory_order_relaxed);
+		if (Data == 0)
+		{
+			Victim = &Slot;
+			break;
+		}
+
+		if ((Slot.KeyXorData.load(std::memory_order_relaxed) ^ Data) == Key)
+		{
+			// Keep a deeper result from this search unless the new one is exact
+			if (Bound != EChessBound::Exact && UnpackGeneration(Data) == CurrentGeneration && UnpackDepth(Data) > Depth + 2)
+			{
+				return;
+			}
+
+			// A fail-low has no best move; keep the one found earlier
+			if (Move.IsNull())
+			{
+				Move = FChessPackedMove((uint16)Data);
+			}
+			Victim = &Slot;
+			break;
+		}
+
+		const int32 Age = (CurrentGeneration - UnpackGeneration(Data)) & GenerationMask;
+		const int32 Worth = UnpackDepth(Data) - 8 * Age;
+		if (Worth < VictimWorth)
+		{
+			VictimWorth = Worth;
+			Victim = &Slot;
+		}
+	}
+
+	const uint64 Data = PackData(Move, ScoreToTT(Score, Ply), Depth, Bound, CurrentGeneration);
+	Victim->KeyXorData.store(Key ^ Data, std::memory_order_relaxed);
+	Victim->Data.store(Data, std::memory_order_relaxed);
+}
+
+int32 FChessTranspositionTable::GetUsagePermille() const
+{
+	const uint64 Sampled = FMath::Min<uint64>(NumBuckets, 1000 / BucketSize);
+	const uint8 CurrentGeneration = Generation.load(std::memory_order_relaxed);
+	int32 Used = 0;
+	for (uint64 i = 0; i < Sampled; ++i)
+	{
+		for (const FSlot& Slot : Buckets[i].Slots)
+		{
+			const uint64 Data = Slot.Data.load(std::memory_order_relaxed);
+			Used += (Data != 0 && UnpackGeneration(Data) == CurrentGeneration) ? 1 : 0;
+		}
+	}
+	return Sampled > 0 ? (int32)(Used * 1000 / (Sampled * BucketSize)) : 0;
+}
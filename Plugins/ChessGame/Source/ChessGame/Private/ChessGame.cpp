@@ -1,12 +1,14 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "ChessGame.h"
+#include "Logic/ChessAttackTables.h"
 
 #define LOCTEXT_NAMESPACE "FChessGameModule"
 
 void FChessGameModule::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
+	FChessAttackTables::Initialize();
 }
 
 void FChessGameModule::ShutdownModule()
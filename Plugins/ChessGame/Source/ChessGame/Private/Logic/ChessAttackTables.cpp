@@ -0,0 +1,210 @@
+#include "Logic/ChessAttackTables.h"
+
+bool FChessAttackTables::bInitialized = false;
+FChessMagic FChessAttackTables::RookMagics[64];
+FChessMagic FChessAttackTables::BishopMagics[64];
+uint64 FChessAttackTables::RookTable[0x19000];
+uint64 FChessAttackTables::BishopTable[0x1480];
+uint64 FChessAttackTables::KnightTable[64];
+uint64 FChessAttackTables::KingTable[64];
+uint64 FChessAttackTables::PawnTable[2][64];
+uint64 FChessAttackTables::BetweenTable[64][64];
+uint64 FChessAttackTables::LineTable[64][64];
+
+namespace
+{
+	const int32 RookDirections[4][2] = { {1, 0}, {-1, 0}, {0, 1}, {0, -1} };
+	const int32 BishopDirections[4][2] = { {1, 1}, {1, -1}, {-1, 1}, {-1, -1} };
+
+	/** Slow ray walk used only while building the tables. */
+	uint64 SlidingAttacks(const int32 (&Directions)[4][2], int32 Square, uint64 Occupied)
+	{
+		uint64 Attacks = 0;
+		const int32 File = Square % 8;
+		const int32 Rank = Square / 8;
+		for (const auto& Dir : Directions)
+		{
+			for (int32 f = File + Dir[0], r = Rank + Dir[1]; f >= 0 && f < 8 && r >= 0 && r < 8; f += Dir[0], r += Dir[1])
+			{
+				const uint64 Bit = ChessBitboard::SquareBit(r * 8 + f);
+				Attacks |= Bit;
+				if (Occupied & Bit)
+				{
+					break;
+				}
+			}
+		}
+		return Attacks;
+	}
+
+	uint64 StepAttacks(int32 Square, const int32 (*Offsets)[2], int32 NumOffsets)
+	{
+		uint64 Attacks = 0;
+		const int32 File = Square % 8;
+		const int32 Rank = Square / 8;
+		for (int32 i = 0; i < NumOffsets; ++i)
+		{
+			const int32 f = File + Offsets[i][0];
+			const int32 r = Rank + Offsets[i][1];
+			if (f >= 0 && f < 8 && r >= 0 && r < 8)
+			{
+				Attacks |= ChessBitboard::SquareBit(r * 8 + f);
+			}
+		}
+		return Attacks;
+	}
+
+	/** xorshift64* generator; deterministic seeds keep the magic search fast and reproducible. */
+	struct FMagicRandom
+	{
+		uint64 State;
+		explicit FMagicRandom(uint64 Seed) : State(Seed) {}
+
+		uint64 Next()
+		{
+			State ^= State >> 12;
+			State ^= State << 25;
+			State ^= State >> 27;
+			return State * 2685821657736338717ull;
+		}
+
+		uint64 Sparse()
+		{
+			return Next() & Next() & Next();
+		}
+	};
+
+	/**
+	 * Fills Magics/Table for one slider kind. Every square gets a contiguous slice of Table sized
+	 * 2^popcount(Mask); magics are searched with per-rank seeds known to converge quickly.
+	 */
+	void InitSliderMagics(FChessMagic* Magics, uint64* Table, const int32 (&Directions)[4][2])
+	{
+		static const uint64 Seeds[8] = { 728, 10316, 55013, 32803, 12281, 15100, 16645, 255 };
+
+		uint64 Occupancy[4096];
+		uint64 Reference[4096];
+		int32 Epoch[4096] = {};
+		int32 Attempt = 0;
+		int32 Size = 0;
+
+		for (int32 Square = 0; Square < 64; ++Square)
+		{
+			FChessMagic& M = Magics[Square];
+
+			// Edge squares never block anything beyond them, so they are excluded from the relevant mask
+			const uint64 Edges = ((ChessBitboard::Rank1 | ChessBitboard::Rank8) & ~ChessBitboard::RankMask(Square / 8))
+				| ((ChessBitboard::FileA | ChessBitboard::FileH) & ~ChessBitboard::FileMask(Square % 8));
+
+			M.Mask = SlidingAttacks(Directions, Square, 0) & ~Edges;
+			M.Shift = 64 - ChessBitboard::PopCount(M.Mask);
+			M.Attacks = Square == 0 ? Table : Magics[Square - 1].Attacks + Size;
+
+			// Carry-Rippler enumeration of every subset of the mask
+			Size = 0;
+			uint64 Subset = 0;
+			do
+			{
+				Occupancy[Size] = Subset;
+				Reference[Size] = SlidingAttacks(Directions, Square, Subset);
+#if CHESS_USE_PEXT
+				M.Attacks[_pext_u64(Subset, M.Mask)] = Reference[Size];
+#endif
+				++Size;
+				Subset = (Subset - M.Mask) & M.Mask;
+			} while (Subset);
+
+#if !CHESS_USE_PEXT
+			FMagicRandom Random(Seeds[Square / 8]);
+			for (int32 i = 0; i < Size;)
+			{
+				do
+				{
+					M.Magic = Random.Sparse();
+				} while (ChessBitboard::PopCount((M.Magic * M.Mask) >> 56) < 6);
+
+				// Verify the candidate maps every subset without destructive collisions
+				++Attempt;
+				for (i = 0; i < Size; ++i)
+				{
+					const uint32 Index = M.Index(Occupancy[i]);
+					if (Epoch[Index] < Attempt)
+					{
+						Epoch[Index] = Attempt;
+						M.Attacks[Index] = Reference[i];
+					}
+					else if (M.Attacks[Index] != Reference[i])
+					{
+						break;
+					}
+				}
+			}
+#endif
+		}
+	}
+}
+
+void FChessAttackTables::Initialize()
+{
+	if (bInitialized)
+	{
+		return;
+	}
+
+	static const int32 KnightOffsets[8][2] = { {1, 2}, {1, -2}, {-1, 2}, {-1, -2}, {2, 1}, {2, -1}, {-2, 1}, {-2, -1} };
+	static const int32 KingOffsets[8][2] = { {1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {1, -1}, {-1, 1}, {-1, -1} };
+	static const int32 WhitePawnOffsets[2][2] = { {-1, 1}, {1, 1} };
+	static const int32 BlackPawnOffsets[2][2] = { {-1, -1}, {1, -1} };
+
+	for (int32 Square = 0; Square < 64; ++Square)
+	{
+		KnightTable[Square] = StepAttacks(Square, KnightOffsets, 8);
+		KingTable[Square] = StepAttacks(Square, KingOffsets, 8);
+		PawnTable[(uint8)EPieceColor::White][Square] = StepAttacks(Square, WhitePawnOffsets, 2);
+		PawnTable[(uint8)EPieceColor::Black][Square] = StepAttacks(Square, BlackPawnOffsets, 2);
+	}
+
+	InitSliderMagics(RookMagics, RookTable, RookDirections);
+	InitSliderMagics(BishopMagics, BishopTable, BishopDirections);
+
+	for (int32 A = 0; A < 64; ++A)
+	{
+		for (int32 B = 0; B < 64; ++B)
+		{
+			BetweenTable[A][B] = 0;
+			LineTable[A][B] = 0;
+			if (A == B)
+			{
+				continue;
+			}
+
+			const uint64 BitA = ChessBitboard::SquareBit(A);
+			const uint64 BitB = ChessBitboard::SquareBit(B);
+			if (RookAttacks(A, 0) & BitB)
+			{
+				LineTable[A][B] = (RookAttacks(A, 0) & RookAttacks(B, 0)) | BitA | BitB;
+				BetweenTable[A][B] = RookAttacks(A, BitB) & RookAttacks(B, BitA);
+			}
+			else if (BishopAttacks(A, 0) & BitB)
+			{
+				LineTable[A][B] = (BishopAttacks(A, 0) & BishopAttacks(B, 0)) | BitA | BitB;
+				BetweenTable[A][B] = BishopAttacks(A, BitB) & BishopAttacks(B, BitA);
+			}
+		}
+	}
+
+	bInitialized = true;
+}
+
+uint64 FChessAttackTables::AttacksFor(EPieceType Type, int32 Square, uint64 Occupied)
+{
+	switch (Type)
+	{
+	case EPieceType::Knight: return KnightAttacks(Square);
+	case EPieceType::Bishop: return BishopAttacks(Square, Occupied);
+	case EPieceType::Rook:   return RookAttacks(Square, Occupied);
+	case EPieceType::Queen:  return QueenAttacks(Square, Occupied);
+	case EPieceType::King:   return KingAttacks(Square);
+	default:                 return 0;
+	}
+}
@@ -1,14 +1,26 @@
 #include "Logic/ChessBoardState.h"
+#include "Logic/ChessAttackTables.h"
+#include "Logic/ChessEvaluation.h"
+#include "Logic/ChessNNUE.h"
 
 UChessBoardState::UChessBoardState()
 {
+	EvalParams = &FChessEvalParams::GetDefault();
 	InitializeEmpty();
 }
 
 void UChessBoardState::InitializeEmpty()
 {
 	Squares.Init(-1, 64);
-	Pieces.Empty();
+	for (int8& Square : PieceSquares)
+	{
+		Square = -1;
+	}
+	PieceIds = 0;
+	ColorPieceIds[0] = ColorPieceIds[1] = 0;
+	Bitboards.Reset();
+	PlacementHash = 0;
+	EvalScore = 0;
 	SideToMove = EPieceColor::White;
 	bHasEnPassantTarget = false;
 	HalfmoveClock = 0;
@@ -16,8 +28,14 @@ void UChessBoardState::InitializeEmpty()
 
 	bIsGameOver = false;
 	bIsDraw = false;
+	GameEndReason = EChessGameEndReason::None;
 	bInCheck = false;
 	Winner = EPieceColor::White;
+
+	if (NNUEAccumulator)
+	{
+		NNUEAccumulator->Refresh(this);
+	}
 }
 
 int32 UChessBoardState::GetPieceIdAt(FBoardCoord Coord) const
@@ -43,43 +61,389 @@ void UChessBoardState::SetPieceIdAt(FBoardCoord Coord, int32 PieceId)
 	int32 Index = Coord.ToIndex();
 	if (Squares.IsValidIndex(Index))
 	{
+		// The previous occupant must still be in its current state so its hash and score contributions cancel out
+		const int32 PreviousId = Squares[Index];
+		if (const FPieceInstance* Previous = GetPiece(PreviousId))
+		{
+			PlacementHash ^= ChessZobrist::PieceSquareKey(*Previous, Index);
+			EvalScore -= EvalParams->PieceScore(*Previous, Index);
+			if (NNUEAccumulator)
+			{
+				NNUEAccumulator->RemovePiece(*Previous, Index);
+			}
+			if (PieceSquares[PreviousId] == Index)
+			{
+				PieceSquares[PreviousId] = -1;
+			}
+		}
+
 		Squares[Index] = PieceId;
+
+		Bitboards.ClearSquare(Index);
+		if (const FPieceInstance* Piece = GetPiece(PieceId))
+		{
+			Bitboards.AddPiece(Index, *Piece);
+			PlacementHash ^= ChessZobrist::PieceSquareKey(*Piece, Index);
+			EvalScore += EvalParams->PieceScore(*Piece, Index);
+			if (NNUEAccumulator)
+			{
+				NNUEAccumulator->AddPiece(*Piece, Index);
+			}
+			PieceSquares[PieceId] = (int8)Index;
+		}
 	}
 }
 
 void UChessBoardState::AddPiece(int32 PieceId, EPieceType Type, EPieceColor Color, FBoardCoord Coord)
 {
-	FPieceInstance NewPiece(PieceId, Type, Color);
-	Pieces.Add(PieceId, NewPiece);
+	InsertPiece(FPieceInstance(PieceId, Type, Color));
 	SetPieceIdAt(Coord, PieceId);
 }
 
 void UChessBoardState::MovePiece(int32 PieceId, FBoardCoord From, FBoardCoord To)
 {
 	SetPieceIdAt(From, -1);
-	SetPieceIdAt(To, PieceId);
 	
-	if (FPieceInstance* Piece = Pieces.Find(PieceId))
+	if (FPieceInstance* Piece = GetMutablePiece(PieceId))
 	{
 		Piece->bHasMoved = true;
 	}
+
+	SetPieceIdAt(To, PieceId);
 }
 
 void UChessBoardState::RemovePiece(int32 PieceId)
 {
-	Pieces.Remove(PieceId);
+	// Clear the square too, otherwise Squares would keep pointing at a piece that no longer exists
+	FBoardCoord Coord = FindPieceCoord(PieceId);
+	if (Coord.IsValid())
+	{
+		SetPieceIdAt(Coord, -1);
+	}
+	ErasePiece(PieceId);
 }
 
 const FPieceInstance* UChessBoardState::GetPiece(int32 PieceId) const
 {
-	return Pieces.Find(PieceId);
+	return HasPiece(PieceId) ? &PieceTable[PieceId] : nullptr;
+}
+
+bool UChessBoardState::FindPiece(int32 PieceId, FPieceInstance& OutPiece) const
+{
+	if (const FPieceInstance* Piece = GetPiece(PieceId))
+	{
+		OutPiece = *Piece;
+		return true;
+	}
+	return false;
+}
+
+TArray<FPieceInstance> UChessBoardState::GetAllPieces() const
+{
+	TArray<FPieceInstance> Result;
+	Result.Reserve(GetNumPieces());
+	for (uint64 Ids = PieceIds; Ids; )
+	{
+		Result.Add(PieceTable[ChessBitboard::PopLsb(Ids)]);
+	}
+	return Result;
+}
+
+void UChessBoardState::InsertPiece(const FPieceInstance& Piece)
+{
+	if (!ensureMsgf(Piece.PieceId >= 0 && Piece.PieceId < MaxPieces, TEXT("PieceId %d outside the piece table"), Piece.PieceId))
+	{
+		return;
+	}
+	// Re-adding a live id replaces its entry
+	ErasePiece(Piece.PieceId);
+
+	const uint64 Bit = 1ull << Piece.PieceId;
+	PieceTable[Piece.PieceId] = Piece;
+	PieceSquares[Piece.PieceId] = -1;
+	PieceIds |= Bit;
+	ColorPieceIds[(uint8)Piece.Color] |= Bit;
+}
+
+void UChessBoardState::ErasePiece(int32 PieceId)
+{
+	if (HasPiece(PieceId))
+	{
+		const uint64 Bit = 1ull << PieceId;
+		PieceIds &= ~Bit;
+		ColorPieceIds[0] &= ~Bit;
+		ColorPieceIds[1] &= ~Bit;
+		PieceSquares[PieceId] = -1;
+	}
+}
+
+namespace
+{
+	/** Rook squares for a castling move, keyed on the king's destination file like UChessGameModel always did. */
+	bool GetCastlingRookSquares(const FChessMove& Move, FBoardCoord& OutRookFrom, FBoardCoord& OutRookTo)
+	{
+		const int32 Rank = Move.From.Rank;
+		if (Move.To.File == 6) // King Side
+		{
+			OutRookFrom = FBoardCoord(7, Rank);
+			OutRookTo = FBoardCoord(5, Rank);
+			return true;
+		}
+		if (Move.To.File == 2) // Queen Side
+		{
+			OutRookFrom = FBoardCoord(0, Rank);
+			OutRookTo = FBoardCoord(3, Rank);
+			return true;
+		}
+		return false;
+	}
+}
+
+void UChessBoardState::MakeMove(const FChessMove& Move, FMoveUndoRecord& OutUndo)
+{
+	OutUndo.Move = Move;
+	OutUndo.bPreviousHasEnPassantTarget = bHasEnPassantTarget;
+	OutUndo.PreviousEnPassantTarget = EnPassantTarget;
+	OutUndo.PreviousHalfmoveClock = HalfmoveClock;
+	OutUndo.CastlingRookId = -1;
+	OutUndo.CapturedPieceId = -1;
+	OutUndo.CapturedPieceCoord = FBoardCoord();
+
+	// Capture first (en passant takes the pawn beside the target square)
+	if (Move.CapturedPieceId != -1)
+	{
+		if (const FPieceInstance* Captured = GetPiece(Move.CapturedPieceId))
+		{
+			OutUndo.CapturedPieceId = Move.CapturedPieceId;
+			OutUndo.CapturedPiece = *Captured;
+			OutUndo.CapturedPieceCoord = (Move.SpecialType == ESpecialMoveType::EnPassant) ? FBoardCoord(Move.To.File, Move.From.Rank) : Move.To;
+			if (GetPieceIdAt(OutUndo.CapturedPieceCoord) == Move.CapturedPieceId)
+			{
+				SetPieceIdAt(OutUndo.CapturedPieceCoord, -1);
+			}
+			ErasePiece(Move.CapturedPieceId);
+		}
+	}
+
+	// Lift the piece before changing it so bitboards and hash remove exactly what they added
+	SetPieceIdAt(Move.From, -1);
+
+	FPieceInstance* Piece = GetMutablePiece(Move.MovingPieceId);
+	check(Piece);
+	OutUndo.bPreviousHasMoved = Piece->bHasMoved;
+	OutUndo.PreviousType = Piece->Type;
+
+	Piece->bHasMoved = true;
+	if (Move.SpecialType == ESpecialMoveType::Promotion)
+	{
+		Piece->Type = Move.PromotionType;
+	}
+	const bool bPawnMove = (OutUndo.PreviousType == EPieceType::Pawn);
+	const EPieceColor MovingColor = Piece->Color;
+
+	SetPieceIdAt(Move.To, Move.MovingPieceId);
+
+	FBoardCoord RookFrom, RookTo;
+	if (Move.SpecialType == ESpecialMoveType::Castling && GetCastlingRookSquares(Move, RookFrom, RookTo))
+	{
+		const int32 RookId = GetPieceIdAt(RookFrom);
+		if (FPieceInstance* Rook = GetMutablePiece(RookId))
+		{
+			OutUndo.CastlingRookId = RookId;
+			OutUndo.bPreviousRookHasMoved = Rook->bHasMoved;
+			SetPieceIdAt(RookFrom, -1);
+			Rook->bHasMoved = true;
+			SetPieceIdAt(RookTo, RookId);
+		}
+	}
+
+	// En passant target only follows a real pawn's double step
+	bHasEnPassantTarget = false;
+	if (bPawnMove && FMath::Abs(Move.To.Rank - Move.From.Rank) == 2)
+	{
+		bHasEnPassantTarget = true;
+		EnPassantTarget = FBoardCoord(Move.From.File, (Move.From.Rank + Move.To.Rank) / 2);
+	}
+
+	HalfmoveClock = (bPawnMove || OutUndo.CapturedPieceId != -1) ? 0 : HalfmoveClock + 1;
+	if (MovingColor == EPieceColor::Black)
+	{
+		++FullmoveNumber;
+	}
+	SideToMove = (MovingColor == EPieceColor::White) ? EPieceColor::Black : EPieceColor::White;
+}
+
+void UChessBoardState::UnmakeMove(const FMoveUndoRecord& Undo)
+{
+	const FChessMove& Move = Undo.Move;
+
+	// Undo in reverse order: rook, mover, then the captured piece
+	FBoardCoord RookFrom, RookTo;
+	if (Undo.CastlingRookId != -1 && GetCastlingRookSquares(Move, RookFrom, RookTo))
+	{
+		SetPieceIdAt(RookTo, -1);
+		if (FPieceInstance* Rook = GetMutablePiece(Undo.CastlingRookId))
+		{
+			Rook->bHasMoved = Undo.bPreviousRookHasMoved;
+		}
+		SetPieceIdAt(RookFrom, Undo.CastlingRookId);
+	}
+
+	SetPieceIdAt(Move.To, -1);
+
+	FPieceInstance* Piece = GetMutablePiece(Move.MovingPieceId);
+	check(Piece);
+	Piece->Type = Undo.PreviousType;
+	Piece->bHasMoved = Undo.bPreviousHasMoved;
+	const EPieceColor MovingColor = Piece->Color;
+
+	SetPieceIdAt(Move.From, Move.MovingPieceId);
+
+	if (Undo.CapturedPieceId != -1)
+	{
+		InsertPiece(Undo.CapturedPiece);
+		SetPieceIdAt(Undo.CapturedPieceCoord, Undo.CapturedPieceId);
+	}
+
+	bHasEnPassantTarget = Undo.bPreviousHasEnPassantTarget;
+	EnPassantTarget = Undo.PreviousEnPassantTarget;
+	HalfmoveClock = Undo.PreviousHalfmoveClock;
+	if (MovingColor == EPieceColor::Black)
+	{
+		--FullmoveNumber;
+	}
+	SideToMove = MovingColor;
+}
+
+void UChessBoardState::SetPieceType(int32 PieceId, EPieceType NewType)
+{
+	if (FPieceInstance* Piece = GetMutablePiece(PieceId))
+	{
+		FBoardCoord Coord = FindPieceCoord(PieceId);
+		SetPieceIdAt(Coord, -1);
+		Piece->Type = NewType;
+		SetPieceIdAt(Coord, PieceId);
+	}
+}
+
+void UChessBoardState::SetPieceMask(int32 PieceId, EPieceType NewMask)
+{
+	if (FPieceInstance* Piece = GetMutablePiece(PieceId))
+	{
+		FBoardCoord Coord = FindPieceCoord(PieceId);
+		SetPieceIdAt(Coord, -1);
+		Piece->MaskType = NewMask;
+		SetPieceIdAt(Coord, PieceId);
+	}
+}
+
+FBoardCoord UChessBoardState::FindPieceCoord(int32 PieceId) const
+{
+	const int32 Square = GetPieceSquare(PieceId);
+	return Square >= 0 ? FBoardCoord::FromIndex(Square) : FBoardCoord();
+}
+
+uint64 UChessBoardState::GetAttackersTo(int32 Square, uint64 Occupied) const
+{
+	// Reverse lookups: a piece attacks Square iff the same piece type standing on Square would attack it back
+	// (pawns use the opposite colour's pattern).
+	const uint64 Pawns = Bitboards.ByType[(uint8)EPieceType::Pawn];
+	const uint64 Queens = Bitboards.ByType[(uint8)EPieceType::Queen];
+	const uint64 RookLike = Bitboards.ByType[(uint8)EPieceType::Rook] | Queens;
+	const uint64 BishopLike = Bitboards.ByType[(uint8)EPieceType::Bishop] | Queens;
+
+	return (FChessAttackTables::PawnAttacks(EPieceColor::Black, Square) & Pawns & Bitboards.ByColor[(uint8)EPieceColor::White])
+		| (FChessAttackTables::PawnAttacks(EPieceColor::White, Square) & Pawns & Bitboards.ByColor[(uint8)EPieceColor::Black])
+		| (FChessAttackTables::KnightAttacks(Square) & Bitboards.ByType[(uint8)EPieceType::Knight])
+		| (FChessAttackTables::KingAttacks(Square) & Bitboards.ByType[(uint8)EPieceType::King])
+		| (FChessAttackTables::RookAttacks(Square, Occupied) & RookLike)
+		| (FChessAttackTables::BishopAttacks(Square, Occupied) & BishopLike);
+}
+
+bool UChessBoardState::IsSquareAttacked(int32 Square, EPieceColor ByColor, uint64 Occupied) const
+{
+	const uint64 Them = Bitboards.ByColor[(uint8)ByColor];
+	const EPieceColor Defender = (ByColor == EPieceColor::White) ? EPieceColor::Black : EPieceColor::White;
+
+	// Cheapest tests first; sliders last since they need two table lookups
+	if (FChessAttackTables::PawnAttacks(Defender, Square) & Them & Bitboards.ByType[(uint8)EPieceType::Pawn]) return true;
+	if (FChessAttackTables::KnightAttacks(Square) & Them & Bitboards.ByType[(uint8)EPieceType::Knight]) return true;
+	if (FChessAttackTables::KingAttacks(Square) & Them & Bitboards.ByType[(uint8)EPieceType::King]) return true;
+
+	const uint64 Queens = Them & Bitboards.ByType[(uint8)EPieceType::Queen];
+	const uint64 RookLike = (Them & Bitboards.ByType[(uint8)EPieceType::Rook]) | Queens;
+	if (RookLike && (FChessAttackTables::RookAttacks(Square, Occupied) & RookLike)) return true;
+
+	const uint64 BishopLike = (Them & Bitboards.ByType[(uint8)EPieceType::Bishop]) | Queens;
+	return BishopLike && (FChessAttackTables::BishopAttacks(Square, Occupied) & BishopLike);
+}
+
+uint64 UChessBoardState::GetHash() const
+{
+	uint64 Hash = PlacementHash;
+	if (SideToMove == EPieceColor::Black)
+	{
+		Hash ^= ChessZobrist::Keys.BlackToMove;
+	}
+
+	// The en passant file only distinguishes positions when a pawn can actually make the capture
+	if (bHasEnPassantTarget && EnPassantTarget.IsValid())
+	{
+		const EPieceColor Opponent = (SideToMove == EPieceColor::White) ? EPieceColor::Black : EPieceColor::White;
+		if (FChessAttackTables::PawnAttacks(Opponent, EnPassantTarget.ToIndex()) & Bitboards.Pieces(SideToMove, EPieceType::Pawn))
+		{
+			Hash ^= ChessZobrist::Keys.EnPassant[EnPassantTarget.File];
+		}
+	}
+	return Hash;
+}
+
+void UChessBoardState::RebuildDerivedState()
+{
+	Bitboards.Reset();
+	PlacementHash = 0;
+	EvalScore = 0;
+	for (int8& Square : PieceSquares)
+	{
+		Square = -1;
+	}
+	for (int32 i = 0; i < Squares.Num(); ++i)
+	{
+		if (const FPieceInstance* Piece = GetPiece(Squares[i]))
+		{
+			Bitboards.AddPiece(i, *Piece);
+			PlacementHash ^= ChessZobrist::PieceSquareKey(*Piece, i);
+			EvalScore += EvalParams->PieceScore(*Piece, i);
+			PieceSquares[Squares[i]] = (int8)i;
+		}
+	}
+
+	if (NNUEAccumulator)
+	{
+		NNUEAccumulator->Refresh(this);
+	}
+}
+
+void UChessBoardState::SetEvalParams(const FChessEvalParams* Params)
+{
+	EvalParams = Params ? Params : &FChessEvalParams::GetDefault();
+	EvalScore = FChessEvaluation::ComputeBoardScore(this, *EvalParams);
+}
+
+void UChessBoardState::SetNNUEAccumulator(FChessNNUEAccumulator* Accumulator)
+{
+	NNUEAccumulator = Accumulator;
+	if (NNUEAccumulator)
+	{
+		NNUEAccumulator->Refresh(this);
+	}
 }
 
 FChessBoardStateData UChessBoardState::ToStruct() const
 {
 	FChessBoardStateData Data;
 	Data.Squares = Squares;
-	Pieces.GenerateValueArray(Data.PiecesArray);
+	Data.PiecesArray = GetAllPieces();
 	Data.SideToMove = SideToMove;
 	Data.bHasEnPassantTarget = bHasEnPassantTarget;
 	Data.EnPassantTarget = EnPassantTarget;
@@ -88,6 +452,7 @@ FChessBoardStateData UChessBoardState::ToStruct() const
 	
 	Data.bIsGameOver = bIsGameOver;
 	Data.bIsDraw = bIsDraw;
+	Data.GameEndReason = GameEndReason;
 	Data.Winner = Winner;
 	Data.bInCheck = bInCheck;
 
@@ -97,10 +462,11 @@ FChessBoardStateData UChessBoardState::ToStruct() const
 void UChessBoardState::FromStruct(const FChessBoardStateData& Data)
 {
 	Squares = Data.Squares;
-	Pieces.Empty();
+	PieceIds = 0;
+	ColorPieceIds[0] = ColorPieceIds[1] = 0;
 	for (const FPieceInstance& Piece : Data.PiecesArray)
 	{
-		Pieces.Add(Piece.PieceId, Piece);
+		InsertPiece(Piece);
 	}
 	SideToMove = Data.SideToMove;
 	bHasEnPassantTarget = Data.bHasEnPassantTarget;
@@ -110,7 +476,364 @@ void UChessBoardState::FromStruct(const FChessBoardStateData& Data)
 
 	bIsGameOver = Data.bIsGameOver;
 	bIsDraw = Data.bIsDraw;
+	GameEndReason = Data.GameEndReason;
 	Winner = Data.Winner;
 	bInCheck = Data.bInCheck;
+
+	RebuildDerivedState();
+}
+
+void UChessBoardState::CopyFrom(const UChessBoardState& Other)
+{
+	// Squares keeps its allocation once sized; everything else is fixed size
+	if (Squares.Num() != Other.Squares.Num())
+	{
+		Squares.SetNumUninitialized(Other.Squares.Num());
+	}
+	FMemory::Memcpy(Squares.GetData(), Other.Squares.GetData(), Squares.Num() * sizeof(int32));
+	FMemory::Memcpy(PieceTable, Other.PieceTable, sizeof(PieceTable));
+	FMemory::Memcpy(PieceSquares, Other.PieceSquares, sizeof(PieceSquares));
+	PieceIds = Other.PieceIds;
+	ColorPieceIds[0] = Other.ColorPieceIds[0];
+	ColorPieceIds[1] = Other.ColorPieceIds[1];
+	Bitboards = Other.Bitboards;
+	PlacementHash = Other.PlacementHash;
+	EvalParams = Other.EvalParams;
+	EvalScore = Other.EvalScore;
+	NNUEAccumulator = nullptr;
+
+	SideToMove = Other.SideToMove;
+	bHasEnPassantTarget = Other.bHasEnPassantTarget;
+	EnPassantTarget = Other.EnPassantTarget;
+	HalfmoveClock = Other.HalfmoveClock;
+	FullmoveNumber = Other.FullmoveNumber;
+
+	bIsGameOver = Other.bIsGameOver;
+	bIsDraw = Other.bIsDraw;
+	GameEndReason = Other.GameEndReason;
+	Winner = Other.Winner;
+	bInCheck = Other.bInCheck;
+}
+
+
+namespace
+{
+	const TCHAR FENPieceChars[] = TEXT("pnbrqk");
+
+	bool FENCharToType(TCHAR Char, EPieceType& OutType)
+	{
+		const TCHAR Lower = FChar::ToLower(Char);
+		for (int32 i = 0; i < ChessBitboard::NumPieceTypes; ++i)
+		{
+			if (FENPieceChars[i] == Lower)
+			{
+				OutType = (EPieceType)i;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	TCHAR FENTypeToChar(EPieceType Type, EPieceColor Color)
+	{
+		const TCHAR Char = ChessBitboard::IsValidType(Type) ? FENPieceChars[(uint8)Type] : '?';
+		return Color == EPieceColor::White ? FChar::ToUpper(Char) : Char;
+	}
+
+	/** Walks one placement-style field, calling Visit(Square, Char) for each letter. Returns false unless exactly 64 squares are described. */
+	template <typename VisitorType>
+	bool ParseFENBoardField(const TCHAR*& Cursor, VisitorType&& Visit)
+	{
+		int32 File = 0;
+		int32 Rank = 7;
+		for (; *Cursor && *Cursor != ' '; ++Cursor)
+		{
+			const TCHAR Char = *Cursor;
+			if (Char == '/')
+			{
+				if (File != 8 || --Rank < 0)
+				{
+					return false;
+				}
+				File = 0;
+			}
+			else if (Char >= '1' && Char <= '8')
+			{
+				File += Char - '0';
+			}
+			else if (File < 8 && Visit(Rank * 8 + File, Char))
+			{
+				++File;
+			}
+			else
+			{
+				return false;
+			}
+
+			if (File > 8)
+			{
+				return false;
+			}
+		}
+		return Rank == 0 && File == 8;
+	}
+
+	template <typename CharAtType>
+	void WriteFENBoardField(FString& Out, CharAtType&& CharAt)
+	{
+		for (int32 Rank = 7; Rank >= 0; --Rank)
+		{
+			int32 EmptyRun = 0;
+			for (int32 File = 0; File < 8; ++File)
+			{
+				const TCHAR Char = CharAt(Rank * 8 + File);
+				if (Char == 0)
+				{
+					++EmptyRun;
+					continue;
+				}
+				if (EmptyRun > 0)
+				{
+					Out.AppendChar('0' + EmptyRun);
+					EmptyRun = 0;
+				}
+				Out.AppendChar(Char);
+			}
+			if (EmptyRun > 0)
+			{
+				Out.AppendChar('0' + EmptyRun);
+			}
+			if (Rank > 0)
+			{
+				Out.AppendChar('/');
+			}
+		}
+	}
+
+	bool ParseFENNumber(const TCHAR*& Cursor, int32& OutValue)
+	{
+		if (!FChar::IsDigit(*Cursor))
+		{
+			return false;
+		}
+		OutValue = 0;
+		for (; FChar::IsDigit(*Cursor); ++Cursor)
+		{
+			OutValue = OutValue * 10 + (*Cursor - '0');
+		}
+		return true;
+	}
+
+	/** The piece the castling field talks about: the real king, or failing that the piece wearing the king mask. */
+	int32 FindCastlingKingSquare(const UChessBoardState* Board, EPieceColor Color)
+	{
+		const uint64 Own = Board->GetColorOccupancy(Color);
+		const uint64 Candidates = Board->GetPieceOccupancy(Color, EPieceType::King) ? Board->GetPieceOccupancy(Color, EPieceType::King) : (Board->GetMaskOccupancy(EPieceType::King) & Own);
+		return Candidates ? ChessBitboard::Lsb(Candidates) : -1;
+	}
+
+	/** Corner rook of Color on the castling king's rank, or nullptr. */
+	const FPieceInstance* FindCastlingRook(const UChessBoardState* Board, int32 KingSquare, EPieceColor Color, bool bKingside)
+	{
+		const FPieceInstance* Rook = Board->GetPiece(Board->Squares[(KingSquare / 8) * 8 + (bKingside ? 7 : 0)]);
+		return (Rook && Rook->Type == EPieceType::Rook && Rook->Color == Color) ? Rook : nullptr;
+	}
+}
+
+bool UChessBoardState::LoadFromFEN(const FString& FEN)
+{
+	InitializeEmpty();
+
+	const TCHAR* Cursor = *FEN;
+	auto SkipSpaces = [&Cursor]() { while (*Cursor == ' ') ++Cursor; };
+	auto Fail = [this]() { InitializeEmpty(); return false; };
+
+	// 1. Placement. Pieces are collected first so ids follow square order from a1 like the other setup paths.
+	TCHAR Placement[64] = {};
+	SkipSpaces();
+	const bool bPlacementValid = ParseFENBoardField(Cursor, [&Placement](int32 Square, TCHAR Char)
+	{
+		EPieceType Type;
+		Placement[Square] = Char;
+		return FENCharToType(Char, Type);
+	});
+	if (!bPlacementValid)
+	{
+		return Fail();
+	}
+
+	int32 NextId = 0;
+	for (int32 Square = 0; Square < 64; ++Square)
+	{
+		EPieceType Type;
+		if (Placement[Square] && FENCharToType(Placement[Square], Type))
+		{
+			const EPieceColor Color = FChar::IsUpper(Placement[Square]) ? EPieceColor::White : EPieceColor::Black;
+			AddPiece(NextId++, Type, Color, FBoardCoord::FromIndex(Square));
+
+			// Only pawns on their start rank keep bHasMoved clear; castling rights are restored below
+			const int32 PawnStartRank = (Color == EPieceColor::White) ? 1 : 6;
+			GetMutablePiece(NextId - 1)->bHasMoved = !(Type == EPieceType::Pawn && Square / 8 == PawnStartRank);
+		}
+	}
+
+	// 2. Side to move
+	SkipSpaces();
+	if (*Cursor != 'w' && *Cursor != 'b')
+	{
+		return Fail();
+	}
+	SideToMove = (*Cursor++ == 'w') ? EPieceColor::White : EPieceColor::Black;
+
+	// 3. Castling (needs the masks from field 7 to find a masked king, so it is applied after those)
+	SkipSpaces();
+	const TCHAR* CastlingField = Cursor;
+	while (*Cursor && *Cursor != ' ')
+	{
+		const TCHAR Char = *Cursor++;
+		if (Char != '-' && FChar::ToLower(Char) != 'k' && FChar::ToLower(Char) != 'q')
+		{
+			return Fail();
+		}
+	}
+	const TCHAR* CastlingFieldEnd = Cursor;
+
+	// 4. En passant
+	SkipSpaces();
+	if (*Cursor == '-')
+	{
+		++Cursor;
+	}
+	else if (Cursor[0] >= 'a' && Cursor[0] <= 'h' && Cursor[1] >= '1' && Cursor[1] <= '8')
+	{
+		bHasEnPassantTarget = true;
+		EnPassantTarget = FBoardCoord(Cursor[0] - 'a', Cursor[1] - '1');
+		Cursor += 2;
+	}
+	else
+	{
+		return Fail();
+	}
+
+	// 5-6. Clocks, optional as in most EPD sources
+	SkipSpaces();
+	if (*Cursor && !ParseFENNumber(Cursor, HalfmoveClock))
+	{
+		return Fail();
+	}
+	SkipSpaces();
+	if (*Cursor && !ParseFENNumber(Cursor, FullmoveNumber))
+	{
+		return Fail();
+	}
+
+	// 7. Mask extension
+	SkipSpaces();
+	if (*Cursor == '-')
+	{
+		++Cursor;
+	}
+	else if (*Cursor)
+	{
+		const bool bMasksValid = ParseFENBoardField(Cursor, [this](int32 Square, TCHAR Char)
+		{
+			EPieceType MaskType;
+			FPieceInstance* Piece = GetMutablePiece(Squares[Square]);
+			if (!Piece || !FENCharToType(Char, MaskType))
+			{
+				return false;
+			}
+			Piece->MaskType = MaskType;
+			return true;
+		});
+		if (!bMasksValid)
+		{
+			return Fail();
+		}
+	}
+
+	// Masks and flags were written directly, so bring bitboards and hash in line before using them
+	RebuildDerivedState();
+
+	for (const TCHAR* Char = CastlingField; Char != CastlingFieldEnd; ++Char)
+	{
+		if (*Char == '-')
+		{
+			continue;
+		}
+		const EPieceColor Color = FChar::IsUpper(*Char) ? EPieceColor::White : EPieceColor::Black;
+		const int32 KingSquare = FindCastlingKingSquare(this, Color);
+		const FPieceInstance* Rook = KingSquare >= 0 ? FindCastlingRook(this, KingSquare, Color, FChar::ToLower(*Char) == 'k') : nullptr;
+		if (Rook)
+		{
+			GetMutablePiece(Squares[KingSquare])->bHasMoved = false;
+			GetMutablePiece(Rook->PieceId)->bHasMoved = false;
+		}
+	}
+
+	RebuildDerivedState();
+	return true;
 }
 
+FString UChessBoardState::ToFEN() const
+{
+	FString Result;
+	Result.Reserve(96);
+
+	WriteFENBoardField(Result, [this](int32 Square) -> TCHAR
+	{
+		const FPieceInstance* Piece = GetPiece(Squares[Square]);
+		return Piece ? FENTypeToChar(Piece->Type, Piece->Color) : 0;
+	});
+
+	Result.AppendChar(' ');
+	Result.AppendChar(SideToMove == EPieceColor::White ? 'w' : 'b');
+	Result.AppendChar(' ');
+
+	bool bAnyCastling = false;
+	for (EPieceColor Color : { EPieceColor::White, EPieceColor::Black })
+	{
+		const int32 KingSquare = FindCastlingKingSquare(this, Color);
+		const FPieceInstance* King = KingSquare >= 0 ? GetPiece(Squares[KingSquare]) : nullptr;
+		if (!King || King->bHasMoved)
+		{
+			continue;
+		}
+		for (bool bKingside : { true, false })
+		{
+			const FPieceInstance* Rook = FindCastlingRook(this, KingSquare, Color, bKingside);
+			if (Rook && !Rook->bHasMoved)
+			{
+				Result.AppendChar(FENTypeToChar(bKingside ? EPieceType::King : EPieceType::Queen, Color));
+				bAnyCastling = true;
+			}
+		}
+	}
+	if (!bAnyCastling)
+	{
+		Result.AppendChar('-');
+	}
+
+	if (bHasEnPassantTarget && EnPassantTarget.IsValid())
+	{
+		Result.Appendf(TEXT(" %c%d"), (TCHAR)('a' + EnPassantTarget.File), EnPassantTarget.Rank + 1);
+	}
+	else
+	{
+		Result += TEXT(" -");
+	}
+
+	Result.Appendf(TEXT(" %d %d"), HalfmoveClock, FullmoveNumber);
+
+	if (Bitboards.ByMask[0] | Bitboards.ByMask[1] | Bitboards.ByMask[2] | Bitboards.ByMask[3] | Bitboards.ByMask[4] | Bitboards.ByMask[5])
+	{
+		Result.AppendChar(' ');
+		WriteFENBoardField(Result, [this](int32 Square) -> TCHAR
+		{
+			const FPieceInstance* Piece = GetPiece(Squares[Square]);
+			return (Piece && ChessBitboard::IsValidType(Piece->MaskType)) ? FENTypeToChar(Piece->MaskType, Piece->Color) : 0;
+		});
+	}
+
+	return Result;
+}
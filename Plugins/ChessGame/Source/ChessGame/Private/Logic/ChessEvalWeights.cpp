@@ -0,0 +1,34 @@
+#include "Logic/ChessEvalWeights.h"
+#include "Logic/ChessEvaluation.h"
+
+void UChessEvalWeights::BuildParams(FChessEvalParams& OutParams) const
+{
+	int32 Material[ChessBitboard::NumPieceTypes];
+	int32 SquareBonus[ChessBitboard::NumPieceTypes][64];
+	FMemory::Memcpy(Material, FChessEvalParams::DefaultMaterial, sizeof(Material));
+	FMemory::Memcpy(SquareBonus, FChessEvalParams::DefaultSquareBonus, sizeof(SquareBonus));
+
+	for (const TPair<EPieceType, FChessPieceEvalWeights>& Entry : Pieces)
+	{
+		if (!ChessBitboard::IsValidType(Entry.Key))
+		{
+			continue;
+		}
+		const int32 Type = (uint8)Entry.Key;
+		Material[Type] = Entry.Value.Material;
+
+		if (Entry.Value.SquareBonus.Num() == 64)
+		{
+			FMemory::Memcpy(SquareBonus[Type], Entry.Value.SquareBonus.GetData(), sizeof(SquareBonus[Type]));
+		}
+		else if (Entry.Value.SquareBonus.Num() != 0)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("ChessEvalWeights: %s square table for piece type %d has %d entries instead of 64; using the built-in table"),
+				*GetName(), Type, Entry.Value.SquareBonus.Num());
+		}
+	}
+
+	OutParams.Build(Material, SquareBonus, MaskFlatBonus, MaskGapPercent);
+	OutParams.BishopPairBonus = BishopPairBonus;
+	OutParams.TempoBonus = TempoBonus;
+}
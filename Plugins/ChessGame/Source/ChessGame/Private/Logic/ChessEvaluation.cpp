@@ -0,0 +1,150 @@
+#include "Logic/ChessEvaluation.h"
+#include "Logic/ChessBoardState.h"
+#include "Logic/ChessNNUE.h"
+
+const int32 FChessEvalParams::DefaultMaterial[ChessBitboard::NumPieceTypes] = { 100, 320, 330, 500, 900, 0 };
+
+// Classic simplified tables. Kings use the middlegame table; there is no phase blending.
+const int32 FChessEvalParams::DefaultSquareBonus[ChessBitboard::NumPieceTypes][64] =
+{
+	// Pawn
+	{
+		  0,   0,   0,   0,   0,   0,   0,   0,
+		 50,  50,  50,  50,  50,  50,  50,  50,
+		 10,  10,  20,  30,  30,  20,  10,  10,
+		  5,   5,  10,  25,  25,  10,   5,   5,
+		  0,   0,   0,  20,  20,   0,   0,   0,
+		  5,  -5, -10,   0,   0, -10,  -5,   5,
+		  5,  10,  10, -20, -20,  10,  10,   5,
+		  0,   0,   0,   0,   0,   0,   0,   0,
+	},
+	// Knight
+	{
+		-50, -40, -30, -30, -30, -30, -40, -50,
+		-40, -20,   0,   0,   0,   0, -20, -40,
+		-30,   0,  10,  15,  15,  10,   0, -30,
+		-30,   5,  15,  20,  20,  15,   5, -30,
+		-30,   0,  15,  20,  20,  15,   0, -30,
+		-30,   5,  10,  15,  15,  10,   5, -30,
+		-40, -20,   0,   5,   5,   0, -20, -40,
+		-50, -40, -30, -30, -30, -30, -40, -50,
+	},
+	// Bishop
+	{
+		-20, -10, -10, -10, -10, -10, -10, -20,
+		-10,   0,   0,   0,   0,   0,   0, -10,
+		-10,   0,   5,  10,  10,   5,   0, -10,
+		-10,   5,   5,  10,  10,   5,   5, -10,
+		-10,   0,  10,  10,  10,  10,   0, -10,
+		-10,  10,  10,  10,  10,  10,  10, -10,
+		-10,   5,   0,   0,   0,   0,   5, -10,
+		-20, -10, -10, -10, -10, -10, -10, -20,
+	},
+	// Rook
+	{
+		  0,   0,   0,   0,   0,   0,   0,   0,
+		  5,  10,  10,  10,  10,  10,  10,   5,
+		 -5,   0,   0,   0,   0,   0,   0,  -5,
+		 -5,   0,   0,   0,   0,   0,   0,  -5,
+		 -5,   0,   0,   0,   0,   0,   0,  -5,
+		 -5,   0,   0,   0,   0,   0,   0,  -5,
+		 -5,   0,   0,   0,   0,   0,   0,  -5,
+		  0,   0,   0,   5,   5,   0,   0,   0,
+	},
+	// Queen
+	{
+		-20, -10, -10,  -5,  -5, -10, -10, -20,
+		-10,   0,   0,   0,   0,   0,   0, -10,
+		-10,   0,   5,   5,   5,   5,   0, -10,
+		 -5,   0,   5,   5,   5,   5,   0,  -5,
+		  0,   0,   5,   5,   5,   5,   0,  -5,
+		-10,   5,   5,   5,   5,   5,   0, -10,
+		-10,   0,   5,   0,   0,   0,   0, -10,
+		-20, -10, -10,  -5,  -5, -10, -10, -20,
+	},
+	// King
+	{
+		-30, -40, -40, -50, -50, -40, -40, -30,
+		-30, -40, -40, -50, -50, -40, -40, -30,
+		-30, -40, -40, -50, -50, -40, -40, -30,
+		-30, -40, -40, -50, -50, -40, -40, -30,
+		-20, -30, -30, -40, -40, -30, -30, -20,
+		-10, -20, -20, -20, -20, -20, -20, -10,
+		 20,  20,   0,   0,   0,   0,  20,  20,
+		 20,  30,  10,   0,   0,  10,  30,  20,
+	},
+};
+
+void FChessEvalParams::Build(const int32 (&Material)[ChessBitboard::NumPieceTypes], const int32 (&SquareBonus)[ChessBitboard::NumPieceTypes][64],
+	int32 MaskFlatBonus, int32 MaskGapPercent)
+{
+	const int32 White = (uint8)EPieceColor::White;
+	const int32 Black = (uint8)EPieceColor::Black;
+
+	for (int32 Type = 0; Type < ChessBitboard::NumPieceTypes; ++Type)
+	{
+		for (int32 Square = 0; Square < 64; ++Square)
+		{
+			// Tables are written rank 8 first; Black reads White's table upside down
+			const int32 Rank = Square / 8;
+			const int32 File = Square % 8;
+			PieceSquare[White][Type][Square] = Material[Type] + SquareBonus[Type][(7 - Rank) * 8 + File];
+			PieceSquare[Black][Type][Square] = -(Material[Type] + SquareBonus[Type][Rank * 8 + File]);
+		}
+
+		// The further a mask is from the truth, the more the opponent's reading of the position is off
+		for (int32 MaskType = 0; MaskType < ChessBitboard::NumPieceTypes; ++MaskType)
+		{
+			const int32 Bonus = (MaskType == Type) ? 0 : MaskFlatBonus + FMath::Abs(Material[Type] - Material[MaskType]) * MaskGapPercent / 100;
+			Mask[White][Type][MaskType] = Bonus;
+			Mask[Black][Type][MaskType] = -Bonus;
+		}
+	}
+}
+
+const FChessEvalParams& FChessEvalParams::GetDefault()
+{
+	static const FChessEvalParams Default = []()
+	{
+		FChessEvalParams Params;
+		Params.Build(DefaultMaterial, DefaultSquareBonus, DefaultMaskFlatBonus, DefaultMaskGapPercent);
+		Params.BishopPairBonus = DefaultBishopPairBonus;
+		Params.TempoBonus = DefaultTempoBonus;
+		return Params;
+	}();
+	return Default;
+}
+
+int32 FChessEvaluation::Evaluate(const UChessBoardState* Board)
+{
+	if (const FChessNNUEAccumulator* Accumulator = Board->GetNNUEAccumulator())
+	{
+		return Accumulator->GetNetwork().Evaluate(*Accumulator, Board->SideToMove);
+	}
+
+	const FChessEvalParams& Params = Board->GetEvalParams();
+	int32 Score = Board->GetEvalScore();
+
+	const uint64 Bishops = Board->GetTypeOccupancy(EPieceType::Bishop);
+	const int32 WhiteBishops = ChessBitboard::PopCount(Bishops & Board->GetColorOccupancy(EPieceColor::White));
+	const int32 BlackBishops = ChessBitboard::PopCount(Bishops & Board->GetColorOccupancy(EPieceColor::Black));
+	Score += ((WhiteBishops >= 2) - (BlackBishops >= 2)) * Params.BishopPairBonus;
+
+	return (Board->SideToMove == EPieceColor::White ? Score : -Score) + Params.TempoBonus;
+}
+
+int32 FChessEvaluation::ComputeBoardScore(const UChessBoardState* Board, const FChessEvalParams& Params)
+{
+	int32 Score = 0;
+	uint64 Ids = Board->GetPieceIds();
+	while (Ids)
+	{
+		const int32 PieceId = ChessBitboard::PopLsb(Ids);
+		const int32 Square = Board->GetPieceSquare(PieceId);
+		if (Square >= 0)
+		{
+			Score += Params.PieceScore(*Board->GetPiece(PieceId), Square);
+		}
+	}
+	return Score;
+}
@@ -9,7 +9,12 @@ void UChessGameModel::InitializeGame()
 	BoardState = NewObject<UChessBoardState>(this);
 	RuleSet = NewObject<UChessRuleSet>(this);
 	RuleSet->Initialize(this);
-	RuleSet->SetupInitialBoardState(BoardState, InitMode);
+	RuleSet->SetupInitialBoardState(BoardState, InitMode, InitFEN);
+	PositionHistory.Reset(BoardState->GetHash());
+	MoveLog.Reset();
+	LegalMoveCache.Invalidate();
+	MaskBeliefs[(uint8)EPieceColor::White].Reset(BoardState, EPieceColor::White);
+	MaskBeliefs[(uint8)EPieceColor::Black].Reset(BoardState, EPieceColor::Black);
 
 	OnTurnChanged.Broadcast(BoardState->SideToMove);
 }
@@ -18,7 +23,17 @@ void UChessGameModel::GetLegalMovesForPiece(int32 PieceId, TArray<FChessMove>& O
 {
 	if (BoardState && RuleSet)
 	{
-		RuleSet->GenerateLegalMoves(BoardState, PieceId, OutMoves);
+		// Only the side to move is cached; the other side's moves are rarely asked for
+		const FPieceInstance* Piece = BoardState->GetPiece(PieceId);
+		if (Piece && Piece->Color == BoardState->SideToMove)
+		{
+			const TArrayView<const FChessMove> Moves = GetLegalMoveCache().GetMovesFrom(BoardState->GetPieceSquare(PieceId));
+			OutMoves.Append(Moves.GetData(), Moves.Num());
+		}
+		else
+		{
+			RuleSet->GenerateLegalMoves(BoardState, PieceId, OutMoves);
+		}
 	}
 }
 
@@ -36,25 +51,19 @@ void UChessGameModel::GetLegalMovesForCoord(FBoardCoord Coord, TArray<FChessMove
 
 bool UChessGameModel::TryApplyMove(FChessMove Move)
 {
-	if (!BoardState || !RuleSet) return false;
+	if (!BoardState || !RuleSet || BoardState->bIsGameOver) return false;
 
 	// Validate ownership
 	int32 MovingPieceId = BoardState->GetPieceIdAt(Move.From);
 	if (MovingPieceId == -1 || MovingPieceId != Move.MovingPieceId) return false;
 
-	const FPieceInstance* Piece = BoardState->Pieces.Find(MovingPieceId);
+	const FPieceInstance* Piece = BoardState->GetPiece(MovingPieceId);
 	if (!Piece || Piece->Color != BoardState->SideToMove) return false;
 
-	// Validate legality
-	// We can either regenerate moves or assume the UI passed a valid move from pseudo-moves
-	// But `RuleSet->IsMoveLegal` is protected.
-	// Best practice: Regenerate legal moves for this piece and check equality.
-	TArray<FChessMove> LegalMoves;
-	GetLegalMovesForPiece(MovingPieceId, LegalMoves);
-
+	// Validate legality against the cached legal moves of the from-square
 	bool bValid = false;
 	FChessMove ValidatedMove;
-	for (const FChessMove& Legal : LegalMoves)
+	for (const FChessMove& Legal : GetLegalMoveCache().GetMovesFrom(Move.From.ToIndex()))
 	{
 		if (Legal.From == Move.From && Legal.To == Move.To)
 		{
@@ -88,130 +97,156 @@ void UChessGameModel::ApplyMoveInternal(const FChessMove& Move)
 	// Log move
 	// UE_LOG(LogTemp, Log, TEXT("Move: %s -> %s"), *Move.From.ToString(), *Move.To.ToString());
 
-	// Update Board State
-	BoardState->SetPieceIdAt(Move.From, -1);
-	BoardState->SetPieceIdAt(Move.To, Move.MovingPieceId);
-	
-	// Update Piece State
-	if (FPieceInstance* Piece = BoardState->Pieces.Find(Move.MovingPieceId))
+	// Beliefs read the mover's mask and the squares it passed before the board changes
+	for (FChessMaskBelief& Belief : MaskBeliefs)
 	{
-		Piece->bHasMoved = true;
-		if (Move.SpecialType == ESpecialMoveType::Promotion)
-		{
-			Piece->Type = Move.PromotionType;
-		}
+		Belief.ObserveMove(BoardState, Move);
 	}
 
-	// Capture
-	if (Move.CapturedPieceId != -1)
+	// Update Board State (captures, en passant, castling rook, promotion, counters and side to move)
+	FMoveUndoRecord Undo;
+	BoardState->MakeMove(Move, Undo);
+	MoveLog.Add(FChessPackedMove::FromMove(Move));
+	LegalMoveCache.Invalidate();
+
+	if (Undo.CapturedPieceId != -1)
 	{
-		BoardState->RemovePiece(Move.CapturedPieceId);
-		OnPieceCaptured.Broadcast(Move.CapturedPieceId);
+		OnPieceCaptured.Broadcast(Undo.CapturedPieceId);
 	}
 
-	// Special Moves
-	if (Move.SpecialType == ESpecialMoveType::EnPassant)
+	// Calculate Check Status
+	bool bInCheck = RuleSet->IsKingInCheck(BoardState, BoardState->SideToMove);
+	BoardState->bInCheck = bInCheck;
+
+	// Captures and pawn moves reset the halfmove clock; no earlier position can recur after them.
+	// Recorded before the broadcasts so listeners (the AI starting its search) see the position they are told about.
+	if (BoardState->HalfmoveClock == 0)
+	{
+		PositionHistory.Reset(BoardState->GetHash());
+	}
+	else
 	{
-		FBoardCoord CapturedPawnCoord(Move.To.File, Move.From.Rank);
-		// Note: CapturedPieceId is already handled above if we set it correctly in generator
-		// Move generator sets CapturedPieceId for EnPassant too.
-		// But we need to clear the square.
-		BoardState->SetPieceIdAt(CapturedPawnCoord, -1);
+		PositionHistory.Push(BoardState->GetHash());
 	}
-	else if (Move.SpecialType == ESpecialMoveType::Castling)
+
+	// Broadcast updates
+	OnMoveApplied.Broadcast(Move);
+
+	// Settled before the turn passes, so listeners (the AI) never start on a position that has already ended
+	CheckGameEnd();
+
+	OnTurnChanged.Broadcast(BoardState->SideToMove);
+	OnCheckStatusChanged.Broadcast(bInCheck, BoardState->SideToMove); // Notify Check Status
+}
+
+bool UChessGameModel::CheckGameEnd()
+{
+	// Check Game End (Checkmate/Stalemate)
+	if (!RuleSet->HasAnyLegalMove(BoardState, BoardState->SideToMove))
 	{
-		// Move Rook
-		int32 Rank = Move.From.Rank;
-		if (Move.To.File == 6) // King Side
+		if (BoardState->bInCheck)
 		{
-			int32 RookId = BoardState->GetPieceIdAt(FBoardCoord(7, Rank));
-			if (RookId != -1)
-			{
-				BoardState->MovePiece(RookId, FBoardCoord(7, Rank), FBoardCoord(5, Rank));
-			}
+			// Checkmate
+			// Winner is opposite side (who moved last)
+			EPieceColor Winner = (BoardState->SideToMove == EPieceColor::White) ? EPieceColor::Black : EPieceColor::White;
+			EndGame(false, Winner, EChessGameEndReason::Checkmate);
 		}
-		else if (Move.To.File == 2) // Queen Side
+		else
 		{
-			int32 RookId = BoardState->GetPieceIdAt(FBoardCoord(0, Rank));
-			if (RookId != -1)
-			{
-				BoardState->MovePiece(RookId, FBoardCoord(0, Rank), FBoardCoord(3, Rank));
-			}
+			EndGame(true, EPieceColor::White, EChessGameEndReason::Stalemate);
 		}
+		return true;
 	}
 
-	// Update En Passant Target
-	BoardState->bHasEnPassantTarget = false;
-	if (FPieceInstance* Piece = BoardState->Pieces.Find(Move.MovingPieceId))
+	// Draws are applied automatically so dead games don't hold a match slot waiting for a claim
+	if (BoardState->HalfmoveClock >= 100)
 	{
-		if (Piece->Type == EPieceType::Pawn && FMath::Abs(Move.To.Rank - Move.From.Rank) == 2)
-		{
-			BoardState->bHasEnPassantTarget = true;
-			BoardState->EnPassantTarget = FBoardCoord(Move.From.File, (Move.From.Rank + Move.To.Rank) / 2);
-		}
+		EndGame(true, EPieceColor::White, EChessGameEndReason::FiftyMoveRule);
+		return true;
 	}
 
-	// Switch Turn
-	BoardState->SideToMove = (BoardState->SideToMove == EPieceColor::White) ? EPieceColor::Black : EPieceColor::White;
+	if (GetRepetitionCount() >= 3)
+	{
+		EndGame(true, EPieceColor::White, EChessGameEndReason::ThreefoldRepetition);
+		return true;
+	}
 
-	// Calculate Check Status
-	bool bInCheck = RuleSet->IsKingInCheck(BoardState, BoardState->SideToMove);
-	BoardState->bInCheck = bInCheck;
+	if (RuleSet->IsInsufficientMaterial(BoardState))
+	{
+		EndGame(true, EPieceColor::White, EChessGameEndReason::InsufficientMaterial);
+		return true;
+	}
 
-	// Broadcast updates
-	OnMoveApplied.Broadcast(Move);
-	OnTurnChanged.Broadcast(BoardState->SideToMove); // Notify Turn First
-	OnCheckStatusChanged.Broadcast(bInCheck, BoardState->SideToMove); // Notify Check Status
+	return false;
+}
 
-	// Check Game End (Checkmate/Stalemate)
-	bool bAnyLegalMove = false;
-	for (const auto& Pair : BoardState->Pieces)
+void UChessGameModel::EndGame(bool bIsDraw, EPieceColor Winner, EChessGameEndReason Reason)
+{
+	BoardState->bIsGameOver = true;
+	BoardState->bIsDraw = bIsDraw;
+	BoardState->Winner = Winner;
+	BoardState->GameEndReason = Reason;
+
+	OnGameEnded.Broadcast(bIsDraw, Winner);
+}
+
+int32 UChessGameModel::GetRepetitionCount() const
+{
+	return BoardState ? PositionHistory.GetCount(BoardState->GetHash()) : 0;
+}
+
+void UChessGameModel::GetPositionKeys(TArray<uint64>& OutKeys) const
+{
+	OutKeys.Reset(PositionHistory.GetNum());
+	for (int32 i = 0; i < PositionHistory.GetNum(); ++i)
 	{
-		if (Pair.Value.Color == BoardState->SideToMove)
+		OutKeys.Add(PositionHistory.GetKey(i));
+	}
+}
+
+void UChessGameModel::SetPieceMask(int32 PieceId, EPieceType NewMask)
+{
+	if (BoardState)
+	{
+		if (BoardState->HasPiece(PieceId))
 		{
-			TArray<FChessMove> Moves;
-			RuleSet->GenerateLegalMoves(BoardState, Pair.Key, Moves);
-			if (Moves.Num() > 0)
+			BoardState->SetPieceMask(PieceId, NewMask);
+			for (FChessMaskBelief& Belief : MaskBeliefs)
 			{
-				bAnyLegalMove = true;
-				break;
+				Belief.ObserveMaskChange(BoardState, PieceId);
 			}
+			PositionHistory.ReplaceLatest(BoardState->GetHash());
+			LegalMoveCache.Invalidate();
+			OnPieceMaskChanged.Broadcast(PieceId, NewMask);
 		}
 	}
+}
 
-	if (!bAnyLegalMove)
+void UChessGameModel::RemovePiece(int32 PieceId)
+{
+	if (BoardState && BoardState->HasPiece(PieceId))
 	{
-		if (bInCheck)
+		BoardState->RemovePiece(PieceId);
+		for (FChessMaskBelief& Belief : MaskBeliefs)
 		{
-			// Checkmate
-			// Winner is opposite side (who moved last)
-			EPieceColor Winner = (BoardState->SideToMove == EPieceColor::White) ? EPieceColor::Black : EPieceColor::White;
-			
-			BoardState->bIsGameOver = true;
-			BoardState->bIsDraw = false;
-			BoardState->Winner = Winner;
-			
-			OnGameEnded.Broadcast(false, Winner);
-		}
-		else
-		{
-			// Stalemate
-			BoardState->bIsGameOver = true;
-			BoardState->bIsDraw = true;
-			
-			OnGameEnded.Broadcast(true, EPieceColor::White); // Draw
+			Belief.ObserveRemoval(PieceId);
 		}
+
+		// Material left the board, so no earlier position can recur
+		PositionHistory.Reset(BoardState->GetHash());
+		LegalMoveCache.Invalidate();
+		OnPieceCaptured.Broadcast(PieceId);
 	}
 }
 
-void UChessGameModel::SetPieceMask(int32 PieceId, EPieceType NewMask)
+const FChessLegalMoveCache& UChessGameModel::GetLegalMoveCache()
 {
-	if (BoardState)
+	const uint64 Hash = BoardState->GetHash();
+	if (!LegalMoveCache.IsValidFor(Hash))
 	{
-		if (FPieceInstance* Piece = BoardState->Pieces.Find(PieceId))
-		{
-			Piece->MaskType = NewMask;
-			OnPieceMaskChanged.Broadcast(PieceId, NewMask);
-		}
+		FChessMoveList Moves;
+		RuleSet->GenerateAllLegalMoves(BoardState, BoardState->SideToMove, Moves);
+		LegalMoveCache.Fill(Hash, Moves.GetData(), Moves.Num());
 	}
+	return LegalMoveCache;
 }
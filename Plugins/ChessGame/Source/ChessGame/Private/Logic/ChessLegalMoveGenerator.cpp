@@ -0,0 +1,466 @@
+#include "Logic/ChessLegalMoveGenerator.h"
+#include "Logic/ChessBoardState.h"
+#include "Logic/ChessAttackTables.h"
+
+namespace
+{
+	/** Move sink for existence queries: records that a legal move was found and makes the emitter stop. */
+	struct FLegalMoveProbe
+	{
+		bool bFound = false;
+	};
+
+	/** Collects the moves of one piece, applying legality and mask deduplication as they are produced. */
+	template<typename ListType>
+	struct TPieceMoveEmitter
+	{
+		const UChessBoardState* Board;
+		const FChessCheckInfo& Info;
+		const FPieceInstance Piece; // Copy: simulated moves write the mover's flags in place
+		ListType& OutMoves;
+
+		int32 FromSquare;
+		uint64 FromBit;
+		uint64 Occupied;
+		uint64 TargetMask;
+		bool bIsKing;
+
+		// Captures and promotions only, for quiescence search
+		bool bTacticalOnly = false;
+
+		// Every target the real piece (and then the mask) produced, legal or not; mask moves never duplicate these
+		uint64 UsedTargets = 0;
+		bool bMaskPass = false;
+
+		TPieceMoveEmitter(const UChessBoardState* InBoard, const FChessCheckInfo& InInfo, const FPieceInstance& InPiece, int32 InFrom, ListType& InOutMoves)
+			: Board(InBoard), Info(InInfo), Piece(InPiece), OutMoves(InOutMoves), FromSquare(InFrom)
+		{
+			FromBit = ChessBitboard::SquareBit(FromSquare);
+			Occupied = Board->GetOccupancy();
+			bIsKing = Piece.Type == EPieceType::King;
+			TargetMask = Info.GetTargetMask(FromSquare);
+		}
+
+		FChessMove MakeMove(int32 ToSquare, ESpecialMoveType Special, EPieceType Promotion, int32 CapturedId) const
+		{
+			FChessMove Move;
+			Move.From = FBoardCoord::FromIndex(FromSquare);
+			Move.To = FBoardCoord::FromIndex(ToSquare);
+			Move.MovingPieceId = Piece.PieceId;
+			Move.CapturedPieceId = CapturedId;
+			Move.SpecialType = Special;
+			Move.PromotionType = Promotion;
+			return Move;
+		}
+
+		void Store(FChessMoveList& List, int32 ToSquare, ESpecialMoveType Special, EPieceType Promotion, int32 CapturedId) const
+		{
+			List.Add(MakeMove(ToSquare, Special, Promotion, CapturedId));
+		}
+
+		void Store(FChessPackedMoveList& List, int32 ToSquare, ESpecialMoveType Special, EPieceType Promotion, int32 CapturedId) const
+		{
+			List.Add(FChessPackedMove::Make(FromSquare, ToSquare, Special, Promotion));
+		}
+
+		void Store(FLegalMoveProbe& Probe, int32 ToSquare, ESpecialMoveType Special, EPieceType Promotion, int32 CapturedId) const
+		{
+			Probe.bFound = true;
+		}
+
+		// Lists take every move; a probe is done after the first
+		static bool IsDone(const FChessMoveList& List) { return false; }
+		static bool IsDone(const FChessPackedMoveList& List) { return false; }
+		static bool IsDone(const FLegalMoveProbe& Probe) { return Probe.bFound; }
+
+		void Emit(int32 ToSquare, ESpecialMoveType Special, EPieceType Promotion = EPieceType::None, int32 CapturedId = -1)
+		{
+			if (IsDone(OutMoves))
+			{
+				return;
+			}
+
+			const uint64 ToBit = ChessBitboard::SquareBit(ToSquare);
+			if (bMaskPass && (UsedTargets & ToBit))
+			{
+				return;
+			}
+			UsedTargets |= ToBit;
+
+			bool bLegal;
+			if (Special == ESpecialMoveType::Castling || Special == ESpecialMoveType::EnPassant)
+			{
+				bLegal = FChessLegalMoveGenerator::IsSpecialMoveLegal(Board, MakeMove(ToSquare, Special, Promotion, CapturedId));
+			}
+			else if (bIsKing)
+			{
+				// Lift the king off the board so it cannot shield its own destination from a slider
+				bLegal = !Board->IsSquareAttacked(ToSquare, Info.Them, Occupied ^ FromBit);
+			}
+			else
+			{
+				bLegal = (TargetMask & ToBit) != 0;
+			}
+
+			if (bLegal)
+			{
+				Store(OutMoves, ToSquare, Special, Promotion, CapturedId);
+			}
+		}
+
+		void EmitTargets(uint64 Targets)
+		{
+			while (Targets && !IsDone(OutMoves))
+			{
+				const int32 To = ChessBitboard::PopLsb(Targets);
+				Emit(To, ESpecialMoveType::Normal, EPieceType::None, Board->Squares[To]);
+			}
+		}
+
+		void EmitPawnAdvance(int32 ToSquare, int32 PromoteRank, int32 CapturedId)
+		{
+			if (ToSquare / 8 == PromoteRank)
+			{
+				for (EPieceType PType : ChessMoves::PromotionTypes)
+				{
+					Emit(ToSquare, ESpecialMoveType::Promotion, PType, CapturedId);
+				}
+			}
+			else
+			{
+				Emit(ToSquare, ESpecialMoveType::Normal, EPieceType::None, CapturedId);
+			}
+		}
+
+		void GeneratePawn(bool bCaptures)
+		{
+			const int32 Direction = (Piece.Color == EPieceColor::White) ? 1 : -1;
+			const int32 StartRank = (Piece.Color == EPieceColor::White) ? 1 : 6;
+			const int32 PromoteRank = (Piece.Color == EPieceColor::White) ? 7 : 0;
+			const int32 FromRank = FromSquare / 8;
+
+			const int32 Forward1Rank = FromRank + Direction;
+			if (Forward1Rank < 0 || Forward1Rank > 7)
+			{
+				return;
+			}
+
+			// Pushes (a double step is only offered off the start rank and never as part of a promotion)
+			const int32 Forward1 = FromSquare + Direction * 8;
+			if (!(Occupied & ChessBitboard::SquareBit(Forward1)) && (!bTacticalOnly || Forward1Rank == PromoteRank))
+			{
+				EmitPawnAdvance(Forward1, PromoteRank, -1);
+				if (Forward1Rank != PromoteRank && FromRank == StartRank && !bTacticalOnly)
+				{
+					const int32 Forward2 = Forward1 + Direction * 8;
+					if (!(Occupied & ChessBitboard::SquareBit(Forward2)))
+					{
+						Emit(Forward2, ESpecialMoveType::Normal);
+					}
+				}
+			}
+
+			if (!bCaptures)
+			{
+				return;
+			}
+
+			const uint64 Enemy = Board->GetColorOccupancy(Info.Them);
+			uint64 Attacks = FChessAttackTables::PawnAttacks(Piece.Color, FromSquare);
+			uint64 Captures = Attacks & Enemy;
+			while (Captures)
+			{
+				const int32 To = ChessBitboard::PopLsb(Captures);
+				EmitPawnAdvance(To, PromoteRank, Board->Squares[To]);
+			}
+
+			// En passant: the captured piece sits beside us on the target file
+			if (Board->bHasEnPassantTarget && Board->EnPassantTarget.IsValid())
+			{
+				const int32 EpSquare = Board->EnPassantTarget.ToIndex();
+				const uint64 EpBit = ChessBitboard::SquareBit(EpSquare);
+				if ((Attacks & EpBit) && !(Enemy & EpBit))
+				{
+					const int32 CapturedSquare = FromRank * 8 + (EpSquare % 8);
+					if (Enemy & ChessBitboard::SquareBit(CapturedSquare))
+					{
+						Emit(EpSquare, ESpecialMoveType::EnPassant, EPieceType::None, Board->Squares[CapturedSquare]);
+					}
+				}
+			}
+		}
+
+		void GenerateCastling()
+		{
+			if (Piece.bHasMoved)
+			{
+				return;
+			}
+
+			const int32 Rank = FromSquare / 8;
+			auto IsCastlingRook = [this, Rank](int32 File) {
+				const int32 RookId = Board->Squares[Rank * 8 + File];
+				const FPieceInstance* Rook = (RookId != -1) ? Board->GetPiece(RookId) : nullptr;
+				return Rook && Rook->Type == EPieceType::Rook && Rook->Color == Piece.Color && !Rook->bHasMoved;
+			};
+			auto AreEmpty = [this, Rank](int32 FirstFile, int32 LastFile) {
+				for (int32 File = FirstFile; File <= LastFile; ++File)
+				{
+					if (Occupied & ChessBitboard::SquareBit(Rank * 8 + File)) return false;
+				}
+				return true;
+			};
+
+			if (IsCastlingRook(7) && AreEmpty(5, 6))
+			{
+				Emit(Rank * 8 + 6, ESpecialMoveType::Castling);
+			}
+			if (IsCastlingRook(0) && AreEmpty(1, 3))
+			{
+				Emit(Rank * 8 + 2, ESpecialMoveType::Castling);
+			}
+		}
+
+		/** Generates moves as if the piece were MoveType; mask passes drop captures. */
+		void Generate(EPieceType MoveType, bool bCaptures)
+		{
+			const uint64 Allowed = bTacticalOnly ? Board->GetColorOccupancy(Info.Them) : (bCaptures ? ~Board->GetColorOccupancy(Piece.Color) : ~Occupied);
+			switch (MoveType)
+			{
+			case EPieceType::Pawn:
+				GeneratePawn(bCaptures);
+				break;
+			case EPieceType::King:
+				EmitTargets(FChessAttackTables::KingAttacks(FromSquare) & Allowed);
+				if (!bTacticalOnly)
+				{
+					GenerateCastling();
+				}
+				break;
+			case EPieceType::Knight:
+			case EPieceType::Bishop:
+			case EPieceType::Rook:
+			case EPieceType::Queen:
+				EmitTargets(FChessAttackTables::AttacksFor(MoveType, FromSquare, Occupied) & Allowed);
+				break;
+			default:
+				break;
+			}
+		}
+	};
+}
+
+bool FChessCheckInfo::Init(const UChessBoardState* Board, EPieceColor Side)
+{
+	Us = Side;
+	Them = (Side == EPieceColor::White) ? EPieceColor::Black : EPieceColor::White;
+
+	const uint64 Kings = Board->GetPieceOccupancy(Us, EPieceType::King);
+	if (!Kings || (Kings & (Kings - 1)))
+	{
+		return false;
+	}
+	KingSquare = ChessBitboard::Lsb(Kings);
+
+	const uint64 Occupied = Board->GetOccupancy();
+	const uint64 Enemy = Board->GetColorOccupancy(Them);
+	Checkers = Board->GetAttackersTo(KingSquare, Occupied) & Enemy;
+
+	CheckMask = ChessBitboard::All;
+	if (Checkers && !IsDoubleCheck())
+	{
+		const int32 CheckerSquare = ChessBitboard::Lsb(Checkers);
+		CheckMask = Checkers | FChessAttackTables::Between(KingSquare, CheckerSquare);
+	}
+
+	// Sliders that would hit the king on an empty board pin exactly one own blocker in between
+	const uint64 EnemyQueens = Board->GetPieceOccupancy(Them, EPieceType::Queen);
+	uint64 Snipers = (FChessAttackTables::RookAttacks(KingSquare, 0) & (Board->GetPieceOccupancy(Them, EPieceType::Rook) | EnemyQueens))
+		| (FChessAttackTables::BishopAttacks(KingSquare, 0) & (Board->GetPieceOccupancy(Them, EPieceType::Bishop) | EnemyQueens));
+
+	Pinned = 0;
+	while (Snipers)
+	{
+		const uint64 Blockers = FChessAttackTables::Between(KingSquare, ChessBitboard::PopLsb(Snipers)) & Occupied;
+		if (Blockers && !(Blockers & (Blockers - 1)))
+		{
+			Pinned |= Blockers & Board->GetColorOccupancy(Us);
+		}
+	}
+
+	return true;
+}
+
+uint64 FChessCheckInfo::GetTargetMask(int32 FromSquare) const
+{
+	if (IsDoubleCheck())
+	{
+		return 0;
+	}
+	uint64 Mask = CheckMask;
+	if (Pinned & ChessBitboard::SquareBit(FromSquare))
+	{
+		Mask &= FChessAttackTables::Line(KingSquare, FromSquare);
+	}
+	return Mask;
+}
+
+namespace
+{
+	template<typename ListType>
+	void GenerateSquareMovesInto(const UChessBoardState* Board, const FChessCheckInfo& Info, const FPieceInstance& Piece, int32 FromSquare, ListType& OutMoves, bool bTacticalOnly = false)
+	{
+		TPieceMoveEmitter<ListType> Emitter(Board, Info, Piece, FromSquare, OutMoves);
+		Emitter.bTacticalOnly = bTacticalOnly;
+
+		// Only the king may move out of a double check; its real moves are still filtered individually
+		if (!Emitter.bIsKing && Info.IsDoubleCheck())
+		{
+			return;
+		}
+
+		Emitter.Generate(Emitter.Piece.Type, true);
+
+		// Mask passes never capture, but a mask pawn still promotes, which tactical callers must see
+		const bool bRunMaskPass = !bTacticalOnly || Emitter.Piece.MaskType == EPieceType::Pawn;
+		if (bRunMaskPass && Emitter.Piece.MaskType != EPieceType::None && Emitter.Piece.MaskType != Emitter.Piece.Type)
+		{
+			Emitter.bMaskPass = true;
+			Emitter.Generate(Emitter.Piece.MaskType, false);
+		}
+	}
+
+	template<typename ListType>
+	void GeneratePieceMovesInto(const UChessBoardState* Board, const FChessCheckInfo& Info, int32 PieceId, ListType& OutMoves)
+	{
+		const FPieceInstance* Piece = Board->GetPiece(PieceId);
+		const int32 FromSquare = Board->GetPieceSquare(PieceId);
+		if (Piece && FromSquare >= 0)
+		{
+			GenerateSquareMovesInto(Board, Info, *Piece, FromSquare, OutMoves);
+		}
+	}
+
+	template<typename ListType>
+	void GenerateAllMovesInto(const UChessBoardState* Board, const FChessCheckInfo& Info, ListType& OutMoves, bool bTacticalOnly = false)
+	{
+		// In double check only the king can move; skip every other piece outright
+		uint64 Movers = Info.IsDoubleCheck() ? ChessBitboard::SquareBit(Info.KingSquare) : Board->GetColorOccupancy(Info.Us);
+		while (Movers)
+		{
+			const int32 FromSquare = ChessBitboard::PopLsb(Movers);
+			GenerateSquareMovesInto(Board, Info, *Board->GetPiece(Board->Squares[FromSquare]), FromSquare, OutMoves, bTacticalOnly);
+		}
+	}
+}
+
+void FChessLegalMoveGenerator::GeneratePieceMoves(const UChessBoardState* Board, const FChessCheckInfo& Info, int32 PieceId, FChessMoveList& OutMoves)
+{
+	GeneratePieceMovesInto(Board, Info, PieceId, OutMoves);
+}
+
+void FChessLegalMoveGenerator::GeneratePieceMoves(const UChessBoardState* Board, const FChessCheckInfo& Info, int32 PieceId, FChessPackedMoveList& OutMoves)
+{
+	GeneratePieceMovesInto(Board, Info, PieceId, OutMoves);
+}
+
+void FChessLegalMoveGenerator::GenerateAllMoves(const UChessBoardState* Board, const FChessCheckInfo& Info, FChessMoveList& OutMoves)
+{
+	GenerateAllMovesInto(Board, Info, OutMoves);
+}
+
+void FChessLegalMoveGenerator::GenerateAllMoves(const UChessBoardState* Board, const FChessCheckInfo& Info, FChessPackedMoveList& OutMoves)
+{
+	GenerateAllMovesInto(Board, Info, OutMoves);
+}
+
+void FChessLegalMoveGenerator::GenerateTacticalMoves(const UChessBoardState* Board, const FChessCheckInfo& Info, FChessPackedMoveList& OutMoves)
+{
+	GenerateAllMovesInto(Board, Info, OutMoves, true);
+}
+
+bool FChessLegalMoveGenerator::HasAnyLegalMove(const UChessBoardState* Board, const FChessCheckInfo& Info)
+{
+	FLegalMoveProbe Probe;
+
+	// King first: it is the only piece that can answer a double check, and its moves need no pin test
+	GenerateSquareMovesInto(Board, Info, *Board->GetPiece(Board->Squares[Info.KingSquare]), Info.KingSquare, Probe);
+	if (Probe.bFound || Info.IsDoubleCheck())
+	{
+		return Probe.bFound;
+	}
+
+	// Then unpinned pieces, which are far more likely to have a move, and the pinned ones last
+	const uint64 Own = Board->GetColorOccupancy(Info.Us) & ~ChessBitboard::SquareBit(Info.KingSquare);
+	for (uint64 Candidates : { Own & ~Info.Pinned, Own & Info.Pinned })
+	{
+		while (Candidates)
+		{
+			const int32 FromSquare = ChessBitboard::PopLsb(Candidates);
+			GenerateSquareMovesInto(Board, Info, *Board->GetPiece(Board->Squares[FromSquare]), FromSquare, Probe);
+			if (Probe.bFound)
+			{
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+bool FChessLegalMoveGenerator::IsSpecialMoveLegal(const UChessBoardState* Board, const FChessMove& Move)
+{
+	const FPieceInstance* Piece = Board->GetPiece(Move.MovingPieceId);
+	if (!Piece)
+	{
+		return false;
+	}
+	const EPieceColor Us = Piece->Color;
+	const EPieceColor Them = (Us == EPieceColor::White) ? EPieceColor::Black : EPieceColor::White;
+	const int32 From = Move.From.ToIndex();
+	const int32 To = Move.To.ToIndex();
+
+	// A real king may not castle out of or through check
+	if (Move.SpecialType == ESpecialMoveType::Castling && Piece->Type == EPieceType::King)
+	{
+		const int32 Step = (Move.To.File > Move.From.File) ? 1 : -1;
+		for (int32 File = Move.From.File; File != Move.To.File; File += Step)
+		{
+			if (Board->IsSquareAttacked(FBoardCoord(File, Move.From.Rank).ToIndex(), Them))
+			{
+				return false;
+			}
+		}
+	}
+
+	// Occupancy after the move, built the way MakeMove would change it
+	uint64 Occupied = (Board->GetOccupancy() & ~ChessBitboard::SquareBit(From)) | ChessBitboard::SquareBit(To);
+	uint64 Captured = 0;
+	if (Move.SpecialType == ESpecialMoveType::EnPassant)
+	{
+		Captured = ChessBitboard::SquareBit(Move.From.Rank * 8 + Move.To.File);
+		Occupied &= ~Captured;
+	}
+	else if (Move.CapturedPieceId != -1)
+	{
+		Captured = ChessBitboard::SquareBit(To);
+	}
+	if (Move.SpecialType == ESpecialMoveType::Castling && (Move.To.File == 6 || Move.To.File == 2))
+	{
+		const int32 RookFrom = Move.From.Rank * 8 + (Move.To.File == 6 ? 7 : 0);
+		const int32 RookTo = Move.From.Rank * 8 + (Move.To.File == 6 ? 5 : 3);
+		if (Board->Squares[RookFrom] != -1)
+		{
+			Occupied = (Occupied & ~ChessBitboard::SquareBit(RookFrom)) | ChessBitboard::SquareBit(RookTo);
+		}
+	}
+
+	const uint64 Kings = Board->GetPieceOccupancy(Us, EPieceType::King);
+	const int32 KingSquare = (Piece->Type == EPieceType::King) ? To : (Kings ? ChessBitboard::Lsb(Kings) : -1);
+	if (KingSquare < 0)
+	{
+		return true;
+	}
+
+	// A captured piece no longer attacks; everything else keeps its true type
+	return (Board->GetAttackersTo(KingSquare, Occupied) & Board->GetColorOccupancy(Them) & ~Captured) == 0;
+}
@@ -0,0 +1,383 @@
+#include "Logic/ChessMaskBelief.h"
+#include "Logic/ChessAttackTables.h"
+#include "Logic/ChessBoardState.h"
+
+namespace
+{
+	// Draws before Sample stops insisting on exact counts
+	constexpr int32 MaxSampleAttempts = 4;
+
+	FORCEINLINE uint8 TypeBit(EPieceType Type)
+	{
+		return (uint8)(1 << (uint8)Type);
+	}
+
+	FORCEINLINE int32 PromotionRank(EPieceColor Color)
+	{
+		return (Color == EPieceColor::White) ? 7 : 0;
+	}
+
+	/**
+	 * Which types could play Move from where the mover stands on Board, before the move. With bQuietOnly the
+	 * answer is for a mask pass, which never captures.
+	 */
+	uint8 TypesThatCouldPlay(const UChessBoardState* Board, EPieceColor Color, const FChessMove& Move, bool bQuietOnly)
+	{
+		const int32 From = Move.From.ToIndex();
+		const int32 To = Move.To.ToIndex();
+		const uint64 ToBit = ChessBitboard::SquareBit(To);
+		const bool bCapture = Move.CapturedPieceId != -1;
+		if (bCapture && bQuietOnly)
+		{
+			return 0;
+		}
+
+		switch (Move.SpecialType)
+		{
+		case ESpecialMoveType::Castling:
+			return TypeBit(EPieceType::King);
+		case ESpecialMoveType::EnPassant:
+			return bQuietOnly ? 0 : TypeBit(EPieceType::Pawn);
+		default:
+			break;
+		}
+
+		// Pawns, and only pawns, must promote on arrival
+		const bool bPromotion = Move.SpecialType == ESpecialMoveType::Promotion;
+		const bool bOnPromotionRank = Move.To.Rank == PromotionRank(Color);
+		uint8 Types = 0;
+		if (bPromotion == bOnPromotionRank)
+		{
+			const int32 Direction = (Color == EPieceColor::White) ? 8 : -8;
+			const int32 StartRank = (Color == EPieceColor::White) ? 1 : 6;
+			const bool bPush = !bCapture && (To == From + Direction
+				|| (Move.From.Rank == StartRank && To == From + 2 * Direction && !(Board->GetOccupancy() & ChessBitboard::SquareBit(From + Direction))));
+			const bool bPawnCapture = bCapture && (FChessAttackTables::PawnAttacks(Color, From) & ToBit);
+			if (bPush || bPawnCapture)
+			{
+				Types |= TypeBit(EPieceType::Pawn);
+			}
+		}
+		if (bPromotion)
+		{
+			return Types;
+		}
+
+		const uint64 Occupied = Board->GetOccupancy();
+		for (EPieceType Type : { EPieceType::Knight, EPieceType::Bishop, EPieceType::Rook, EPieceType::Queen, EPieceType::King })
+		{
+			if (FChessAttackTables::AttacksFor(Type, From, Occupied) & ToBit)
+			{
+				Types |= TypeBit(Type);
+			}
+		}
+		return Types;
+	}
+}
+
+void FChessMaskBelief::Reset(const UChessBoardState* Board, EPieceColor InObserver)
+{
+	Observer = InObserver;
+	NumSlots = 0;
+	FMemory::Memset(PieceSlots, 0xFF, sizeof(PieceSlots));
+	FMemory::Memzero(Counts, sizeof(Counts));
+
+	const EPieceColor Opponent = (Observer == EPieceColor::White) ? EPieceColor::Black : EPieceColor::White;
+	for (uint64 Ids = Board->GetPieceIds(Opponent); Ids; )
+	{
+		const int32 PieceId = ChessBitboard::PopLsb(Ids);
+		const FPieceInstance* Piece = Board->GetPiece(PieceId);
+		if (PieceId < MaxSlots && ChessBitboard::IsValidType(Piece->MaskType) && ChessBitboard::IsValidType(Piece->Type) && Board->GetPieceSquare(PieceId) >= 0)
+		{
+			FSlot& Slot = Slots[NumSlots];
+			Slot.PieceId = (int8)PieceId;
+			Slot.bOnBoard = true;
+			PieceSlots[PieceId] = (int8)NumSlots++;
+			++Counts[(uint8)Piece->Type];
+		}
+	}
+
+	// Anything the pool holds is possible, except a pawn already standing where it would have promoted
+	uint8 PoolTypes = 0;
+	for (int32 Type = 0; Type < ChessBitboard::NumPieceTypes; ++Type)
+	{
+		PoolTypes |= (Counts[Type] > 0) ? TypeBit((EPieceType)Type) : 0;
+	}
+	for (int32 i = 0; i < NumSlots; ++i)
+	{
+		Slots[i].Possible = PoolTypes;
+		if (Board->GetPieceSquare(Slots[i].PieceId) / 8 == PromotionRank(Opponent))
+		{
+			Restrict(i, PoolTypes & ~TypeBit(EPieceType::Pawn));
+		}
+	}
+	Propagate();
+}
+
+void FChessMaskBelief::ObserveMove(const UChessBoardState* Board, const FChessMove& Move)
+{
+	bool bChanged = false;
+
+	// Captured pieces keep their slot off the board; their type is never shown
+	const int32 CapturedSlot = GetSlot(Move.CapturedPieceId);
+	if (CapturedSlot != INDEX_NONE)
+	{
+		Slots[CapturedSlot].bOnBoard = false;
+		PieceSlots[Move.CapturedPieceId] = INDEX_NONE;
+	}
+
+	const FPieceInstance* Mover = Board->GetPiece(Move.MovingPieceId);
+	const int32 MoverSlot = GetSlot(Move.MovingPieceId);
+	if (Mover && MoverSlot != INDEX_NONE)
+	{
+		// The mask's own quiet moves are open to whatever wears it, so only moves beyond them tell anything
+		const uint8 MaskExplains = ChessBitboard::IsValidType(Mover->MaskType) ? TypesThatCouldPlay(Board, Mover->Color, Move, true) & TypeBit(Mover->MaskType) : 0;
+		if (!MaskExplains)
+		{
+			bChanged |= Restrict(MoverSlot, TypesThatCouldPlay(Board, Mover->Color, Move, false));
+		}
+
+		if (Move.SpecialType == ESpecialMoveType::Promotion)
+		{
+			// The piece becomes the announced type; whatever it was stays in the pool off the board
+			Slots[MoverSlot].bOnBoard = false;
+			PieceSlots[Move.MovingPieceId] = INDEX_NONE;
+		}
+		else if (Move.To.Rank == PromotionRank(Mover->Color))
+		{
+			bChanged |= Restrict(MoverSlot, AllTypes & ~TypeBit(EPieceType::Pawn));
+		}
+	}
+
+	// Castling only moves a real rook, whatever the king's side of it was
+	if (Move.SpecialType == ESpecialMoveType::Castling)
+	{
+		const int32 RookFile = (Move.To.File == 6) ? 7 : 0;
+		const int32 RookSlot = GetSlot(Board->GetPieceIdAt(FBoardCoord(RookFile, Move.From.Rank)));
+		if (RookSlot != INDEX_NONE)
+		{
+			bChanged |= Restrict(RookSlot, TypeBit(EPieceType::Rook));
+		}
+	}
+
+	if (bChanged || CapturedSlot != INDEX_NONE || Move.SpecialType == ESpecialMoveType::Promotion)
+	{
+		Propagate();
+	}
+}
+
+void FChessMaskBelief::ObserveMaskChange(const UChessBoardState* Board, int32 PieceId)
+{
+	// A mask put on a piece the observer has already seen hides nothing; a mask taken off shows what was under it
+	const int32 Slot = GetSlot(PieceId);
+	const FPieceInstance* Piece = Board->GetPiece(PieceId);
+	if (Slot != INDEX_NONE && Piece && !ChessBitboard::IsValidType(Piece->MaskType) && Restrict(Slot, TypeBit(Piece->Type)))
+	{
+		Propagate();
+	}
+}
+
+void FChessMaskBelief::ObserveRemoval(int32 PieceId)
+{
+	const int32 Slot = GetSlot(PieceId);
+	if (Slot != INDEX_NONE)
+	{
+		Slots[Slot].bOnBoard = false;
+		PieceSlots[PieceId] = INDEX_NONE;
+		Propagate();
+	}
+}
+
+bool FChessMaskBelief::IsHidden(int32 PieceId) const
+{
+	const int32 Slot = GetSlot(PieceId);
+	return Slot != INDEX_NONE && ChessBitboard::PopCount(Slots[Slot].Possible) > 1;
+}
+
+uint8 FChessMaskBelief::GetPossibleTypes(const UChessBoardState* Board, int32 PieceId) const
+{
+	const int32 Slot = GetSlot(PieceId);
+	if (Slot != INDEX_NONE)
+	{
+		return Slots[Slot].Possible;
+	}
+	const FPieceInstance* Piece = Board->GetPiece(PieceId);
+	return (Piece && ChessBitboard::IsValidType(Piece->Type)) ? TypeBit(Piece->Type) : 0;
+}
+
+float FChessMaskBelief::GetProbability(const UChessBoardState* Board, int32 PieceId, EPieceType Type) const
+{
+	const uint8 Possible = GetPossibleTypes(Board, PieceId);
+	if (!ChessBitboard::IsValidType(Type) || !(Possible & TypeBit(Type)))
+	{
+		return 0.0f;
+	}
+	const int32 Slot = GetSlot(PieceId);
+	if (Slot == INDEX_NONE || ChessBitboard::PopCount(Possible) == 1)
+	{
+		return 1.0f;
+	}
+
+	// Share out what the other slots have not already pinned down
+	int32 Free[ChessBitboard::NumPieceTypes];
+	for (int32 T = 0; T < ChessBitboard::NumPieceTypes; ++T)
+	{
+		Free[T] = Counts[T];
+	}
+	for (int32 i = 0; i < NumSlots; ++i)
+	{
+		if (i != Slot && ChessBitboard::PopCount(Slots[i].Possible) == 1)
+		{
+			--Free[ChessBitboard::Lsb(Slots[i].Possible)];
+		}
+	}
+
+	int32 Total = 0;
+	for (int32 T = 0; T < ChessBitboard::NumPieceTypes; ++T)
+	{
+		Total += (Possible & (1 << T)) ? FMath::Max(Free[T], 0) : 0;
+	}
+	return Total > 0 ? (float)FMath::Max(Free[(uint8)Type], 0) / (float)Total : 1.0f / (float)ChessBitboard::PopCount(Possible);
+}
+
+void FChessMaskBelief::Sample(FRandomStream& Rng, EPieceType (&OutTypes)[MaxSlots]) const
+{
+	for (int32 Attempt = 0; Attempt < MaxSampleAttempts; ++Attempt)
+	{
+		const bool bRelaxCounts = Attempt == MaxSampleAttempts - 1;
+		int32 Remaining[ChessBitboard::NumPieceTypes];
+		for (int32 T = 0; T < ChessBitboard::NumPieceTypes; ++T)
+		{
+			Remaining[T] = Counts[T];
+		}
+
+		bool bStuck = false;
+		for (int32 Order = 0; Order < NumSlots; ++Order)
+		{
+			const FSlot& Slot = Slots[SampleOrder[Order]];
+
+			// Draw one of the pool's remaining pieces among the types this slot allows
+			int32 Total = 0;
+			for (int32 T = 0; T < ChessBitboard::NumPieceTypes; ++T)
+			{
+				Total += (Slot.Possible & (1 << T)) ? Remaining[T] : 0;
+			}
+			int32 Type = INDEX_NONE;
+			if (Total > 0)
+			{
+				int32 Pick = Rng.RandRange(0, Total - 1);
+				for (Type = 0; Type < ChessBitboard::NumPieceTypes; ++Type)
+				{
+					const int32 Weight = (Slot.Possible & (1 << Type)) ? Remaining[Type] : 0;
+					if (Pick < Weight)
+					{
+						break;
+					}
+					Pick -= Weight;
+				}
+			}
+			else if (bRelaxCounts)
+			{
+				int32 Pick = Rng.RandRange(0, ChessBitboard::PopCount(Slot.Possible) - 1);
+				uint64 Bits = Slot.Possible;
+				while (Pick-- > 0)
+				{
+					ChessBitboard::PopLsb(Bits);
+				}
+				Type = ChessBitboard::Lsb(Bits);
+			}
+			else
+			{
+				bStuck = true;
+				break;
+			}
+
+			--Remaining[Type];
+			if (Slot.bOnBoard)
+			{
+				OutTypes[Slot.PieceId] = (EPieceType)Type;
+			}
+		}
+
+		if (!bStuck)
+		{
+			return;
+		}
+	}
+}
+
+bool FChessMaskBelief::Restrict(int32 Slot, uint8 Types)
+{
+	const uint8 Narrowed = Slots[Slot].Possible & Types;
+	if (Narrowed == 0 || Narrowed == Slots[Slot].Possible)
+	{
+		return false;
+	}
+	Slots[Slot].Possible = Narrowed;
+	return true;
+}
+
+void FChessMaskBelief::Propagate()
+{
+	bool bChanged = true;
+	while (bChanged)
+	{
+		bChanged = false;
+		for (int32 T = 0; T < ChessBitboard::NumPieceTypes; ++T)
+		{
+			const uint8 Bit = TypeBit((EPieceType)T);
+			int32 Determined = 0;
+			int32 Candidates = 0;
+			for (int32 i = 0; i < NumSlots; ++i)
+			{
+				Determined += Slots[i].Possible == Bit;
+				Candidates += (Slots[i].Possible & Bit) != 0;
+			}
+			if (Candidates == Determined)
+			{
+				continue;
+			}
+
+			// Every piece of this type is accounted for, so nobody else can be one
+			if (Determined >= Counts[T])
+			{
+				for (int32 i = 0; i < NumSlots; ++i)
+				{
+					if (Slots[i].Possible != Bit)
+					{
+						bChanged |= Restrict(i, (uint8)~Bit);
+					}
+				}
+			}
+			// Exactly as many candidates as pieces, so all of them are
+			else if (Candidates <= Counts[T])
+			{
+				for (int32 i = 0; i < NumSlots; ++i)
+				{
+					if (Slots[i].Possible & Bit)
+					{
+						bChanged |= Restrict(i, Bit);
+					}
+				}
+			}
+		}
+	}
+
+	// Counting sort by how many types each slot still allows
+	int32 Next = 0;
+	for (int32 Bits = 1; Bits <= ChessBitboard::NumPieceTypes; ++Bits)
+	{
+		for (int32 i = 0; i < NumSlots; ++i)
+		{
+			if (ChessBitboard::PopCount(Slots[i].Possible) == Bits)
+			{
+				SampleOrder[Next++] = (int8)i;
+			}
+		}
+	}
+}
+
+int32 FChessMaskBelief::GetSlot(int32 PieceId) const
+{
+	return (PieceId >= 0 && PieceId < MaxSlots) ? PieceSlots[PieceId] : INDEX_NONE;
+}
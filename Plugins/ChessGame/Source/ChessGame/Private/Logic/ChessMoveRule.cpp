@@ -1,12 +1,33 @@
 #include "Logic/ChessMoveRule.h"
+#include "Logic/ChessAttackTables.h"
 
-AChessMoveRule::AChessMoveRule()
+void UChessMoveRule::Generate(const UChessBoardState* Board, FBoardCoord From, const FPieceInstance& Piece, FChessMoveList& OutMoves) const
 {
-	PrimaryActorTick.bCanEverTick = false;
-	bReplicates = false; // Move rules might not need to replicate if they are just logic containers spawned on both sides
+	if (GetClass()->HasAnyClassFlags(CLASS_Native))
+	{
+		GenerateNativeMoves(Board, From, Piece, OutMoves);
+	}
+	else
+	{
+		TArray<FChessMove> Moves;
+		GenerateMoves(Board, From, Piece, Moves);
+		OutMoves.Append(Moves);
+	}
+}
+
+void UChessMoveRule::GenerateMoves_Implementation(const UChessBoardState* Board, FBoardCoord From, const FPieceInstance& Piece, TArray<FChessMove>& OutMoves) const
+{
+	FChessMoveList Moves;
+	GenerateNativeMoves(Board, From, Piece, Moves);
+	OutMoves.Append(Moves);
+}
+
+void UChessMoveRule::GenerateNativeMoves(const UChessBoardState* Board, FBoardCoord From, const FPieceInstance& Piece, FChessMoveList& OutMoves) const
+{
+	ensureMsgf(false, TEXT("%s generates no moves: native move rules must override GenerateNativeMoves"), *GetClass()->GetName());
 }
 
-void AChessMoveRule::AddMove(TArray<FChessMove>& OutMoves, FBoardCoord From, FBoardCoord To, const FPieceInstance& MovingPiece, int32 CapturedPieceId) const
+void UChessMoveRule::AddMove(FChessMoveList& OutMoves, FBoardCoord From, FBoardCoord To, const FPieceInstance& MovingPiece, int32 CapturedPieceId) const
 {
 	FChessMove Move;
 	Move.From = From;
@@ -17,100 +38,58 @@ void AChessMoveRule::AddMove(TArray<FChessMove>& OutMoves, FBoardCoord From, FBo
 	OutMoves.Add(Move);
 }
 
-bool AChessMoveRule::IsSameColor(const UChessBoardState* Board, FBoardCoord Coord, EPieceColor Color) const
+bool UChessMoveRule::IsSameColor(const UChessBoardState* Board, FBoardCoord Coord, EPieceColor Color) const
 {
-	if (!Coord.IsValid()) return false;
-	int32 PieceId = Board->GetPieceIdAt(Coord);
-	if (PieceId == -1) return false;
-	
-	const FPieceInstance* Piece = Board->Pieces.Find(PieceId);
-	return Piece && Piece->Color == Color;
+	return Board->IsSquareColor(Coord, Color);
 }
 
-bool AChessMoveRule::IsEnemy(const UChessBoardState* Board, FBoardCoord Coord, EPieceColor Color) const
+bool UChessMoveRule::IsEnemy(const UChessBoardState* Board, FBoardCoord Coord, EPieceColor Color) const
 {
-	if (!Coord.IsValid()) return false;
-	int32 PieceId = Board->GetPieceIdAt(Coord);
-	if (PieceId == -1) return false;
-
-	const FPieceInstance* Piece = Board->Pieces.Find(PieceId);
-	return Piece && Piece->Color != Color;
+	return Board->IsSquareColor(Coord, Color == EPieceColor::White ? EPieceColor::Black : EPieceColor::White);
 }
 
-bool AChessMoveRule::IsEmpty(const UChessBoardState* Board, FBoardCoord Coord) const
+bool UChessMoveRule::IsEmpty(const UChessBoardState* Board, FBoardCoord Coord) const
 {
-	if (!Coord.IsValid()) return false;
-	return Board->GetPieceIdAt(Coord) == -1;
+	return Board->IsSquareEmpty(Coord);
 }
 
 // --- Implementations (Ported from MoveGenerators) ---
 
-void AChessMoveRule_Sliding::GenerateMoves_Implementation(const UChessBoardState* Board, FBoardCoord From, const FPieceInstance& Piece, TArray<FChessMove>& OutMoves) const
+void UChessMoveRule_Sliding::GenerateNativeMoves(const UChessBoardState* Board, FBoardCoord From, const FPieceInstance& Piece, FChessMoveList& OutMoves) const
 {
-	TArray<FBoardCoord> Directions;
+	// One table lookup per slider kind; the blocker is included in the attack set, own pieces are masked out
+	const int32 FromIndex = From.ToIndex();
+	const uint64 Occupied = Board->GetOccupancy();
+
+	uint64 Targets = 0;
 	if (bOrthogonal)
 	{
-		Directions.Add(FBoardCoord(1, 0));
-		Directions.Add(FBoardCoord(-1, 0));
-		Directions.Add(FBoardCoord(0, 1));
-		Directions.Add(FBoardCoord(0, -1));
+		Targets |= FChessAttackTables::RookAttacks(FromIndex, Occupied);
 	}
 	if (bDiagonal)
 	{
-		Directions.Add(FBoardCoord(1, 1));
-		Directions.Add(FBoardCoord(1, -1));
-		Directions.Add(FBoardCoord(-1, 1));
-		Directions.Add(FBoardCoord(-1, -1));
+		Targets |= FChessAttackTables::BishopAttacks(FromIndex, Occupied);
 	}
+	Targets &= ~Board->GetColorOccupancy(Piece.Color);
 
-	for (const FBoardCoord& Dir : Directions)
+	while (Targets)
 	{
-		for (int32 i = 1; i < 8; ++i)
-		{
-			FBoardCoord Target(From.File + Dir.File * i, From.Rank + Dir.Rank * i);
-			if (!Target.IsValid()) break;
-
-			if (IsEmpty(Board, Target))
-			{
-				AddMove(OutMoves, From, Target, Piece);
-			}
-			else
-			{
-				if (IsEnemy(Board, Target, Piece.Color))
-				{
-					AddMove(OutMoves, From, Target, Piece, Board->GetPieceIdAt(Target));
-				}
-				break; // Blocked
-			}
-		}
+		const int32 TargetIndex = ChessBitboard::PopLsb(Targets);
+		AddMove(OutMoves, From, FBoardCoord::FromIndex(TargetIndex), Piece, Board->Squares[TargetIndex]);
 	}
 }
 
-void AChessMoveRule_Knight::GenerateMoves_Implementation(const UChessBoardState* Board, FBoardCoord From, const FPieceInstance& Piece, TArray<FChessMove>& OutMoves) const
+void UChessMoveRule_Knight::GenerateNativeMoves(const UChessBoardState* Board, FBoardCoord From, const FPieceInstance& Piece, FChessMoveList& OutMoves) const
 {
-	TArray<FBoardCoord> Offsets = {
-		{1, 2}, {1, -2}, {-1, 2}, {-1, -2},
-		{2, 1}, {2, -1}, {-2, 1}, {-2, -1}
-	};
-
-	for (const FBoardCoord& Offset : Offsets)
+	uint64 Targets = FChessAttackTables::KnightAttacks(From.ToIndex()) & ~Board->GetColorOccupancy(Piece.Color);
+	while (Targets)
 	{
-		FBoardCoord Target(From.File + Offset.File, From.Rank + Offset.Rank);
-		if (Target.IsValid())
-		{
-			if (IsEmpty(Board, Target))
-			{
-				AddMove(OutMoves, From, Target, Piece);
-			}
-			else if (IsEnemy(Board, Target, Piece.Color))
-			{
-				AddMove(OutMoves, From, Target, Piece, Board->GetPieceIdAt(Target));
-			}
-		}
+		const int32 TargetIndex = ChessBitboard::PopLsb(Targets);
+		AddMove(OutMoves, From, FBoardCoord::FromIndex(TargetIndex), Piece, Board->Squares[TargetIndex]);
 	}
 }
 
-void AChessMoveRule_Pawn::GenerateMoves_Implementation(const UChessBoardState* Board, FBoardCoord From, const FPieceInstance& Piece, TArray<FChessMove>& OutMoves) const
+void UChessMoveRule_Pawn::GenerateNativeMoves(const UChessBoardState* Board, FBoardCoord From, const FPieceInstance& Piece, FChessMoveList& OutMoves) const
 {
 	int32 Direction = (Piece.Color == EPieceColor::White) ? 1 : -1;
 	int32 StartRank = (Piece.Color == EPieceColor::White) ? 1 : 6;
@@ -123,8 +102,7 @@ void AChessMoveRule_Pawn::GenerateMoves_Implementation(const UChessBoardState* B
 		if (Forward1.Rank == PromoteRank)
 		{
 			// Promotion
-			TArray<EPieceType> PromoteTypes = { EPieceType::Queen, EPieceType::Rook, EPieceType::Bishop, EPieceType::Knight };
-			for (EPieceType PType : PromoteTypes)
+			for (EPieceType PType : ChessMoves::PromotionTypes)
 			{
 				FChessMove Move;
 				Move.From = From;
@@ -152,7 +130,7 @@ void AChessMoveRule_Pawn::GenerateMoves_Implementation(const UChessBoardState* B
 	}
 
 	// Captures
-	int32 CaptureFiles[] = { -1, 1 };
+	static constexpr int32 CaptureFiles[] = { -1, 1 };
 	for (int32 FileOffset : CaptureFiles)
 	{
 		FBoardCoord Target(From.File + FileOffset, From.Rank + Direction);
@@ -164,8 +142,7 @@ void AChessMoveRule_Pawn::GenerateMoves_Implementation(const UChessBoardState* B
 				if (Target.Rank == PromoteRank)
 				{
 					// Promotion Capture
-					TArray<EPieceType> PromoteTypes = { EPieceType::Queen, EPieceType::Rook, EPieceType::Bishop, EPieceType::Knight };
-					for (EPieceType PType : PromoteTypes)
+					for (EPieceType PType : ChessMoves::PromotionTypes)
 					{
 						FChessMove Move;
 						Move.From = From;
@@ -202,27 +179,14 @@ void AChessMoveRule_Pawn::GenerateMoves_Implementation(const UChessBoardState* B
 	}
 }
 
-void AChessMoveRule_King::GenerateMoves_Implementation(const UChessBoardState* Board, FBoardCoord From, const FPieceInstance& Piece, TArray<FChessMove>& OutMoves) const
+void UChessMoveRule_King::GenerateNativeMoves(const UChessBoardState* Board, FBoardCoord From, const FPieceInstance& Piece, FChessMoveList& OutMoves) const
 {
 	// Normal moves
-	for (int32 dx = -1; dx <= 1; ++dx)
+	uint64 Targets = FChessAttackTables::KingAttacks(From.ToIndex()) & ~Board->GetColorOccupancy(Piece.Color);
+	while (Targets)
 	{
-		for (int32 dy = -1; dy <= 1; ++dy)
-		{
-			if (dx == 0 && dy == 0) continue;
-			FBoardCoord Target(From.File + dx, From.Rank + dy);
-			if (Target.IsValid())
-			{
-				if (IsEmpty(Board, Target))
-				{
-					AddMove(OutMoves, From, Target, Piece);
-				}
-				else if (IsEnemy(Board, Target, Piece.Color))
-				{
-					AddMove(OutMoves, From, Target, Piece, Board->GetPieceIdAt(Target));
-				}
-			}
-		}
+		const int32 TargetIndex = ChessBitboard::PopLsb(Targets);
+		AddMove(OutMoves, From, FBoardCoord::FromIndex(TargetIndex), Piece, Board->Squares[TargetIndex]);
 	}
 
 	// Castling
@@ -234,7 +198,7 @@ void AChessMoveRule_King::GenerateMoves_Implementation(const UChessBoardState* B
 		int32 RookId = Board->GetPieceIdAt(RookCoord);
 		if (RookId != -1)
 		{
-			const FPieceInstance* Rook = Board->Pieces.Find(RookId);
+			const FPieceInstance* Rook = Board->GetPiece(RookId);
 			if (Rook && Rook->Type == EPieceType::Rook && Rook->Color == Piece.Color && !Rook->bHasMoved)
 			{
 				if (IsEmpty(Board, FBoardCoord(5, Rank)) && IsEmpty(Board, FBoardCoord(6, Rank)))
@@ -254,7 +218,7 @@ void AChessMoveRule_King::GenerateMoves_Implementation(const UChessBoardState* B
 		RookId = Board->GetPieceIdAt(RookCoord);
 		if (RookId != -1)
 		{
-			const FPieceInstance* Rook = Board->Pieces.Find(RookId);
+			const FPieceInstance* Rook = Board->GetPiece(RookId);
 			if (Rook && Rook->Type == EPieceType::Rook && Rook->Color == Piece.Color && !Rook->bHasMoved)
 			{
 				if (IsEmpty(Board, FBoardCoord(1, Rank)) && IsEmpty(Board, FBoardCoord(2, Rank)) && IsEmpty(Board, FBoardCoord(3, Rank)))
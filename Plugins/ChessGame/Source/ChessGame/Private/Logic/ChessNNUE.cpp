@@ -0,0 +1,394 @@
+#include "Logic/ChessNNUE.h"
+#include "Logic/ChessBoardState.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+// Widest kernels the target is guaranteed to have; the scalar ones are always built as well
+#if PLATFORM_ALWAYS_HAS_AVX_2 || defined(__AVX2__)
+	#define CHESS_NNUE_AVX2 1
+	#include <immintrin.h>
+#else
+	#define CHESS_NNUE_AVX2 0
+#endif
+
+#if !CHESS_NNUE_AVX2 && (PLATFORM_ENABLE_VECTORINTRINSICS_NEON || defined(__ARM_NEON))
+	#define CHESS_NNUE_NEON 1
+	#include <arm_neon.h>
+#else
+	#define CHESS_NNUE_NEON 0
+#endif
+
+#if !CHESS_NNUE_AVX2 && !CHESS_NNUE_NEON && (PLATFORM_ALWAYS_HAS_SSE4_1 || defined(__SSSE3__))
+	#define CHESS_NNUE_SSSE3 1
+	#include <tmmintrin.h>
+#else
+	#define CHESS_NNUE_SSSE3 0
+#endif
+
+namespace
+{
+	using namespace ChessNNUE;
+
+	constexpr int64 AlignSection(int64 Size) { return (Size + 63) & ~int64(63); }
+
+	// Byte offsets of each section in a weight file
+	constexpr int64 FeatureBiasOffset = sizeof(FFileHeader);
+	constexpr int64 FeatureWeightsOffset = FeatureBiasOffset + AlignSection(sizeof(int16) * L1);
+	constexpr int64 L2BiasOffset = FeatureWeightsOffset + AlignSection(sizeof(int16) * (int64)NumFeatures * L1);
+	constexpr int64 L2WeightsOffset = L2BiasOffset + AlignSection(sizeof(int32) * L2);
+	constexpr int64 OutputBiasOffset = L2WeightsOffset + AlignSection(sizeof(int8) * L2 * 2 * L1);
+	constexpr int64 OutputWeightsOffset = OutputBiasOffset + AlignSection(sizeof(int32));
+	constexpr int64 TotalFileSize = OutputWeightsOffset + AlignSection(sizeof(int8) * L2);
+
+	/** Portable reference kernels; every vector path must match these bit for bit. */
+	struct FScalarKernels
+	{
+		static void AddRow(int16* Acc, const int16* Row)
+		{
+			for (int32 i = 0; i < L1; ++i)
+			{
+				Acc[i] = (int16)(Acc[i] + Row[i]);
+			}
+		}
+
+		static void SubRow(int16* Acc, const int16* Row)
+		{
+			for (int32 i = 0; i < L1; ++i)
+			{
+				Acc[i] = (int16)(Acc[i] - Row[i]);
+			}
+		}
+
+		static void ClippedReLU(const int16* In, uint8* Out, int32 Num)
+		{
+			for (int32 i = 0; i < Num; ++i)
+			{
+				Out[i] = (uint8)FMath::Clamp<int32>(In[i], 0, ActivationMax);
+			}
+		}
+
+		static int32 Dot(const uint8* A, const int8* B, int32 Num)
+		{
+			int32 Sum = 0;
+			for (int32 i = 0; i < Num; ++i)
+			{
+				Sum += (int32)A[i] * (int32)B[i];
+			}
+			return Sum;
+		}
+	};
+
+#if CHESS_NNUE_AVX2
+	struct FSimdKernels
+	{
+		static void AddRow(int16* Acc, const int16* Row)
+		{
+			for (int32 i = 0; i < L1; i += 16)
+			{
+				__m256i* Dst = (__m256i*)(Acc + i);
+				_mm256_storeu_si256(Dst, _mm256_add_epi16(_mm256_loadu_si256(Dst), _mm256_loadu_si256((const __m256i*)(Row + i))));
+			}
+		}
+
+		static void SubRow(int16* Acc, const int16* Row)
+		{
+			for (int32 i = 0; i < L1; i += 16)
+			{
+				__m256i* Dst = (__m256i*)(Acc + i);
+				_mm256_storeu_si256(Dst, _mm256_sub_epi16(_mm256_loadu_si256(Dst), _mm256_loadu_si256((const __m256i*)(Row + i))));
+			}
+		}
+
+		static void ClippedReLU(const int16* In, uint8* Out, int32 Num)
+		{
+			const __m256i Max = _mm256_set1_epi8(ActivationMax);
+			for (int32 i = 0; i < Num; i += 32)
+			{
+				// Packing works per 128-bit lane, so the quadwords come out as 0 2 1 3 and need putting back in order
+				const __m256i Packed = _mm256_packus_epi16(_mm256_loadu_si256((const __m256i*)(In + i)), _mm256_loadu_si256((const __m256i*)(In + i + 16)));
+				const __m256i Ordered = _mm256_permute4x64_epi64(Packed, 0xD8);
+				_mm256_storeu_si256((__m256i*)(Out + i), _mm256_min_epu8(Ordered, Max));
+			}
+		}
+
+		static int32 Dot(const uint8* A, const int8* B, int32 Num)
+		{
+			// Activations stop at 127, so the paired products cannot saturate the 16-bit madd
+			const __m256i Ones = _mm256_set1_epi16(1);
+			__m256i Sum = _mm256_setzero_si256();
+			for (int32 i = 0; i < Num; i += 32)
+			{
+				const __m256i Products = _mm256_maddubs_epi16(_mm256_loadu_si256((const __m256i*)(A + i)), _mm256_loadu_si256((const __m256i*)(B + i)));
+				Sum = _mm256_add_epi32(Sum, _mm256_madd_epi16(Products, Ones));
+			}
+			__m128i Half = _mm_add_epi32(_mm256_castsi256_si128(Sum), _mm256_extracti128_si256(Sum, 1));
+			Half = _mm_add_epi32(Half, _mm_shuffle_epi32(Half, _MM_SHUFFLE(1, 0, 3, 2)));
+			Half = _mm_add_epi32(Half, _mm_shuffle_epi32(Half, _MM_SHUFFLE(2, 3, 0, 1)));
+			return _mm_cvtsi128_si32(Half);
+		}
+	};
+#elif CHESS_NNUE_SSSE3
+	struct FSimdKernels
+	{
+		static void AddRow(int16* Acc, const int16* Row)
+		{
+			for (int32 i = 0; i < L1; i += 8)
+			{
+				__m128i* Dst = (__m128i*)(Acc + i);
+				_mm_storeu_si128(Dst, _mm_add_epi16(_mm_loadu_si128(Dst), _mm_loadu_si128((const __m128i*)(Row + i))));
+			}
+		}
+
+		static void SubRow(int16* Acc, const int16* Row)
+		{
+			for (int32 i = 0; i < L1; i += 8)
+			{
+				__m128i* Dst = (__m128i*)(Acc + i);
+				_mm_storeu_si128(Dst, _mm_sub_epi16(_mm_loadu_si128(Dst), _mm_loadu_si128((const __m128i*)(Row + i))));
+			}
+		}
+
+		static void ClippedReLU(const int16* In, uint8* Out, int32 Num)
+		{
+			const __m128i Max = _mm_set1_epi8(ActivationMax);
+			for (int32 i = 0; i < Num; i += 16)
+			{
+				const __m128i Packed = _mm_packus_epi16(_mm_loadu_si128((const __m128i*)(In + i)), _mm_loadu_si128((const __m128i*)(In + i + 8)));
+				_mm_storeu_si128((__m128i*)(Out + i), _mm_min_epu8(Packed, Max));
+			}
+		}
+
+		static int32 Dot(const uint8* A, const int8* B, int32 Num)
+		{
+			const __m128i Ones = _mm_set1_epi16(1);
+			__m128i Sum = _mm_setzero_si128();
+			for (int32 i = 0; i < Num; i += 16)
+			{
+				const __m128i Products = _mm_maddubs_epi16(_mm_loadu_si128((const __m128i*)(A + i)), _mm_loadu_si128((const __m128i*)(B + i)));
+				Sum = _mm_add_epi32(Sum, _mm_madd_epi16(Products, Ones));
+			}
+			Sum = _mm_add_epi32(Sum, _mm_shuffle_epi32(Sum, _MM_SHUFFLE(1, 0, 3, 2)));
+			Sum = _mm_add_epi32(Sum, _mm_shuffle_epi32(Sum, _MM_SHUFFLE(2, 3, 0, 1)));
+			return _mm_cvtsi128_si32(Sum);
+		}
+	};
+#elif CHESS_NNUE_NEON
+	struct FSimdKernels
+	{
+		static void AddRow(int16* Acc, const int16* Row)
+		{
+			for (int32 i = 0; i < L1; i += 8)
+			{
+				vst1q_s16(Acc + i, vaddq_s16(vld1q_s16(Acc + i), vld1q_s16(Row + i)));
+			}
+		}
+
+		static void SubRow(int16* Acc, const int16* Row)
+		{
+			for (int32 i = 0; i < L1; i += 8)
+			{
+				vst1q_s16(Acc + i, vsubq_s16(vld1q_s16(Acc + i), vld1q_s16(Row + i)));
+			}
+		}
+
+		static void ClippedReLU(const int16* In, uint8* Out, int32 Num)
+		{
+			const uint8x16_t Max = vdupq_n_u8(ActivationMax);
+			for (int32 i = 0; i < Num; i += 16)
+			{
+				const uint8x16_t Packed = vcombine_u8(vqmovun_s16(vld1q_s16(In + i)), vqmovun_s16(vld1q_s16(In + i + 8)));
+				vst1q_u8(Out + i, vminq_u8(Packed, Max));
+			}
+		}
+
+		static int32 Dot(const uint8* A, const int8* B, int32 Num)
+		{
+			// Activations stop at 127, so they read the same as signed bytes
+			int32x4_t Sum = vdupq_n_s32(0);
+			for (int32 i = 0; i < Num; i += 16)
+			{
+				const int8x16_t Activations = vreinterpretq_s8_u8(vld1q_u8(A + i));
+				const int8x16_t Weights = vld1q_s8(B + i);
+				Sum = vpadalq_s16(Sum, vmull_s8(vget_low_s8(Activations), vget_low_s8(Weights)));
+				Sum = vpadalq_s16(Sum, vmull_s8(vget_high_s8(Activations), vget_high_s8(Weights)));
+			}
+			return vaddvq_s32(Sum);
+		}
+	};
+#else
+	using FSimdKernels = FScalarKernels;
+#endif
+
+	static_assert(L1 % 32 == 0 && (2 * L1) % 32 == 0 && L2 % 32 == 0, "Vector kernels step 32 bytes at a time");
+
+	// Which row the accumulator gets for a piece seen from one side; the mask row only when the piece wears one
+	template <typename Kernels, bool bAdd>
+	FORCEINLINE void UpdatePiece(FChessNNUEAccumulator& Accumulator, const FChessNNUENetwork& Network, const FPieceInstance& Piece, int32 Square)
+	{
+		if (!ChessBitboard::IsValidType(Piece.Type))
+		{
+			return;
+		}
+		const bool bMasked = ChessBitboard::IsValidType(Piece.MaskType);
+		for (int32 Side = 0; Side < ChessBitboard::NumColors; ++Side)
+		{
+			const EPieceColor Perspective = (EPieceColor)Side;
+			int16* Values = Accumulator.Values[Side];
+			const int16* Row = Network.GetFeatureRow(FeatureIndex(Perspective, Piece.Color, Piece.Type, Square, false));
+			bAdd ? Kernels::AddRow(Values, Row) : Kernels::SubRow(Values, Row);
+			if (bMasked)
+			{
+				const int16* MaskRow = Network.GetFeatureRow(FeatureIndex(Perspective, Piece.Color, Piece.MaskType, Square, true));
+				bAdd ? Kernels::AddRow(Values, MaskRow) : Kernels::SubRow(Values, MaskRow);
+			}
+		}
+	}
+}
+
+int64 ChessNNUE::GetFileSize()
+{
+	return TotalFileSize;
+}
+
+void FChessNNUEAccumulator::AddPiece(const FPieceInstance& Piece, int32 Square)
+{
+	UpdatePiece<FSimdKernels, true>(*this, *Network, Piece, Square);
+}
+
+void FChessNNUEAccumulator::RemovePiece(const FPieceInstance& Piece, int32 Square)
+{
+	UpdatePiece<FSimdKernels, false>(*this, *Network, Piece, Square);
+}
+
+void FChessNNUEAccumulator::Refresh(const UChessBoardState* Board)
+{
+	for (int32 Side = 0; Side < ChessBitboard::NumColors; ++Side)
+	{
+		FMemory::Memcpy(Values[Side], Network->GetFeatureBias(), sizeof(Values[Side]));
+	}
+
+	uint64 Ids = Board->GetPieceIds();
+	while (Ids)
+	{
+		const int32 PieceId = ChessBitboard::PopLsb(Ids);
+		const int32 Square = Board->GetPieceSquare(PieceId);
+		if (Square >= 0)
+		{
+			AddPiece(*Board->GetPiece(PieceId), Square);
+		}
+	}
+}
+
+FChessNNUENetwork::~FChessNNUENetwork()
+{
+	// The region must be unmapped before its file handle closes
+	MappedRegion.Reset();
+	MappedFile.Reset();
+}
+
+TSharedPtr<const FChessNNUENetwork, ESPMode::ThreadSafe> FChessNNUENetwork::LoadFromFile(const FString& Path)
+{
+	const FString FullPath = FPaths::IsRelative(Path) ? FPaths::Combine(FPaths::ProjectDir(), Path) : Path;
+
+	TSharedPtr<FChessNNUENetwork, ESPMode::ThreadSafe> Network = MakeShareable(new FChessNNUENetwork());
+	Network->MappedFile.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*FullPath));
+	if (Network->MappedFile.IsValid() && Network->MappedFile->GetFileSize() == TotalFileSize)
+	{
+		Network->MappedRegion.Reset(Network->MappedFile->MapRegion(0, TotalFileSize));
+	}
+
+	if (Network->MappedRegion.IsValid())
+	{
+		if (!Network->Bind(Network->MappedRegion->GetMappedPtr(), Network->MappedRegion->GetMappedSize()))
+		{
+			UE_LOG(LogTemp, Error, TEXT("ChessNNUE: %s is not a compatible weight file"), *FullPath);
+			return nullptr;
+		}
+		return Network;
+	}
+
+	// Not mappable here, or the wrong size; reading it gives a clearer error in the second case
+	Network->MappedFile.Reset();
+	TArray<uint8> FileBytes;
+	if (!FFileHelper::LoadFileToArray(FileBytes, *FullPath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("ChessNNUE: could not open weight file %s"), *FullPath);
+		return nullptr;
+	}
+	TSharedPtr<const FChessNNUENetwork, ESPMode::ThreadSafe> Loaded = CreateFromBytes(MoveTemp(FileBytes));
+	if (!Loaded.IsValid())
+	{
+		UE_LOG(LogTemp, Error, TEXT("ChessNNUE: %s is not a compatible weight file"), *FullPath);
+	}
+	return Loaded;
+}
+
+TSharedPtr<const FChessNNUENetwork, ESPMode::ThreadSafe> FChessNNUENetwork::CreateFromBytes(TArray<uint8>&& InBytes)
+{
+	TSharedPtr<FChessNNUENetwork, ESPMode::ThreadSafe> Network = MakeShareable(new FChessNNUENetwork());
+	Network->Bytes = MoveTemp(InBytes);
+	if (!Network->Bind(Network->Bytes.GetData(), Network->Bytes.Num()))
+	{
+		return nullptr;
+	}
+	return Network;
+}
+
+bool FChessNNUENetwork::Bind(const uint8* Data, int64 Size)
+{
+	if (!Data || Size != TotalFileSize)
+	{
+		return false;
+	}
+
+	FFileHeader Header;
+	FMemory::Memcpy(&Header, Data, sizeof(Header));
+	if (Header.Magic != FileMagic || Header.Version != FileVersion || Header.NumFeatures != (uint32)NumFeatures
+		|| Header.L1 != (uint32)L1 || Header.L2 != (uint32)L2)
+	{
+		return false;
+	}
+
+	FeatureBias = (const int16*)(Data + FeatureBiasOffset);
+	FeatureWeights = (const int16*)(Data + FeatureWeightsOffset);
+	L2Bias = (const int32*)(Data + L2BiasOffset);
+	L2Weights = (const int8*)(Data + L2WeightsOffset);
+	FMemory::Memcpy(&OutputBias, Data + OutputBiasOffset, sizeof(OutputBias));
+	OutputWeights = (const int8*)(Data + OutputWeightsOffset);
+	return true;
+}
+
+template <typename Kernels>
+int32 FChessNNUENetwork::Forward(const FChessNNUEAccumulator& Accumulator, EPieceColor SideToMove) const
+{
+	// The side to move always fills the first half, so one set of weights serves both colours
+	alignas(64) uint8 Input[2 * L1];
+	const EPieceColor Other = (SideToMove == EPieceColor::White) ? EPieceColor::Black : EPieceColor::White;
+	Kernels::ClippedReLU(Accumulator.Values[(uint8)SideToMove], Input, L1);
+	Kernels::ClippedReLU(Accumulator.Values[(uint8)Other], Input + L1, L1);
+
+	alignas(64) int16 Hidden[L2];
+	for (int32 i = 0; i < L2; ++i)
+	{
+		const int32 Sum = L2Bias[i] + Kernels::Dot(Input, L2Weights + i * 2 * L1, 2 * L1);
+		Hidden[i] = (int16)FMath::Clamp(Sum >> L2Shift, -32768, 32767);
+	}
+
+	alignas(64) uint8 HiddenOut[L2];
+	Kernels::ClippedReLU(Hidden, HiddenOut, L2);
+
+	const int32 Output = OutputBias + Kernels::Dot(HiddenOut, OutputWeights, L2);
+	return FMath::Clamp(Output / OutputDivisor, -MaxScore, MaxScore);
+}
+
+int32 FChessNNUENetwork::Evaluate(const FChessNNUEAccumulator& Accumulator, EPieceColor SideToMove) const
+{
+	return Forward<FSimdKernels>(Accumulator, SideToMove);
+}
+
+int32 FChessNNUENetwork::EvaluateScalar(const FChessNNUEAccumulator& Accumulator, EPieceColor SideToMove) const
+{
+	return Forward<FScalarKernels>(Accumulator, SideToMove);
+}
@@ -0,0 +1,29 @@
+#include "Logic/ChessPackedMove.h"
+#include "Logic/ChessBoardState.h"
+
+FChessMove FChessPackedMove::ToMove(const UChessBoardState* Board) const
+{
+	FChessMove Move;
+	Move.From = FBoardCoord::FromIndex(GetFrom());
+	Move.To = FBoardCoord::FromIndex(GetTo());
+	Move.SpecialType = GetSpecialType();
+	Move.PromotionType = GetPromotionType();
+
+	if (Board)
+	{
+		Move.MovingPieceId = Board->Squares[GetFrom()];
+		switch (Move.SpecialType)
+		{
+		case ESpecialMoveType::Castling:
+			break;
+		case ESpecialMoveType::EnPassant:
+			// The captured pawn stands beside the mover, on the target file
+			Move.CapturedPieceId = Board->Squares[Move.From.Rank * 8 + Move.To.File];
+			break;
+		default:
+			Move.CapturedPieceId = Board->Squares[GetTo()];
+			break;
+		}
+	}
+	return Move;
+}
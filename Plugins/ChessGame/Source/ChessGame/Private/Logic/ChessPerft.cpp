@@ -0,0 +1,157 @@
+#include "Logic/ChessPerft.h"
+#include "Logic/ChessBoardState.h"
+#include "Logic/ChessRuleSet.h"
+#include "HAL/IConsoleManager.h"
+
+namespace
+{
+	uint64 PerftRecursive(UChessRuleSet* RuleSet, UChessBoardState* Board, int32 Depth)
+	{
+		FChessPackedMoveList Moves;
+		RuleSet->GenerateAllLegalMoves(Board, Board->SideToMove, Moves);
+
+		// Bulk count the last ply: every legal move is exactly one leaf
+		if (Depth == 1)
+		{
+			return Moves.Num();
+		}
+
+		uint64 Nodes = 0;
+		for (const FChessPackedMove Move : Moves)
+		{
+			FMoveUndoRecord Undo;
+			Board->MakeMove(Move, Undo);
+			Nodes += PerftRecursive(RuleSet, Board, Depth - 1);
+			Board->UnmakeMove(Undo);
+		}
+		return Nodes;
+	}
+}
+
+uint64 FChessPerft::Perft(UChessRuleSet* RuleSet, UChessBoardState* Board, int32 Depth)
+{
+	if (!RuleSet || !Board)
+	{
+		return 0;
+	}
+	return Depth <= 0 ? 1 : PerftRecursive(RuleSet, Board, Depth);
+}
+
+FChessPerftResult FChessPerft::Divide(UChessRuleSet* RuleSet, UChessBoardState* Board, int32 Depth)
+{
+	FChessPerftResult Result;
+	if (!RuleSet || !Board || Depth <= 0)
+	{
+		return Result;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	FChessPackedMoveList Moves;
+	RuleSet->GenerateAllLegalMoves(Board, Board->SideToMove, Moves);
+	for (const FChessPackedMove Move : Moves)
+	{
+		FChessPerftDivideEntry& Entry = Result.Divide.AddDefaulted_GetRef();
+		Entry.Move = Move.ToMove(Board);
+
+		FMoveUndoRecord Undo;
+		Board->MakeMove(Move, Undo);
+		Entry.Nodes = Depth > 1 ? PerftRecursive(RuleSet, Board, Depth - 1) : 1;
+		Board->UnmakeMove(Undo);
+
+		Result.Nodes += Entry.Nodes;
+	}
+
+	Result.Seconds = FPlatformTime::Seconds() - StartTime;
+	return Result;
+}
+
+const TArray<FChessPerftPosition>& FChessPerft::GetStandardPositions()
+{
+	static const TArray<FChessPerftPosition> Positions = {
+		{ TEXT("StartPosition"), TEXT("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"), 5, 4865609 },
+		{ TEXT("Kiwipete"), TEXT("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"), 4, 4085603 },
+		{ TEXT("EnPassantPins"), TEXT("8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1"), 5, 674624 },
+		{ TEXT("CastlingPromotion"), TEXT("r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1"), 4, 422333 },
+		{ TEXT("PromotionChecks"), TEXT("rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8"), 4, 2103487 },
+		{ TEXT("Middlegame"), TEXT("r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10"), 4, 3894594 },
+	};
+	return Positions;
+}
+
+FString FChessPerft::MoveToString(const FChessMove& Move)
+{
+	FString Result = FString::Printf(TEXT("%c%d%c%d"),
+		(TCHAR)('a' + Move.From.File), Move.From.Rank + 1, (TCHAR)('a' + Move.To.File), Move.To.Rank + 1);
+
+	if (Move.SpecialType == ESpecialMoveType::Promotion)
+	{
+		static const TCHAR PromotionChars[] = TEXT("pnbrqk");
+		Result.AppendChar(PromotionChars[FMath::Clamp((int32)Move.PromotionType, 0, 5)]);
+	}
+	return Result;
+}
+
+// Chess.Perft <Depth> [Position name | FEN]: divide output and throughput for the stock rules
+static FAutoConsoleCommandWithArgs ChessPerftCommand(
+	TEXT("Chess.Perft"),
+	TEXT("Chess.Perft <Depth> [PositionName|FEN]. Runs perft with divide output; without a position, runs the standard battery."),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		const int32 Depth = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 0;
+
+		UChessRuleSet* RuleSet = NewObject<UChessRuleSet>();
+		RuleSet->Initialize();
+		UChessBoardState* Board = NewObject<UChessBoardState>();
+
+		auto Run = [RuleSet, Board](const TCHAR* Name, int32 RunDepth, uint64 ExpectedNodes, bool bPrintDivide)
+		{
+			const FChessPerftResult Result = FChessPerft::Divide(RuleSet, Board, RunDepth);
+			if (bPrintDivide)
+			{
+				for (const FChessPerftDivideEntry& Entry : Result.Divide)
+				{
+					UE_LOG(LogTemp, Display, TEXT("  %s: %llu"), *FChessPerft::MoveToString(Entry.Move), Entry.Nodes);
+				}
+			}
+
+			const TCHAR* Status = ExpectedNodes == 0 ? TEXT("") : (Result.Nodes == ExpectedNodes ? TEXT(" [OK]") : TEXT(" [MISMATCH]"));
+			UE_LOG(LogTemp, Display, TEXT("Perft %s depth %d: %llu nodes in %.3fs (%.0f nps)%s"),
+				Name, RunDepth, Result.Nodes, Result.Seconds, Result.GetNodesPerSecond(), Status);
+		};
+
+		// A name or FEN may follow the depth; FENs contain spaces so rejoin the remaining args
+		FString Position;
+		for (int32 i = 1; i < Args.Num(); ++i)
+		{
+			Position += (i > 1 ? TEXT(" ") : TEXT("")) + Args[i];
+		}
+
+		if (Position.IsEmpty())
+		{
+			for (const FChessPerftPosition& Standard : FChessPerft::GetStandardPositions())
+			{
+				Board->LoadFromFEN(Standard.FEN);
+				Run(Standard.Name, Depth > 0 ? Depth : Standard.Depth, Depth > 0 ? 0 : Standard.ExpectedNodes, false);
+			}
+			return;
+		}
+
+		const TCHAR* Label = TEXT("custom");
+		for (const FChessPerftPosition& Standard : FChessPerft::GetStandardPositions())
+		{
+			if (Position == Standard.Name)
+			{
+				Label = Standard.Name;
+				Position = Standard.FEN;
+				break;
+			}
+		}
+
+		if (!Board->LoadFromFEN(Position))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Chess.Perft: could not parse position '%s'"), *Position);
+			return;
+		}
+		Run(Label, Depth > 0 ? Depth : 1, 0, true);
+	}));
@@ -1,43 +1,35 @@
 #include "Logic/ChessRuleSet.h"
 #include "Logic/ChessMoveRule.h"
+#include "Logic/ChessLegalMoveGenerator.h"
 
 UChessRuleSet::UChessRuleSet()
 {
 }
 
-void UChessRuleSet::Initialize(UObject* WorldContextObject)
+void UChessRuleSet::Initialize(UObject* /*WorldContextObject*/)
 {
 	// Default mappings if not set
 	if (MoveRuleClasses.Num() == 0)
 	{
-		MoveRuleClasses.Add(EPieceType::Rook, AChessMoveRule_Sliding::StaticClass());
-		MoveRuleClasses.Add(EPieceType::Bishop, AChessMoveRule_Sliding::StaticClass());
-		MoveRuleClasses.Add(EPieceType::Queen, AChessMoveRule_Sliding::StaticClass());
-		MoveRuleClasses.Add(EPieceType::Knight, AChessMoveRule_Knight::StaticClass());
-		MoveRuleClasses.Add(EPieceType::Pawn, AChessMoveRule_Pawn::StaticClass());
-		MoveRuleClasses.Add(EPieceType::King, AChessMoveRule_King::StaticClass());
+		MoveRuleClasses.Add(EPieceType::Rook, UChessMoveRule_Sliding::StaticClass());
+		MoveRuleClasses.Add(EPieceType::Bishop, UChessMoveRule_Sliding::StaticClass());
+		MoveRuleClasses.Add(EPieceType::Queen, UChessMoveRule_Sliding::StaticClass());
+		MoveRuleClasses.Add(EPieceType::Knight, UChessMoveRule_Knight::StaticClass());
+		MoveRuleClasses.Add(EPieceType::Pawn, UChessMoveRule_Pawn::StaticClass());
+		MoveRuleClasses.Add(EPieceType::King, UChessMoveRule_King::StaticClass());
 	}
 	
-	// Spawn instances
-	UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : GetWorld();
-	if (!World) return;
-	// Wait, RuleSet is UObject. GetWorld might return null or outer's world.
-	// If RuleSet is owned by GameModel (UObject), GetWorld() requires implementation or outer chain.
-	
-	// Assuming RuleSet is created within an Actor's world context (GameModel created in BoardActor).
-	
-	FActorSpawnParameters Params;
-	Params.ObjectFlags |= RF_Transient;
-
+	// Rules are stateless objects owned by the rule set; no world is involved
+	MoveRules.Empty();
 	for (const auto& Pair : MoveRuleClasses)
 	{
 		if (Pair.Value)
 		{
-			AChessMoveRule* Rule = World->SpawnActor<AChessMoveRule>(Pair.Value, Params);
+			UChessMoveRule* Rule = NewObject<UChessMoveRule>(this, Pair.Value, NAME_None, RF_Transient);
 			if (Rule)
 			{
 				// Configure Sliding rules specifically if using the generic class
-				if (AChessMoveRule_Sliding* Sliding = Cast<AChessMoveRule_Sliding>(Rule))
+				if (UChessMoveRule_Sliding* Sliding = Cast<UChessMoveRule_Sliding>(Rule))
 				{
 					if (Pair.Key == EPieceType::Rook) Sliding->bOrthogonal = true;
 					if (Pair.Key == EPieceType::Bishop) Sliding->bDiagonal = true;
@@ -47,12 +39,38 @@ void UChessRuleSet::Initialize(UObject* WorldContextObject)
 			}
 		}
 	}
+
+	// Detect the stock rule configuration so attack queries can use the bitboard tables
+	auto IsRule = [this](EPieceType Type, UClass* ExpectedClass) {
+		UChessMoveRule* const* RulePtr = MoveRules.Find(Type);
+		return RulePtr && *RulePtr && (*RulePtr)->GetClass() == ExpectedClass;
+	};
+	auto IsSliding = [this, &IsRule](EPieceType Type, bool bOrthogonal, bool bDiagonal) {
+		if (!IsRule(Type, UChessMoveRule_Sliding::StaticClass())) return false;
+		const UChessMoveRule_Sliding* Sliding = Cast<UChessMoveRule_Sliding>(MoveRules.FindRef(Type));
+		return Sliding->bOrthogonal == bOrthogonal && Sliding->bDiagonal == bDiagonal;
+	};
+	bStandardRules = IsRule(EPieceType::Pawn, UChessMoveRule_Pawn::StaticClass())
+		&& IsRule(EPieceType::Knight, UChessMoveRule_Knight::StaticClass())
+		&& IsRule(EPieceType::King, UChessMoveRule_King::StaticClass())
+		&& IsSliding(EPieceType::Bishop, false, true)
+		&& IsSliding(EPieceType::Rook, true, false)
+		&& IsSliding(EPieceType::Queen, true, true);
 }
 
-void UChessRuleSet::SetupInitialBoardState(UChessBoardState* BoardState, EChessInitMode InitMode)
+void UChessRuleSet::SetupInitialBoardState(UChessBoardState* BoardState, EChessInitMode InitMode, const FString& FEN)
 {
 	BoardState->InitializeEmpty();
 
+	if (InitMode == EChessInitMode::FromFEN)
+	{
+		if (!BoardState->LoadFromFEN(FEN))
+		{
+			UE_LOG(LogTemp, Error, TEXT("SetupInitialBoardState: invalid FEN '%s', board left empty"), *FEN);
+		}
+		return;
+	}
+
 	// Helper to add pieces
 	int32 NextId = 0;
 	auto AddPiece = [&](EPieceType Type, EPieceColor Color, int32 File, int32 Rank) {
@@ -118,13 +136,13 @@ void UChessRuleSet::SetupInitialBoardState(UChessBoardState* BoardState, EChessI
 		for (int i = 0; i < 8; i++) AddPiece(EPieceType::Pawn, EPieceColor::Black, i, 6);
 
 		// 2. Apply Masks
-		for (auto& Pair : BoardState->Pieces)
+		for (uint64 Ids = BoardState->GetPieceIds(); Ids; )
 		{
 			// Mask everything as Pawn (except maybe Kings?)
 			// User said "all of the pieces". Let's do all.
 			// Ideally King mask might be confusing if it looks like a Pawn.
 			// But for testing "Mask Logic", it's fine.
-			Pair.Value.MaskType = EPieceType::Pawn;
+			BoardState->SetPieceMask(ChessBitboard::PopLsb(Ids), EPieceType::Pawn);
 		}
 	}
 	else if (InitMode == EChessInitMode::Test_MaskSwap)
@@ -187,12 +205,9 @@ void UChessRuleSet::SetupInitialBoardState(UChessBoardState* BoardState, EChessI
 
 			// Assign to pieces of this color
 			int32 MaskIdx = 0;
-			for (auto& Pair : BoardState->Pieces)
+			for (uint64 Ids = BoardState->GetPieceIds(Color); Ids && MaskIdx < Masks.Num(); )
 			{
-				if (Pair.Value.Color == Color && MaskIdx < Masks.Num())
-				{
-					Pair.Value.MaskType = Masks[MaskIdx++];
-				}
+				BoardState->SetPieceMask(ChessBitboard::PopLsb(Ids), Masks[MaskIdx++]);
 			}
 		};
 
@@ -258,74 +273,57 @@ void UChessRuleSet::SetupInitialBoardState(UChessBoardState* BoardState, EChessI
 	// Empty: do nothing
 }
 
-void UChessRuleSet::GeneratePseudoLegalMoves(const UChessBoardState* Board, int32 PieceId, TArray<FChessMove>& OutMoves)
+void UChessRuleSet::GeneratePseudoLegalMoves(const UChessBoardState* Board, int32 PieceId, FChessMoveList& OutMoves)
 {
-	const FPieceInstance* Piece = Board->Pieces.Find(PieceId);
+	const FPieceInstance* Piece = Board->GetPiece(PieceId);
 	if (!Piece) return;
 	
 	// 1. Generate Canonical Moves (Move + Capture)
-	if (AChessMoveRule** RulePtr = MoveRules.Find(Piece->Type))
+	if (UChessMoveRule** RulePtr = MoveRules.Find(Piece->Type))
 	{
-		if (AChessMoveRule* Rule = *RulePtr)
+		if (UChessMoveRule* Rule = *RulePtr)
 		{
-			// Find coord
-			FBoardCoord From;
-			bool bFound = false;
-			for (int32 i = 0; i < 64; ++i)
-			{
-				if (Board->Squares[i] == PieceId)
-				{
-					From = FBoardCoord::FromIndex(i);
-					bFound = true;
-					break;
-				}
-			}
-
-			if (bFound)
+			FBoardCoord From = Board->FindPieceCoord(PieceId);
+			if (From.IsValid())
 			{
-				Rule->GenerateMoves(Board, From, *Piece, OutMoves);
+				const int32 FirstMove = OutMoves.Num();
+				Rule->Generate(Board, From, *Piece, OutMoves);
 
 				// 2. Generate Mask Moves (Move ONLY, No Capture)
 				if (Piece->MaskType != EPieceType::None && Piece->MaskType != Piece->Type)
 				{
-					if (AChessMoveRule** MaskRulePtr = MoveRules.Find(Piece->MaskType))
+					if (UChessMoveRule** MaskRulePtr = MoveRules.Find(Piece->MaskType))
 					{
-						if (AChessMoveRule* MaskRule = *MaskRulePtr)
+						if (UChessMoveRule* MaskRule = *MaskRulePtr)
 						{
-							TArray<FChessMove> MaskMoves;
+							// Targets the real piece already reaches; mask moves never duplicate these
+							uint64 UsedTargets = 0;
+							for (int32 i = FirstMove; i < OutMoves.Num(); ++i)
+							{
+								UsedTargets |= ChessBitboard::SquareBit(OutMoves[i].To.ToIndex());
+							}
+
 							// Create a "Fake" piece with MaskType for the generator (so Pawns know direction etc)
 							FPieceInstance MaskPiece = *Piece;
 							MaskPiece.Type = Piece->MaskType;
-							
-							MaskRule->GenerateMoves(Board, From, MaskPiece, MaskMoves);
 
-							// Filter: Add only NON-CAPTURING moves
-							for (const FChessMove& MMove : MaskMoves)
+							// Generate in place after the real moves, then compact away captures and duplicates
+							const int32 FirstMaskMove = OutMoves.Num();
+							MaskRule->Generate(Board, From, MaskPiece, OutMoves);
+
+							int32 Kept = FirstMaskMove;
+							for (int32 i = FirstMaskMove; i < OutMoves.Num(); ++i)
 							{
-								if (MMove.CapturedPieceId == -1 && MMove.SpecialType != ESpecialMoveType::EnPassant)
+								const FChessMove& MMove = OutMoves[i];
+								const uint64 ToBit = ChessBitboard::SquareBit(MMove.To.ToIndex());
+								if (MMove.CapturedPieceId == -1 && MMove.SpecialType != ESpecialMoveType::EnPassant && !(UsedTargets & ToBit))
 								{
-									// Avoid duplicates
-									bool bExists = false;
-									for (const FChessMove& Existing : OutMoves)
-									{
-										if (Existing.To == MMove.To)
-										{
-											bExists = true; 
-											break;
-										}
-									}
-									if (!bExists)
-									{
-										// Restore MovingPieceId to real piece ID (GenerateMoves might have used the copy's ID which is same, but let's be safe)
-										// The copy had same ID, so it's fine.
-										// But ensure SpecialType logic (like Promotion) is consistent.
-										// If Mask is Pawn, and it reaches end -> Promotion?
-										// User didn't specify. Assuming yes, but they promote to what? Masked Queen? 
-										// For MVP, allow the movement.
-										OutMoves.Add(MMove);
-									}
+									// Promotion by a pawn mask is allowed as generated; the copy kept the real piece id
+									UsedTargets |= ToBit;
+									OutMoves[Kept++] = MMove;
 								}
 							}
+							OutMoves.SetNum(Kept, EAllowShrinking::No);
 						}
 					}
 				}
@@ -336,71 +334,217 @@ void UChessRuleSet::GeneratePseudoLegalMoves(const UChessBoardState* Board, int3
 
 void UChessRuleSet::GenerateLegalMoves(const UChessBoardState* Board, int32 PieceId, TArray<FChessMove>& OutMoves)
 {
-	TArray<FChessMove> PseudoMoves;
-	GeneratePseudoLegalMoves(Board, PieceId, PseudoMoves);
+	FChessMoveList Moves;
+	GenerateLegalMoves(Board, PieceId, Moves);
+	OutMoves.Append(Moves);
+}
 
+void UChessRuleSet::GenerateLegalMoves(const UChessBoardState* Board, int32 PieceId, FChessMoveList& OutMoves)
+{
+	// Stock rules: emit legal moves directly from check/pin masks
+	if (bStandardRules)
+	{
+		const FPieceInstance* Piece = Board->GetPiece(PieceId);
+		if (!Piece) return;
+
+		FChessCheckInfo CheckInfo;
+		if (CheckInfo.Init(Board, Piece->Color))
+		{
+			FChessLegalMoveGenerator::GeneratePieceMoves(Board, CheckInfo, PieceId, OutMoves);
+			return;
+		}
+	}
+
+	// Custom rules (or no single king to protect): filter pseudo-legal moves by playing them on a copy
+	UChessBoardState* Scratch = AcquireScratch(Board);
+	GenerateLegalMovesOnScratch(Board, Scratch, PieceId, OutMoves);
+	ReleaseScratch();
+}
+
+void UChessRuleSet::GenerateLegalMovesOnScratch(const UChessBoardState* Board, UChessBoardState* Scratch, int32 PieceId, FChessMoveList& OutMoves)
+{
+	FChessMoveList PseudoMoves;
+	GeneratePseudoLegalMoves(Board, PieceId, PseudoMoves);
 	for (const FChessMove& Move : PseudoMoves)
 	{
-		if (IsMoveLegal(Board, Move))
+		if (IsMoveLegal(Scratch, Move))
 		{
 			OutMoves.Add(Move);
 		}
 	}
 }
 
-bool UChessRuleSet::IsMoveLegal(const UChessBoardState* Board, const FChessMove& Move)
+void UChessRuleSet::GenerateLegalMoves(const UChessBoardState* Board, int32 PieceId, FChessPackedMoveList& OutMoves)
 {
-	// 1. Clone board
-	UChessBoardState* TempBoard = NewObject<UChessBoardState>();
-	TempBoard->Squares = Board->Squares;
-	TempBoard->Pieces = Board->Pieces;
-	TempBoard->SideToMove = Board->SideToMove;
-	TempBoard->bHasEnPassantTarget = Board->bHasEnPassantTarget;
-	TempBoard->EnPassantTarget = Board->EnPassantTarget;
-	
-	// Apply Move to TempBoard
-	TempBoard->SetPieceIdAt(Move.From, -1);
-	TempBoard->SetPieceIdAt(Move.To, Move.MovingPieceId);
-	
-	// Handle capture
-	if (Move.CapturedPieceId != -1)
+	if (bStandardRules)
 	{
-		TempBoard->RemovePiece(Move.CapturedPieceId);
+		const FPieceInstance* Piece = Board->GetPiece(PieceId);
+		if (!Piece) return;
+
+		FChessCheckInfo CheckInfo;
+		if (CheckInfo.Init(Board, Piece->Color))
+		{
+			FChessLegalMoveGenerator::GeneratePieceMoves(Board, CheckInfo, PieceId, OutMoves);
+			return;
+		}
 	}
-	// Note: EnPassant capture removes a different pawn
-	if (Move.SpecialType == ESpecialMoveType::EnPassant)
+
+	FChessMoveList Moves;
+	GenerateLegalMoves(Board, PieceId, Moves);
+	for (const FChessMove& Move : Moves)
 	{
-		FBoardCoord CapturedCoord(Move.To.File, Move.From.Rank);
-		TempBoard->SetPieceIdAt(CapturedCoord, -1);
-		// Assuming proper captured piece ID handling in generator/logic
+		OutMoves.Add(FChessPackedMove::FromMove(Move));
 	}
-	
-	// Check if King is in Check
-	const FPieceInstance* MovingPiece = Board->Pieces.Find(Move.MovingPieceId);
-	if (MovingPiece)
+}
+
+void UChessRuleSet::GenerateAllLegalMoves(const UChessBoardState* Board, EPieceColor Color, TArray<FChessMove>& OutMoves)
+{
+	FChessMoveList Moves;
+	GenerateAllLegalMoves(Board, Color, Moves);
+	OutMoves.Append(Moves);
+}
+
+void UChessRuleSet::GenerateAllLegalMoves(const UChessBoardState* Board, EPieceColor Color, FChessMoveList& OutMoves)
+{
+	if (!Board) return;
+
+	if (bStandardRules)
 	{
-		return !IsKingInCheck(TempBoard, MovingPiece->Color);
+		FChessCheckInfo CheckInfo;
+		if (CheckInfo.Init(Board, Color))
+		{
+			FChessLegalMoveGenerator::GenerateAllMoves(Board, CheckInfo, OutMoves);
+			return;
+		}
 	}
-	
-	return false;
+
+	// One copy serves every piece; each legality test leaves it as it found it
+	UChessBoardState* Scratch = AcquireScratch(Board);
+	uint64 SidePieces = Board->GetColorOccupancy(Color);
+	while (SidePieces)
+	{
+		GenerateLegalMovesOnScratch(Board, Scratch, Board->Squares[ChessBitboard::PopLsb(SidePieces)], OutMoves);
+	}
+	ReleaseScratch();
 }
 
-FBoardCoord UChessRuleSet::FindKing(const UChessBoardState* Board, EPieceColor Color) const
+void UChessRuleSet::GenerateAllLegalMoves(const UChessBoardState* Board, EPieceColor Color, FChessPackedMoveList& OutMoves)
 {
-	for (const auto& Pair : Board->Pieces)
+	if (!Board) return;
+
+	if (bStandardRules)
 	{
-		if (Pair.Value.Type == EPieceType::King && Pair.Value.Color == Color)
+		FChessCheckInfo CheckInfo;
+		if (CheckInfo.Init(Board, Color))
 		{
-			// Need location
-			for (int32 i = 0; i < 64; ++i)
+			FChessLegalMoveGenerator::GenerateAllMoves(Board, CheckInfo, OutMoves);
+			return;
+		}
+	}
+
+	FChessMoveList Moves;
+	GenerateAllLegalMoves(Board, Color, Moves);
+	for (const FChessMove& Move : Moves)
+	{
+		OutMoves.Add(FChessPackedMove::FromMove(Move));
+	}
+}
+
+bool UChessRuleSet::HasAnyLegalMove(const UChessBoardState* Board, EPieceColor Color)
+{
+	if (!Board) return false;
+
+	if (bStandardRules)
+	{
+		FChessCheckInfo CheckInfo;
+		if (CheckInfo.Init(Board, Color))
+		{
+			return FChessLegalMoveGenerator::HasAnyLegalMove(Board, CheckInfo);
+		}
+	}
+
+	// Custom rules: test pseudo-legal moves one at a time, king first since it is the usual way out of check
+	UChessBoardState* Scratch = AcquireScratch(Board);
+	bool bFound = false;
+	const uint64 Kings = Board->GetPieceOccupancy(Color, EPieceType::King);
+	const uint64 Own = Board->GetColorOccupancy(Color);
+	for (uint64 Candidates : { Kings, Own & ~Kings })
+	{
+		while (Candidates && !bFound)
+		{
+			FChessMoveList PseudoMoves;
+			GeneratePseudoLegalMoves(Board, Board->Squares[ChessBitboard::PopLsb(Candidates)], PseudoMoves);
+			for (const FChessMove& Move : PseudoMoves)
 			{
-				if (Board->Squares[i] == Pair.Key)
+				if (IsMoveLegal(Scratch, Move))
 				{
-					return FBoardCoord::FromIndex(i);
+					bFound = true;
+					break;
 				}
 			}
 		}
 	}
+	ReleaseScratch();
+	return bFound;
+}
+
+UChessBoardState* UChessRuleSet::AcquireScratch(const UChessBoardState* Board)
+{
+	// Boards are only created the first time a nesting depth is reached, then reused
+	if (NumScratchInUse == ScratchBoards.Num())
+	{
+		ScratchBoards.Add(NewObject<UChessBoardState>(this, NAME_None, RF_Transient));
+	}
+	UChessBoardState* Scratch = ScratchBoards[NumScratchInUse++];
+	Scratch->CopyFrom(*Board);
+	return Scratch;
+}
+
+void UChessRuleSet::ReleaseScratch()
+{
+	check(NumScratchInUse > 0);
+	--NumScratchInUse;
+}
+
+bool UChessRuleSet::IsMoveLegal(UChessBoardState* Board, const FChessMove& Move)
+{
+	const FPieceInstance* MovingPiece = Board->GetPiece(Move.MovingPieceId);
+	if (!MovingPiece)
+	{
+		return false;
+	}
+	const EPieceColor MovingColor = MovingPiece->Color;
+
+	// Castling may not start from, or pass through, an attacked square (the destination is covered below)
+	if (Move.SpecialType == ESpecialMoveType::Castling && MovingPiece->Type == EPieceType::King)
+	{
+		const EPieceColor EnemyColor = (MovingColor == EPieceColor::White) ? EPieceColor::Black : EPieceColor::White;
+		const int32 Step = (Move.To.File > Move.From.File) ? 1 : -1;
+		for (int32 File = Move.From.File; File != Move.To.File; File += Step)
+		{
+			if (IsSquareAttacked(Board, FBoardCoord(File, Move.From.Rank), EnemyColor))
+			{
+				return false;
+			}
+		}
+	}
+
+	// Play the move and take it back; the board is bit-for-bit identical afterwards
+	FMoveUndoRecord Undo;
+	Board->MakeMove(Move, Undo);
+	const bool bLegal = !IsKingInCheck(Board, MovingColor);
+	Board->UnmakeMove(Undo);
+
+	return bLegal;
+}
+
+FBoardCoord UChessRuleSet::FindKing(const UChessBoardState* Board, EPieceColor Color) const
+{
+	uint64 Kings = Board->GetPieceOccupancy(Color, EPieceType::King);
+	if (Kings)
+	{
+		return FBoardCoord::FromIndex(ChessBitboard::Lsb(Kings));
+	}
 	return FBoardCoord(); // Invalid
 }
 
@@ -410,39 +554,64 @@ bool UChessRuleSet::IsKingInCheck(const UChessBoardState* Board, EPieceColor Col
 	if (!KingPos.IsValid()) return false; 
 
 	EPieceColor EnemyColor = (Color == EPieceColor::White) ? EPieceColor::Black : EPieceColor::White;
+	return IsSquareAttacked(Board, KingPos, EnemyColor);
+}
+
+bool UChessRuleSet::IsSquareAttacked(const UChessBoardState* Board, FBoardCoord Square, EPieceColor ByColor)
+{
+	if (!Board || !Square.IsValid()) return false;
 
-	for (const auto& Pair : Board->Pieces)
+	if (bStandardRules)
 	{
-		if (Pair.Value.Color == EnemyColor)
-		{
-			if (AChessMoveRule** RulePtr = MoveRules.Find(Pair.Value.Type))
-			{
-				AChessMoveRule* Rule = *RulePtr;
-				if (!Rule) continue; 
+		return Board->IsSquareAttacked(Square.ToIndex(), ByColor);
+	}
+	return IsSquareAttackedByRules(Board, Square, ByColor);
+}
 
-				// Get location of enemy
-				FBoardCoord EnemyPos;
-				bool bFound = false;
-				for (int32 i = 0; i < 64; ++i)
-				{
-					if (Board->Squares[i] == Pair.Value.PieceId)
-					{
-						EnemyPos = FBoardCoord::FromIndex(i);
-						bFound = true;
-						break;
-					}
-				}
+bool UChessRuleSet::IsInsufficientMaterial(const UChessBoardState* Board) const
+{
+	// Custom move rules may let any piece mate, so only the stock rules can be judged on material
+	if (!Board || !bStandardRules) return false;
+
+	// Masks never change what a piece attacks, but a pawn mask lends its pushes, promotion included, so any
+	// piece wearing one may still become a queen. Otherwise true types decide.
+	if (Board->GetTypeOccupancy(EPieceType::Pawn) | Board->GetMaskOccupancy(EPieceType::Pawn)
+		| Board->GetTypeOccupancy(EPieceType::Rook) | Board->GetTypeOccupancy(EPieceType::Queen))
+	{
+		return false;
+	}
+
+	const uint64 Knights = Board->GetTypeOccupancy(EPieceType::Knight);
+	const uint64 Bishops = Board->GetTypeOccupancy(EPieceType::Bishop);
+	if (ChessBitboard::PopCount(Knights | Bishops) <= 1)
+	{
+		return true;
+	}
+
+	return !Knights && ((Bishops & ChessBitboard::DarkSquares) == 0 || (Bishops & ~ChessBitboard::DarkSquares) == 0);
+}
+
+bool UChessRuleSet::IsSquareAttackedByRules(const UChessBoardState* Board, FBoardCoord Square, EPieceColor ByColor)
+{
+	for (uint64 Ids = Board->GetPieceIds(ByColor); Ids; )
+	{
+		const FPieceInstance& Enemy = *Board->GetPiece(ChessBitboard::PopLsb(Ids));
+		if (UChessMoveRule** RulePtr = MoveRules.Find(Enemy.Type))
+		{
+			UChessMoveRule* Rule = *RulePtr;
+			if (!Rule) continue; 
 
-				if (bFound)
+			// Get location of enemy
+			FBoardCoord EnemyPos = Board->FindPieceCoord(Enemy.PieceId);
+			if (EnemyPos.IsValid())
+			{
+				FChessMoveList Moves;
+				Rule->Generate(Board, EnemyPos, Enemy, Moves);
+				for (const FChessMove& Move : Moves)
 				{
-					TArray<FChessMove> Moves;
-					Rule->GenerateMoves(Board, EnemyPos, Pair.Value, Moves);
-					for (const FChessMove& Move : Moves)
+					if (Move.To == Square)
 					{
-						if (Move.To == KingPos)
-						{
-							return true;
-						}
+						return true;
 					}
 				}
 			}
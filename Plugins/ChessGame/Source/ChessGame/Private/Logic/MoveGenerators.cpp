@@ -1,6 +1,7 @@
 #include "Logic/MoveGenerators.h"
+#include "Logic/ChessAttackTables.h"
 
-void UMoveGeneratorBase::AddMove(TArray<FChessMove>& OutMoves, FBoardCoord From, FBoardCoord To, const FPieceInstance& MovingPiece, int32 CapturedPieceId) const
+void UMoveGeneratorBase::AddMove(FChessMoveList& OutMoves, FBoardCoord From, FBoardCoord To, const FPieceInstance& MovingPiece, int32 CapturedPieceId) const
 {
 	FChessMove Move;
 	Move.From = From;
@@ -13,96 +14,54 @@ void UMoveGeneratorBase::AddMove(TArray<FChessMove>& OutMoves, FBoardCoord From,
 
 bool UMoveGeneratorBase::IsSameColor(const UChessBoardState* Board, FBoardCoord Coord, EPieceColor Color) const
 {
-	if (!Coord.IsValid()) return false;
-	int32 PieceId = Board->GetPieceIdAt(Coord);
-	if (PieceId == -1) return false;
-	
-	const FPieceInstance* Piece = Board->Pieces.Find(PieceId);
-	return Piece && Piece->Color == Color;
+	return Board->IsSquareColor(Coord, Color);
 }
 
 bool UMoveGeneratorBase::IsEnemy(const UChessBoardState* Board, FBoardCoord Coord, EPieceColor Color) const
 {
-	if (!Coord.IsValid()) return false;
-	int32 PieceId = Board->GetPieceIdAt(Coord);
-	if (PieceId == -1) return false;
-
-	const FPieceInstance* Piece = Board->Pieces.Find(PieceId);
-	return Piece && Piece->Color != Color;
+	return Board->IsSquareColor(Coord, Color == EPieceColor::White ? EPieceColor::Black : EPieceColor::White);
 }
 
 bool UMoveGeneratorBase::IsEmpty(const UChessBoardState* Board, FBoardCoord Coord) const
 {
-	if (!Coord.IsValid()) return false;
-	return Board->GetPieceIdAt(Coord) == -1;
+	return Board->IsSquareEmpty(Coord);
 }
 
-void UMoveGenerator_Sliding::GeneratePseudoMoves(const UChessBoardState* Board, FBoardCoord From, const FPieceInstance& Piece, TArray<FChessMove>& OutMoves) const
+void UMoveGenerator_Sliding::GeneratePseudoMoves(const UChessBoardState* Board, FBoardCoord From, const FPieceInstance& Piece, FChessMoveList& OutMoves) const
 {
-	TArray<FBoardCoord> Directions;
+	// One table lookup per slider kind; the blocker is included in the attack set, own pieces are masked out
+	const int32 FromIndex = From.ToIndex();
+	const uint64 Occupied = Board->GetOccupancy();
+
+	uint64 Targets = 0;
 	if (bOrthogonal)
 	{
-		Directions.Add(FBoardCoord(1, 0));
-		Directions.Add(FBoardCoord(-1, 0));
-		Directions.Add(FBoardCoord(0, 1));
-		Directions.Add(FBoardCoord(0, -1));
+		Targets |= FChessAttackTables::RookAttacks(FromIndex, Occupied);
 	}
 	if (bDiagonal)
 	{
-		Directions.Add(FBoardCoord(1, 1));
-		Directions.Add(FBoardCoord(1, -1));
-		Directions.Add(FBoardCoord(-1, 1));
-		Directions.Add(FBoardCoord(-1, -1));
+		Targets |= FChessAttackTables::BishopAttacks(FromIndex, Occupied);
 	}
+	Targets &= ~Board->GetColorOccupancy(Piece.Color);
 
-	for (const FBoardCoord& Dir : Directions)
+	while (Targets)
 	{
-		for (int32 i = 1; i < 8; ++i)
-		{
-			FBoardCoord Target(From.File + Dir.File * i, From.Rank + Dir.Rank * i);
-			if (!Target.IsValid()) break;
-
-			if (IsEmpty(Board, Target))
-			{
-				AddMove(OutMoves, From, Target, Piece);
-			}
-			else
-			{
-				if (IsEnemy(Board, Target, Piece.Color))
-				{
-					AddMove(OutMoves, From, Target, Piece, Board->GetPieceIdAt(Target));
-				}
-				break; // Blocked
-			}
-		}
+		const int32 TargetIndex = ChessBitboard::PopLsb(Targets);
+		AddMove(OutMoves, From, FBoardCoord::FromIndex(TargetIndex), Piece, Board->Squares[TargetIndex]);
 	}
 }
 
-void UMoveGenerator_Knight::GeneratePseudoMoves(const UChessBoardState* Board, FBoardCoord From, const FPieceInstance& Piece, TArray<FChessMove>& OutMoves) const
+void UMoveGenerator_Knight::GeneratePseudoMoves(const UChessBoardState* Board, FBoardCoord From, const FPieceInstance& Piece, FChessMoveList& OutMoves) const
 {
-	TArray<FBoardCoord> Offsets = {
-		{1, 2}, {1, -2}, {-1, 2}, {-1, -2},
-		{2, 1}, {2, -1}, {-2, 1}, {-2, -1}
-	};
-
-	for (const FBoardCoord& Offset : Offsets)
+	uint64 Targets = FChessAttackTables::KnightAttacks(From.ToIndex()) & ~Board->GetColorOccupancy(Piece.Color);
+	while (Targets)
 	{
-		FBoardCoord Target(From.File + Offset.File, From.Rank + Offset.Rank);
-		if (Target.IsValid())
-		{
-			if (IsEmpty(Board, Target))
-			{
-				AddMove(OutMoves, From, Target, Piece);
-			}
-			else if (IsEnemy(Board, Target, Piece.Color))
-			{
-				AddMove(OutMoves, From, Target, Piece, Board->GetPieceIdAt(Target));
-			}
-		}
+		const int32 TargetIndex = ChessBitboard::PopLsb(Targets);
+		AddMove(OutMoves, From, FBoardCoord::FromIndex(TargetIndex), Piece, Board->Squares[TargetIndex]);
 	}
 }
 
-void UMoveGenerator_Pawn::GeneratePseudoMoves(const UChessBoardState* Board, FBoardCoord From, const FPieceInstance& Piece, TArray<FChessMove>& OutMoves) const
+void UMoveGenerator_Pawn::GeneratePseudoMoves(const UChessBoardState* Board, FBoardCoord From, const FPieceInstance& Piece, FChessMoveList& OutMoves) const
 {
 	int32 Direction = (Piece.Color == EPieceColor::White) ? 1 : -1;
 	int32 StartRank = (Piece.Color == EPieceColor::White) ? 1 : 6;
@@ -115,8 +74,7 @@ void UMoveGenerator_Pawn::GeneratePseudoMoves(const UChessBoardState* Board, FBo
 		if (Forward1.Rank == PromoteRank)
 		{
 			// Promotion
-			TArray<EPieceType> PromoteTypes = { EPieceType::Queen, EPieceType::Rook, EPieceType::Bishop, EPieceType::Knight };
-			for (EPieceType PType : PromoteTypes)
+			for (EPieceType PType : ChessMoves::PromotionTypes)
 			{
 				FChessMove Move;
 				Move.From = From;
@@ -144,7 +102,7 @@ void UMoveGenerator_Pawn::GeneratePseudoMoves(const UChessBoardState* Board, FBo
 	}
 
 	// Captures
-	int32 CaptureFiles[] = { -1, 1 };
+	static constexpr int32 CaptureFiles[] = { -1, 1 };
 	for (int32 FileOffset : CaptureFiles)
 	{
 		FBoardCoord Target(From.File + FileOffset, From.Rank + Direction);
@@ -156,8 +114,7 @@ void UMoveGenerator_Pawn::GeneratePseudoMoves(const UChessBoardState* Board, FBo
 				if (Target.Rank == PromoteRank)
 				{
 					// Promotion Capture
-					TArray<EPieceType> PromoteTypes = { EPieceType::Queen, EPieceType::Rook, EPieceType::Bishop, EPieceType::Knight };
-					for (EPieceType PType : PromoteTypes)
+					for (EPieceType PType : ChessMoves::PromotionTypes)
 					{
 						FChessMove Move;
 						Move.From = From;
@@ -194,27 +151,14 @@ void UMoveGenerator_Pawn::GeneratePseudoMoves(const UChessBoardState* Board, FBo
 	}
 }
 
-void UMoveGenerator_King::GeneratePseudoMoves(const UChessBoardState* Board, FBoardCoord From, const FPieceInstance& Piece, TArray<FChessMove>& OutMoves) const
+void UMoveGenerator_King::GeneratePseudoMoves(const UChessBoardState* Board, FBoardCoord From, const FPieceInstance& Piece, FChessMoveList& OutMoves) const
 {
 	// Normal moves
-	for (int32 dx = -1; dx <= 1; ++dx)
+	uint64 Targets = FChessAttackTables::KingAttacks(From.ToIndex()) & ~Board->GetColorOccupancy(Piece.Color);
+	while (Targets)
 	{
-		for (int32 dy = -1; dy <= 1; ++dy)
-		{
-			if (dx == 0 && dy == 0) continue;
-			FBoardCoord Target(From.File + dx, From.Rank + dy);
-			if (Target.IsValid())
-			{
-				if (IsEmpty(Board, Target))
-				{
-					AddMove(OutMoves, From, Target, Piece);
-				}
-				else if (IsEnemy(Board, Target, Piece.Color))
-				{
-					AddMove(OutMoves, From, Target, Piece, Board->GetPieceIdAt(Target));
-				}
-			}
-		}
+		const int32 TargetIndex = ChessBitboard::PopLsb(Targets);
+		AddMove(OutMoves, From, FBoardCoord::FromIndex(TargetIndex), Piece, Board->Squares[TargetIndex]);
 	}
 
 	// Castling
@@ -229,7 +173,7 @@ void UMoveGenerator_King::GeneratePseudoMoves(const UChessBoardState* Board, FBo
 		int32 RookId = Board->GetPieceIdAt(RookCoord);
 		if (RookId != -1)
 		{
-			const FPieceInstance* Rook = Board->Pieces.Find(RookId);
+			const FPieceInstance* Rook = Board->GetPiece(RookId);
 			if (Rook && Rook->Type == EPieceType::Rook && Rook->Color == Piece.Color && !Rook->bHasMoved)
 			{
 				if (IsEmpty(Board, FBoardCoord(5, Rank)) && IsEmpty(Board, FBoardCoord(6, Rank)))
@@ -250,7 +194,7 @@ void UMoveGenerator_King::GeneratePseudoMoves(const UChessBoardState* Board, FBo
 		RookId = Board->GetPieceIdAt(RookCoord);
 		if (RookId != -1)
 		{
-			const FPieceInstance* Rook = Board->Pieces.Find(RookId);
+			const FPieceInstance* Rook = Board->GetPiece(RookId);
 			if (Rook && Rook->Type == EPieceType::Rook && Rook->Color == Piece.Color && !Rook->bHasMoved)
 			{
 				if (IsEmpty(Board, FBoardCoord(1, Rank)) && IsEmpty(Board, FBoardCoord(2, Rank)) && IsEmpty(Board, FBoardCoord(3, Rank)))
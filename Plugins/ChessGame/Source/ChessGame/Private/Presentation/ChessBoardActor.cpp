@@ -84,6 +84,7 @@ void AChessBoardActor::BeginPlay()
 	// Initialize Model
 	GameModel = NewObject<UChessGameModel>(this);
 	GameModel->InitMode = InitMode; // Pass configuration
+	GameModel->InitFEN = InitFEN;
 	GameModel->InitializeGame();
 	UE_LOG(LogTemp, Warning, TEXT("GameModel Initialized. InitMode: %d"), (int32)InitMode);
 
@@ -238,7 +239,7 @@ void AChessBoardActor::HandleSquareClicked(FBoardCoord Coord)
 			{
 				if (AChessPlayerController* ChessPC = Cast<AChessPlayerController>(LocalPC))
 				{
-					ChessPC->Server_SubmitMove(this, TargetMove);
+					ChessPC->Server_SubmitMove(this, FChessPackedMove::FromMove(TargetMove));
 				}
 			}
 			
@@ -297,20 +298,17 @@ void AChessBoardActor::SyncVisuals()
 		return;
 	}
 
-	int32 Count = GameModel->BoardState->Pieces.Num();
+	int32 Count = GameModel->BoardState->GetNumPieces();
 	UE_LOG(LogTemp, Warning, TEXT("SyncVisuals: Found %d pieces in BoardState"), Count);
 
 	// Spawn new
-	for (const auto& Pair : GameModel->BoardState->Pieces)
+	for (uint64 Ids = GameModel->BoardState->GetPieceIds(); Ids; )
 	{
-		// Find Coord
-		for (int32 i = 0; i < 64; ++i)
+		const FPieceInstance& Piece = *GameModel->BoardState->GetPiece(ChessBitboard::PopLsb(Ids));
+		const FBoardCoord Coord = GameModel->BoardState->FindPieceCoord(Piece.PieceId);
+		if (Coord.IsValid())
 		{
-			if (GameModel->BoardState->Squares[i] == Pair.Value.PieceId)
-			{
-				SpawnPieceActor(Pair.Value.PieceId, Pair.Value.Type, Pair.Value.Color, FBoardCoord::FromIndex(i));
-				break;
-			}
+			SpawnPieceActor(Piece.PieceId, Piece.Type, Piece.Color, Coord);
 		}
 	}
 }
@@ -359,7 +357,7 @@ void AChessBoardActor::SpawnPieceActor(int32 PieceId, EPieceType Type, EPieceCol
 			NewPiece->Init(PieceId, Type, Color);
 			
 			// Setup Visuals
-			const FPieceInstance* Piece = GameModel->BoardState->Pieces.Find(PieceId);
+			const FPieceInstance* Piece = GameModel->BoardState->GetPiece(PieceId);
 			if (Piece)
 			{
 				UpdatePieceVisuals(*Piece, NewPiece);
@@ -424,11 +422,12 @@ void AChessBoardActor::OnMoveApplied(const FChessMove& Move)
 	// Refresh Visuals for Turn Change (Hot Seat Debugging)
 	if (GameModel && GameModel->BoardState)
 	{
-		for (auto& Pair : GameModel->BoardState->Pieces)
+		for (uint64 Ids = GameModel->BoardState->GetPieceIds(); Ids; )
 		{
-			if (AChessPieceActor** AP = PieceActors.Find(Pair.Key))
+			const int32 PieceId = ChessBitboard::PopLsb(Ids);
+			if (AChessPieceActor** AP = PieceActors.Find(PieceId))
 			{
-				if (*AP) UpdatePieceVisuals(Pair.Value, *AP);
+				if (*AP) UpdatePieceVisuals(*GameModel->BoardState->GetPiece(PieceId), *AP);
 			}
 		}
 
@@ -540,7 +539,22 @@ void AChessBoardActor::OnGameEnded(bool bIsDraw, EPieceColor Winner)
 	FString Message;
 	if (bIsDraw)
 	{
-		Message = TEXT("GAME OVER: Stalemate (Draw)");
+		const EChessGameEndReason Reason = (GameModel && GameModel->BoardState) ? GameModel->BoardState->GameEndReason : EChessGameEndReason::Stalemate;
+		switch (Reason)
+		{
+		case EChessGameEndReason::ThreefoldRepetition:
+			Message = TEXT("GAME OVER: Threefold Repetition (Draw)");
+			break;
+		case EChessGameEndReason::FiftyMoveRule:
+			Message = TEXT("GAME OVER: Fifty-Move Rule (Draw)");
+			break;
+		case EChessGameEndReason::InsufficientMaterial:
+			Message = TEXT("GAME OVER: Insufficient Material (Draw)");
+			break;
+		default:
+			Message = TEXT("GAME OVER: Stalemate (Draw)");
+			break;
+		}
 	}
 	else
 	{
@@ -583,7 +597,7 @@ void AChessBoardActor::OnPieceMaskChanged(int32 PieceId, EPieceType NewMask)
 {
 	if (!GameModel || !GameModel->BoardState) return;
 
-	if (FPieceInstance* Piece = GameModel->BoardState->Pieces.Find(PieceId))
+	if (const FPieceInstance* Piece = GameModel->BoardState->GetPiece(PieceId))
 	{
 		// Find Actor
 		if (AChessPieceActor** ActorPtr = PieceActors.Find(PieceId))
@@ -600,11 +614,11 @@ void AChessBoardActor::OnPieceMaskChanged(int32 PieceId, EPieceType NewMask)
 	}
 }
 
-void AChessBoardActor::ProcessMove(FChessMove Move)
+void AChessBoardActor::ProcessMove(FChessPackedMove Move)
 {
 	if (!HasAuthority()) return;
 
-	if (GameModel && GameModel->TryApplyMove(Move))
+	if (GameModel && GameModel->TryApplyMove(Move.ToMove(GameModel->BoardState)))
 	{
 		// Update Replicated State for late joiners
 		ReplicatedState = GameModel->BoardState->ToStruct();
@@ -614,13 +628,13 @@ void AChessBoardActor::ProcessMove(FChessMove Move)
 	}
 }
 
-void AChessBoardActor::Multicast_BroadcastMove_Implementation(FChessMove Move)
+void AChessBoardActor::Multicast_BroadcastMove_Implementation(FChessPackedMove Move)
 {
 	// On Server, GameModel is already updated by TryApplyMove in Server_TryMove
 	// On Client, we need to apply it
 	if (!HasAuthority())
 	{
-		GameModel->TryApplyMove(Move);
+		GameModel->TryApplyMove(Move.ToMove(GameModel->BoardState));
 	}
 
 	// Visuals are updated via OnMoveApplied event which GameModel broadcasts
@@ -684,10 +698,9 @@ void AChessBoardActor::Multicast_SetPieceMask_Implementation(int32 PieceId, EPie
 
 void AChessBoardActor::Multicast_RemovePiece_Implementation(int32 PieceId)
 {
-	if (GameModel && GameModel->BoardState)
+	if (GameModel)
 	{
-		GameModel->BoardState->RemovePiece(PieceId);
-		GameModel->OnPieceCaptured.Broadcast(PieceId);
+		GameModel->RemovePiece(PieceId);
 	}
 
 	// Update replicated state on server
@@ -780,11 +793,12 @@ void AChessBoardActor::RefreshPieceVisuals()
 {
 	if (GameModel && GameModel->BoardState)
 	{
-		for (auto& Pair : GameModel->BoardState->Pieces)
+		for (uint64 Ids = GameModel->BoardState->GetPieceIds(); Ids; )
 		{
-			if (AChessPieceActor** AP = PieceActors.Find(Pair.Key))
+			const int32 PieceId = ChessBitboard::PopLsb(Ids);
+			if (AChessPieceActor** AP = PieceActors.Find(PieceId))
 			{
-				if (*AP) UpdatePieceVisuals(Pair.Value, *AP);
+				if (*AP) UpdatePieceVisuals(*GameModel->BoardState->GetPiece(PieceId), *AP);
 			}
 		}
 	}
@@ -124,16 +124,10 @@ void AChessPieceActor::Init(int32 InPieceId, EPieceType InType, EPieceColor InCo
 	Type = InType;
 	Color = InColor;
 
-	// Spawn Rule if class is set
+	// Create Rule if class is set
 	if (MoveRuleClass)
 	{
-		FActorSpawnParameters Params;
-		Params.Owner = this;
-		MoveRuleInstance = GetWorld()->SpawnActor<AChessMoveRule>(MoveRuleClass, Params);
-		if (MoveRuleInstance)
-		{
-			MoveRuleInstance->AttachToActor(this, FAttachmentTransformRules::KeepRelativeTransform);
-		}
+		MoveRuleInstance = NewObject<UChessMoveRule>(this, MoveRuleClass);
 	}
 
 	OnInitialized(PieceId, Type, Color);
@@ -146,19 +140,8 @@ void AChessPieceActor::UpdateLegalMoves(const UChessBoardState* Board)
 	if (MoveRuleInstance && Board)
 	{
 		// ... existing logic ...
-		FBoardCoord MyCoord;
-		bool bFound = false;
-		for (int32 i = 0; i < 64; ++i)
-		{
-			if (Board->Squares[i] == PieceId)
-			{
-				MyCoord = FBoardCoord::FromIndex(i);
-				bFound = true;
-				break;
-			}
-		}
-
-		if (bFound)
+		FBoardCoord MyCoord = Board->FindPieceCoord(PieceId);
+		if (MyCoord.IsValid())
 		{
 			FPieceInstance MyInstance(PieceId, Type, Color);
 			if (const FPieceInstance* RealInstance = Board->GetPiece(PieceId))
@@ -166,7 +149,9 @@ void AChessPieceActor::UpdateLegalMoves(const UChessBoardState* Board)
 				MyInstance = *RealInstance;
 			}
 			
-			MoveRuleInstance->GenerateMoves(Board, MyCoord, MyInstance, CachedMoves);
+			FChessMoveList Moves;
+			MoveRuleInstance->Generate(Board, MyCoord, MyInstance, Moves);
+			CachedMoves.Append(Moves);
 		}
 	}
 }
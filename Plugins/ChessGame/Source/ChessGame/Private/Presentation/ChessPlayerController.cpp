@@ -275,12 +275,12 @@ bool AChessPlayerController::HasAssignedColor() const
 	return false;
 }
 
-bool AChessPlayerController::Server_SubmitMove_Validate(AChessBoardActor* Board, FChessMove Move)
+bool AChessPlayerController::Server_SubmitMove_Validate(AChessBoardActor* Board, FChessPackedMove Move)
 {
 	return true;
 }
 
-void AChessPlayerController::Server_SubmitMove_Implementation(AChessBoardActor* Board, FChessMove Move)
+void AChessPlayerController::Server_SubmitMove_Implementation(AChessBoardActor* Board, FChessPackedMove Move)
 {
 	if (Board)
 	{
@@ -0,0 +1,107 @@
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "HAL/PlatformProcess.h"
+#include "AI/ChessAIPlayerComponent.h"
+#include "Logic/ChessBoardState.h"
+#include "Logic/ChessGameModel.h"
+
+namespace
+{
+	/** Runs game-thread work queued by finished searches until the component goes idle or Timeout passes. */
+	void WaitWhileThinking(UChessAIPlayerComponent* AI, double Timeout)
+	{
+		const double Deadline = FPlatformTime::Seconds() + Timeout;
+		while (AI->IsThinking() && FPlatformTime::Seconds() < Deadline)
+		{
+			FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+			FPlatformProcess::Sleep(0.001f);
+		}
+	}
+
+	UChessGameModel* MakeModel(const TCHAR* FEN)
+	{
+		UChessGameModel* Model = NewObject<UChessGameModel>();
+		Model->InitMode = EChessInitMode::FromFEN;
+		Model->InitFEN = FEN;
+		Model->InitializeGame();
+		return Model;
+	}
+
+	UChessAIPlayerComponent* MakeAI(EPieceColor Color, float SearchTimeSeconds)
+	{
+		UChessAIPlayerComponent* AI = NewObject<UChessAIPlayerComponent>();
+		AI->AIColor = Color;
+		AI->SearchTimeSeconds = SearchTimeSeconds;
+		AI->SearchThreads = 1;
+		AI->bRespectMasks = false;
+		return AI;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChessAIPlayerComponentTest, "ChessGame.AI.PlayerComponent", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FChessAIPlayerComponentTest::RunTest(const FString& Parameters)
+{
+	const TCHAR* StartFEN = TEXT("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+
+	// Starting on our turn launches a search and returns straight away, long before the budget is spent
+	{
+		UChessGameModel* Model = MakeModel(StartFEN);
+		UChessAIPlayerComponent* AI = MakeAI(EPieceColor::White, 30.0f);
+
+		const double Start = FPlatformTime::Seconds();
+		AI->PlayOn(Model);
+		TestTrue(TEXT("Thinking after PlayOn"), AI->IsThinking());
+		TestTrue(TEXT("PlayOn does not wait for the search"), FPlatformTime::Seconds() - Start < 5.0);
+		TestEqual(TEXT("No move made yet"), Model->BoardState->SideToMove, EPieceColor::White);
+
+		// Someone else moving for us makes the search pointless
+		TestTrue(TEXT("e2-e4 applied"), Model->TryApplyMove(FChessPackedMove::Make(12, 28).ToMove(Model->BoardState)));
+		TestFalse(TEXT("Turn change cancels the search"), AI->IsThinking());
+
+		// Our turn again, then the game ends from outside (resignation, clock)
+		TestTrue(TEXT("e7-e5 applied"), Model->TryApplyMove(FChessPackedMove::Make(52, 36).ToMove(Model->BoardState)));
+		TestTrue(TEXT("Thinking on the next turn"), AI->IsThinking());
+		Model->OnGameEnded.Broadcast(false, EPieceColor::Black);
+		TestFalse(TEXT("Game end cancels the search"), AI->IsThinking());
+
+		// The cancelled searches finish on their own and their moves are dropped
+		FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+		TestEqual(TEXT("Cancelled searches play nothing"), Model->GetMoveLog().Num(), 2);
+		AI->StopPlaying();
+	}
+
+	// A card effect mid-search changes the position without passing the turn: the search is started again
+	{
+		// Qh5xf7 mates at once, but the queen is about to be taken off the board
+		UChessGameModel* Model = MakeModel(TEXT("r1bqkb1r/pppp1ppp/2n2n2/4p2Q/2B1P3/8/PPPP1PPP/RNB1K1NR w KQkq - 4 4"));
+		UChessAIPlayerComponent* AI = MakeAI(EPieceColor::White, 0.2f);
+		AI->PlayOn(Model);
+		TestTrue(TEXT("Thinking about the mate"), AI->IsThinking());
+
+		const int32 QueenId = Model->BoardState->GetPieceIdAt(FBoardCoord(7, 4));
+		Model->RemovePiece(QueenId);
+
+		WaitWhileThinking(AI, 10.0);
+		TestFalse(TEXT("Restarted search finishes"), AI->IsThinking());
+		TestEqual(TEXT("A move from the new position was played"), Model->GetMoveLog().Num(), 1);
+		TestEqual(TEXT("Turn passed to Black"), Model->BoardState->SideToMove, EPieceColor::Black);
+		TestFalse(TEXT("The removed queen stays gone"), Model->BoardState->HasPiece(QueenId));
+		AI->StopPlaying();
+	}
+
+	// Being mated passes the turn to us, but the game is already over by then: no search starts
+	{
+		UChessGameModel* Model = MakeModel(TEXT("r1bqkb1r/pppp1ppp/2n2n2/4p2Q/2B1P3/8/PPPP1PPP/RNB1K1NR w KQkq - 4 4"));
+		UChessAIPlayerComponent* AI = MakeAI(EPieceColor::Black, 30.0f);
+		AI->PlayOn(Model);
+		TestFalse(TEXT("Not our turn yet"), AI->IsThinking());
+
+		TestTrue(TEXT("Qxf7# applied"), Model->TryApplyMove(FChessPackedMove::Make(39, 53).ToMove(Model->BoardState)));
+		TestTrue(TEXT("Mate ends the game"), Model->BoardState->bIsGameOver);
+		TestFalse(TEXT("No search on a mated position"), AI->IsThinking());
+		AI->StopPlaying();
+	}
+	return true;
+}
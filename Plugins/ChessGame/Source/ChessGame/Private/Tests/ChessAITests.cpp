@@ -0,0 +1,439 @@
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "AI/ChessISMCTS.h"
+#include "AI/ChessMovePicker.h"
+#include "AI/ChessParallelSearch.h"
+#include "AI/ChessSearch.h"
+#include "AI/ChessStaticExchange.h"
+#include "AI/ChessTranspositionTable.h"
+#include "Logic/ChessBoardState.h"
+#include "Logic/ChessLegalMoveGenerator.h"
+#include "Logic/ChessMaskBelief.h"
+
+namespace
+{
+	/** True if Move is among the side to move's legal moves. */
+	bool IsLegalMove(const UChessBoardState* Board, FChessPackedMove Move)
+	{
+		FChessCheckInfo Info;
+		if (!Info.Init(Board, Board->SideToMove))
+		{
+			return false;
+		}
+		FChessPackedMoveList Moves;
+		FChessLegalMoveGenerator::GenerateAllMoves(Board, Info, Moves);
+		for (const FChessPackedMove Legal : Moves)
+		{
+			if (Legal == Move)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/** Depth-limited search so results do not depend on machine speed. */
+	FChessSearchLimits FixedDepth(int32 Depth)
+	{
+		FChessSearchLimits Limits;
+		Limits.MaxDepth = Depth;
+		Limits.MaxSeconds = 0.0;
+		return Limits;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChessSearchMateInOneTest, "ChessGame.AI.MateInOne", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FChessSearchMateInOneTest::RunTest(const FString& Parameters)
+{
+	// Back-rank mate: Re1-e8
+	UChessBoardState* Board = NewObject<UChessBoardState>();
+	TestTrue(TEXT("Position parsed"), Board->LoadFromFEN(TEXT("6k1/5ppp/8/8/8/8/8/4R1K1 w - - 0 1")));
+
+	const uint64 HashBefore = Board->GetHash();
+	FChessSearch Search;
+	const FChessSearchResult Result = Search.Search(Board, FixedDepth(4));
+
+	TestEqual(TEXT("Plays Re8"), Result.BestMove, FChessPackedMove::Make(4, 60));
+	TestEqual(TEXT("Scores mate in one ply"), Result.Score, ChessSearch::MateScore - 1);
+	TestEqual(TEXT("Board restored"), Board->GetHash(), HashBefore);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChessSearchWinsMaterialTest, "ChessGame.AI.WinsMaterial", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FChessSearchWinsMaterialTest::RunTest(const FString& Parameters)
+{
+	// The queen on d5 is en prise to the rook on d2 and nothing recaptures
+	UChessBoardState* Board = NewObject<UChessBoardState>();
+	TestTrue(TEXT("Position parsed"), Board->LoadFromFEN(TEXT("4k3/8/8/3q4/8/8/3R4/4K3 w - - 0 1")));
+
+	FChessSearch Search;
+	const FChessSearchResult Result = Search.Search(Board, FixedDepth(3));
+
+	TestEqual(TEXT("Plays Rxd5"), Result.BestMove, FChessPackedMove::Make(11, 35));
+	TestTrue(TEXT("Comes out ahead"), Result.Score > 0);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChessSearchLimitsTest, "ChessGame.AI.SearchLimits", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FChessSearchLimitsTest::RunTest(const FString& Parameters)
+{
+	UChessBoardState* Board = NewObject<UChessBoardState>();
+	TestTrue(TEXT("Position parsed"), Board->LoadFromFEN(TEXT("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1")));
+	const uint64 HashBefore = Board->GetHash();
+
+	// The node budget is polled in batches, so allow one batch of overshoot
+	FChessSearchLimits Limits;
+	Limits.MaxSeconds = 0.0;
+	Limits.MaxNodes = 5000;
+	FChessSearch Search;
+	FChessSearchResult Result = Search.Search(Board, Limits);
+	TestTrue(TEXT("Node budget respected"), Result.Nodes <= Limits.MaxNodes + 1024);
+	TestTrue(TEXT("Budgeted search returns a legal move"), IsLegalMove(Board, Result.BestMove));
+	TestEqual(TEXT("Board restored after stopping"), Board->GetHash(), HashBefore);
+
+	// A search cancelled before it starts still has a legal move to offer
+	std::atomic<bool> bStop{ true };
+	Limits.MaxNodes = 0;
+	Result = Search.Search(Board, Limits, &bStop);
+	TestEqual(TEXT("No iteration completed"), Result.Depth, 0);
+	TestTrue(TEXT("Cancelled search returns a legal move"), IsLegalMove(Board, Result.BestMove));
+	TestEqual(TEXT("Board restored after cancelling"), Board->GetHash(), HashBefore);
+
+	// Checkmated side has nothing to play
+	TestTrue(TEXT("Mate parsed"), Board->LoadFromFEN(TEXT("rnb1kbnr/pppp1ppp/8/4p3/6Pq/5P2/PPPPP2P/RNBQKBNR w KQkq - 1 3")));
+	Result = Search.Search(Board, FixedDepth(2));
+	TestTrue(TEXT("No move when mated"), Result.BestMove.IsNull());
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChessSearchGameHistoryTest, "ChessGame.AI.GameHistory", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FChessSearchGameHistoryTest::RunTest(const FString& Parameters)
+{
+	// White is a queen down; Ke1-f1 Qd8-d7 Kf1-e1 Qd7-d8 has already been played once
+	UChessBoardState* Board = NewObject<UChessBoardState>();
+	TestTrue(TEXT("Position parsed"), Board->LoadFromFEN(TEXT("3qk3/8/8/8/8/8/8/4K3 w - - 0 1")));
+
+	TArray<uint64> GameHistory;
+	FMoveUndoRecord Undo;
+	for (const FChessPackedMove Move : { FChessPackedMove::Make(4, 5), FChessPackedMove::Make(59, 51), FChessPackedMove::Make(5, 4), FChessPackedMove::Make(51, 59) })
+	{
+		GameHistory.Add(Board->GetHash());
+		Board->MakeMove(Move, Undo);
+	}
+	TestEqual(TEXT("Back at the start"), Board->GetHash(), GameHistory[0]);
+
+	// On its own the search only sees the lost material
+	FChessSearch Fresh;
+	FChessSearchResult Result = Fresh.Search(Board, FixedDepth(3));
+	TestTrue(TEXT("Losing without the game history"), Result.Score < -500);
+
+	// With the game behind it, Kf1 repeats the position reached after the first Kf1
+	FChessSearch Search;
+	Search.SetGameHistory(GameHistory);
+	Result = Search.Search(Board, FixedDepth(3));
+	TestEqual(TEXT("Plays Kf1 into the repetition"), Result.BestMove, FChessPackedMove::Make(4, 5));
+	TestEqual(TEXT("Scores the repetition as a draw"), Result.Score, 0);
+
+	// An irreversible move since then rules the old positions out
+	Board->HalfmoveClock = 0;
+	Result = Search.Search(Board, FixedDepth(3));
+	TestTrue(TEXT("Ignores history before the halfmove clock"), Result.Score < -500);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChessTranspositionTableTest, "ChessGame.AI.TranspositionTable", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FChessTranspositionTableTest::RunTest(const FString& Parameters)
+{
+	FChessTranspositionTable Table(1);
+	const uint64 Key = 0x9E3779B97F4A7C15ull;
+	const FChessPackedMove Move = FChessPackedMove::Make(12, 28);
+
+	FChessTTEntry Entry;
+	TestFalse(TEXT("Empty table misses"), Table.Probe(Key, 0, Entry));
+
+	Table.Store(Key, 3, -250, 6, EChessBound::Upper, Move);
+	TestTrue(TEXT("Stored entry hits"), Table.Probe(Key, 3, Entry));
+	TestEqual(TEXT("Move round-trips"), Entry.Move, Move);
+	TestEqual(TEXT("Score round-trips"), Entry.Score, -250);
+	TestEqual(TEXT("Depth round-trips"), Entry.Depth, 6);
+	TestTrue(TEXT("Bound round-trips"), Entry.Bound == EChessBound::Upper);
+
+	// Same bucket, different position: must not be served the other key's entry
+	TestFalse(TEXT("Colliding key misses"), Table.Probe(Key ^ (1ull << 63), 3, Entry));
+
+	// A mate found 5 plies below a node at ply 2 is still mate in 5 from a node at ply 7
+	Table.Store(Key, 2, ChessSearch::MateScore - 7, 4, EChessBound::Exact, Move);
+	TestTrue(TEXT("Mate entry hits"), Table.Probe(Key, 7, Entry));
+	TestEqual(TEXT("Mate distance kept relative to the node"), Entry.Score, ChessSearch::MateScore - 12);
+
+	// A fail-low without a move keeps the move already known for the position
+	Table.Store(Key, 0, 10, 8, EChessBound::Upper, FChessPackedMove());
+	TestTrue(TEXT("Fail-low entry hits"), Table.Probe(Key, 0, Entry));
+	TestEqual(TEXT("Earlier best move kept"), Entry.Move, Move);
+
+	// Fill the bucket with deep entries, then age them out: a shallow fresh entry must find room
+	const uint64 BucketMask = (Table.GetSizeBytes() / 64) - 1;
+	for (uint64 i = 1; i <= 4; ++i)
+	{
+		Table.Store(Key + i * (BucketMask + 1), 0, 0, 40, EChessBound::Exact, Move);
+	}
+	for (int32 i = 0; i < 8; ++i)
+	{
+		Table.NewSearch();
+	}
+	const uint64 FreshKey = Key + 9 * (BucketMask + 1);
+	Table.Store(FreshKey, 0, 0, 1, EChessBound::Exact, Move);
+	TestTrue(TEXT("Fresh entry replaces stale deep ones"), Table.Probe(FreshKey, 0, Entry));
+
+	Table.Clear();
+	TestFalse(TEXT("Cleared table misses"), Table.Probe(FreshKey, 0, Entry));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChessSearchTranspositionTest, "ChessGame.AI.SearchWithTable", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FChessSearchTranspositionTest::RunTest(const FString& Parameters)
+{
+	UChessBoardState* Board = NewObject<UChessBoardState>();
+	TestTrue(TEXT("Position parsed"), Board->LoadFromFEN(TEXT("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1")));
+	const uint64 HashBefore = Board->GetHash();
+
+	FChessSearch Plain;
+	const FChessSearchResult Without = Plain.Search(Board, FixedDepth(4));
+
+	FChessTranspositionTable Table(16);
+	FChessSearch Cached(&Table);
+	const FChessSearchResult With = Cached.Search(Board, FixedDepth(4));
+	AddInfo(FString::Printf(TEXT("Depth 4: %llu nodes without table, %llu with"), Without.Nodes, With.Nodes));
+
+	TestTrue(TEXT("Table saves nodes"), With.Nodes < Without.Nodes);
+	TestTrue(TEXT("Cached search returns a legal move"), IsLegalMove(Board, With.BestMove));
+	TestEqual(TEXT("Board restored"), Board->GetHash(), HashBefore);
+
+	// The next move's search reuses what the previous one learned
+	Table.NewSearch();
+	const FChessSearchResult Again = Cached.Search(Board, FixedDepth(4));
+	TestTrue(TEXT("Warm table saves more"), Again.Nodes < With.Nodes);
+	TestTrue(TEXT("Warm table returns a legal move"), IsLegalMove(Board, Again.BestMove));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChessMovePickerTest, "ChessGame.AI.MovePicker", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FChessMovePickerTest::RunTest(const FString& Parameters)
+{
+	// White can take the queen with the pawn or the knight, the rook with the knight, or play quietly
+	UChessBoardState* Board = NewObject<UChessBoardState>();
+	TestTrue(TEXT("Position parsed"), Board->LoadFromFEN(TEXT("4k3/8/8/1r1q4/4P3/2N5/8/4K3 w - - 0 1")));
+
+	FChessCheckInfo Info;
+	Info.Init(Board, Board->SideToMove);
+	FChessPackedMoveList Moves;
+	FChessLegalMoveGenerator::GenerateAllMoves(Board, Info, Moves);
+	const int32 NumLegal = Moves.Num();
+
+	const FChessPackedMove PawnTakesQueen = FChessPackedMove::Make(28, 35);
+	const FChessPackedMove KnightTakesQueen = FChessPackedMove::Make(18, 35);
+	const FChessPackedMove KingMove = FChessPackedMove::Make(4, 5);
+	const FChessPackedMove Killer = FChessPackedMove::Make(18, 1);
+	const FChessPackedMove HistoryMove = FChessPackedMove::Make(18, 24);
+
+	// Killers come straight from the table; history is learned from a cutoff
+	TUniquePtr<FChessSearchHeuristics> Heuristics = MakeUnique<FChessSearchHeuristics>();
+	Heuristics->Killers[3][0] = Killer;
+	Heuristics->UpdateQuietCutoff(EPieceColor::White, 3, 6, HistoryMove, &KingMove, 1);
+	TestTrue(TEXT("Cutoff move gains history"), Heuristics->GetHistory(EPieceColor::White, HistoryMove) > 0);
+	TestTrue(TEXT("Tried quiet loses history"), Heuristics->GetHistory(EPieceColor::White, KingMove) < 0);
+	TestEqual(TEXT("Cutoff move becomes the first killer"), Heuristics->Killers[3][0], HistoryMove);
+	TestEqual(TEXT("Previous killer moves down"), Heuristics->Killers[3][1], Killer);
+
+	FChessMovePicker Picker(Board, Moves, KingMove, *Heuristics, 3);
+	TArray<FChessPackedMove> Order;
+	FChessPackedMove Move;
+	while (Picker.Next(Move))
+	{
+		Order.Add(Move);
+	}
+
+	TestEqual(TEXT("Every move yielded once"), Order.Num(), NumLegal);
+	if (Order.Num() >= 6)
+	{
+		TestEqual(TEXT("Table move first"), Order[0], KingMove);
+		TestEqual(TEXT("Least valuable attacker takes the queen first"), Order[1], PawnTakesQueen);
+		TestEqual(TEXT("Then the more valuable attacker"), Order[2], KnightTakesQueen);
+		TestEqual(TEXT("Then the rook capture"), Order[3], FChessPackedMove::Make(18, 33));
+		TestEqual(TEXT("Killers lead the quiet moves"), Order[4], HistoryMove);
+		TestEqual(TEXT("Second killer follows"), Order[5], Killer);
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChessParallelSearchTest, "ChessGame.AI.ParallelSearch", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FChessParallelSearchTest::RunTest(const FString& Parameters)
+{
+	const TCHAR* FEN = TEXT("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+
+	TArray<UChessBoardState*> Boards;
+	for (int32 i = 0; i < 4; ++i)
+	{
+		UChessBoardState* Board = NewObject<UChessBoardState>();
+		TestTrue(TEXT("Position parsed"), Board->LoadFromFEN(FEN));
+		Boards.Add(Board);
+	}
+	const uint64 HashBefore = Boards[0]->GetHash();
+
+	FChessTranspositionTable Table(16);
+	FChessParallelSearch Search(Boards, &Table);
+	TestEqual(TEXT("One search per board"), Search.GetNumThreads(), 4);
+
+	const FChessSearchResult Result = Search.Search(FixedDepth(5));
+	AddInfo(FString::Printf(TEXT("Depth %d with 4 threads: %llu nodes in %.3fs"), Result.Depth, Result.Nodes, Result.Seconds));
+	TestEqual(TEXT("Main thread completes its depth"), Result.Depth, 5);
+	TestTrue(TEXT("Returns a legal move"), IsLegalMove(Boards[0], Result.BestMove));
+	for (UChessBoardState* Board : Boards)
+	{
+		TestEqual(TEXT("Every thread's board restored"), Board->GetHash(), HashBefore);
+	}
+
+	// A cancelled parallel search still answers and releases its helpers
+	std::atomic<bool> bStop{ true };
+	FChessSearchLimits Limits;
+	Limits.MaxSeconds = 0.0;
+	const FChessSearchResult Cancelled = Search.Search(Limits, &bStop);
+	TestTrue(TEXT("Cancelled search returns a legal move"), IsLegalMove(Boards[0], Cancelled.BestMove));
+
+	TestEqual(TEXT("Explicit thread count wins"), FChessParallelSearch::ResolveThreadCount(1), 1);
+	TestTrue(TEXT("Thread count is capped"), FChessParallelSearch::ResolveThreadCount(1000) <= ChessSearch::MaxThreads);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChessStaticExchangeTest, "ChessGame.AI.StaticExchange", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FChessStaticExchangeTest::RunTest(const FString& Parameters)
+{
+	struct FCase
+	{
+		const TCHAR* FEN;
+		int32 From;
+		int32 To;
+		int32 Expected;
+		const TCHAR* What;
+	};
+	const FCase Cases[] =
+	{
+		{ TEXT("1k1r4/1pp4p/p7/4p3/8/P5P1/1PP4P/2K1R3 w - - 0 1"), 4, 36, 100, TEXT("Undefended pawn") },
+		{ TEXT("1k1r3q/1ppn3p/p4b2/4p3/8/P2N2P1/1PP1R1BP/2K1Q3 w - - 0 1"), 19, 36, 100 - 320, TEXT("Knight for a pawn, x-rays on both sides") },
+		{ TEXT("4k3/8/3p4/4p3/8/8/8/4RK2 w - - 0 1"), 4, 36, 100 - 500, TEXT("Rook takes a defended pawn") },
+		{ TEXT("4k3/8/4p3/3p4/4P3/8/8/4K3 w - - 0 1"), 28, 35, 0, TEXT("Pawn trade") },
+		{ TEXT("4k3/8/8/4r3/8/8/4R3/4R1K1 w - - 0 1"), 12, 36, 500, TEXT("Backed-up rook wins an undefended rook") },
+		{ TEXT("3k4/8/8/8/8/8/8/3K4 w - - 0 1"), 3, 11, 0, TEXT("Quiet move") },
+	};
+
+	for (const FCase& Case : Cases)
+	{
+		UChessBoardState* Board = NewObject<UChessBoardState>();
+		TestTrue(FString::Printf(TEXT("%s parsed"), Case.What), Board->LoadFromFEN(Case.FEN));
+		TestEqual(Case.What, FChessStaticExchange::Evaluate(Board, FChessPackedMove::Make(Case.From, Case.To)), Case.Expected);
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChessQuiescenceTest, "ChessGame.AI.Quiescence", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FChessQuiescenceTest::RunTest(const FString& Parameters)
+{
+	// Qxd5 wins a pawn at depth 1 by static count, but the rook on d8 takes the queen back
+	UChessBoardState* Board = NewObject<UChessBoardState>();
+	TestTrue(TEXT("Position parsed"), Board->LoadFromFEN(TEXT("3rk3/8/8/3p4/8/8/8/3QK3 w - - 0 1")));
+
+	FChessSearch Search;
+	const FChessSearchResult Result = Search.Search(Board, FixedDepth(1));
+	TestNotEqual(TEXT("Does not grab the defended pawn"), Result.BestMove, FChessPackedMove::Make(3, 35));
+	TestTrue(TEXT("Sees it is a queen up, not a queen and pawn"), Result.Score < 900);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChessISMCTSTest, "ChessGame.AI.ISMCTS", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FChessISMCTSTest::RunTest(const FString& Parameters)
+{
+	// The queen on d5 hangs to the rook whatever the masked pieces on a7 and h7 turn out to be
+	const TCHAR* FEN = TEXT("4k3/n6p/8/3q4/8/8/3R4/4K3 w - - 0 1");
+
+	TArray<UChessBoardState*> Boards;
+	for (int32 i = 0; i < 4; ++i)
+	{
+		UChessBoardState* Board = NewObject<UChessBoardState>();
+		TestTrue(TEXT("Position parsed"), Board->LoadFromFEN(FEN));
+		Board->SetPieceMask(Board->GetPieceIdAt(FBoardCoord(0, 6)), EPieceType::Pawn);
+		Board->SetPieceMask(Board->GetPieceIdAt(FBoardCoord(7, 6)), EPieceType::Knight);
+		Boards.Add(Board);
+	}
+	const uint64 HashBefore = Boards[0]->GetHash();
+	const int32 EvalBefore = Boards[0]->GetEvalScore();
+
+	TestTrue(TEXT("White faces hidden pieces"), FChessISMCTS::HasHiddenPieces(Boards[0], EPieceColor::White));
+	TestFalse(TEXT("Black does not"), FChessISMCTS::HasHiddenPieces(Boards[0], EPieceColor::Black));
+
+	// Iteration-limited on one thread, so the result does not depend on machine speed
+	FChessSearchLimits Limits;
+	Limits.MaxSeconds = 0.0;
+	Limits.MaxNodes = 4000;
+	FChessISMCTS Single(MakeArrayView(Boards.GetData(), 1));
+	FChessSearchResult Result = Single.Search(Limits);
+	TestEqual(TEXT("Plays Rxd5"), Result.BestMove, FChessPackedMove::Make(11, 35));
+	TestTrue(TEXT("Comes out ahead"), Result.Score > 0);
+	TestEqual(TEXT("Iteration budget respected"), Result.Nodes, Limits.MaxNodes);
+	TestEqual(TEXT("Board restored"), Boards[0]->GetHash(), HashBefore);
+	TestEqual(TEXT("True types restored"), Boards[0]->GetEvalScore(), EvalBefore);
+
+	// Draws from a belief keep the same answer
+	FChessMaskBelief Belief;
+	Belief.Reset(Boards[0], EPieceColor::White);
+	Single.SetBelief(&Belief);
+	Result = Single.Search(Limits);
+	TestEqual(TEXT("Plays Rxd5 with a belief"), Result.BestMove, FChessPackedMove::Make(11, 35));
+	TestEqual(TEXT("Board restored after belief draws"), Boards[0]->GetEvalScore(), EvalBefore);
+
+	// Several threads sharing one tree, on a clock
+	FChessISMCTS Parallel(Boards);
+	TestEqual(TEXT("One worker per board"), Parallel.GetNumThreads(), 4);
+	Limits.MaxNodes = 0;
+	Limits.MaxSeconds = 0.2;
+	Result = Parallel.Search(Limits);
+	AddInfo(FString::Printf(TEXT("ISMCTS with 4 threads: %llu iterations in %.3fs"), Result.Nodes, Result.Seconds));
+	TestEqual(TEXT("Parallel search plays Rxd5"), Result.BestMove, FChessPackedMove::Make(11, 35));
+	TestTrue(TEXT("Stops close to the time limit"), Result.Seconds < 1.0);
+	for (UChessBoardState* Board : Boards)
+	{
+		TestEqual(TEXT("Every thread's board restored"), Board->GetHash(), HashBefore);
+		TestEqual(TEXT("Every thread's types restored"), Board->GetEvalScore(), EvalBefore);
+	}
+
+	// A cancelled search still answers
+	std::atomic<bool> bStop{ true };
+	Result = Parallel.Search(Limits, &bStop);
+	TestTrue(TEXT("Cancelled search returns a legal move"), IsLegalMove(Boards[0], Result.BestMove));
+
+	// With every black piece masked the king is shuffled too, but never onto d5 where the rook would have it in check
+	UChessBoardState* AllMasked = NewObject<UChessBoardState>();
+	TestTrue(TEXT("Position parsed"), AllMasked->LoadFromFEN(FEN));
+	for (const int32 Square : { 35, 48, 55, 60 })
+	{
+		AllMasked->SetPieceMask(AllMasked->Squares[Square], EPieceType::Knight);
+	}
+	const uint64 MaskedHashBefore = AllMasked->GetHash();
+	FChessISMCTS Masked(MakeArrayView(&AllMasked, 1));
+	Limits.MaxSeconds = 0.0;
+	Limits.MaxNodes = 4000;
+	Result = Masked.Search(Limits);
+	TestEqual(TEXT("Still plays Rxd5 with the king hidden"), Result.BestMove, FChessPackedMove::Make(11, 35));
+	TestEqual(TEXT("Board restored with the king hidden"), AllMasked->GetHash(), MaskedHashBefore);
+	return true;
+}
@@ -1,11 +1,34 @@
 #include "CoreMinimal.h"
 #include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "HAL/FileManager.h"
 #include "Logic/ChessData.h"
 #include "Logic/ChessBoardState.h"
 #include "Logic/ChessRuleSet.h"
 #include "Logic/ChessGameModel.h"
-#include "Engine/World.h"
-#include "Engine/Engine.h"
+#include "Logic/ChessAttackTables.h"
+#include "Logic/ChessEvaluation.h"
+#include "Logic/ChessNNUE.h"
+#include "Logic/ChessLegalMoveGenerator.h"
+#include "Logic/ChessMaskBelief.h"
+#include "Logic/ChessPackedMove.h"
+#include "Logic/ChessPerft.h"
+
+namespace
+{
+	/** The perft reference positions plus Kiwipete with masked pieces, for tests that check every line from each. */
+	TArray<FString> GetTestFENs()
+	{
+		TArray<FString> FENs;
+		for (const FChessPerftPosition& Position : FChessPerft::GetStandardPositions())
+		{
+			FENs.Add(Position.FEN);
+		}
+		FENs.Add(TEXT("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1 8/8/8/8/8/8/PPPq4/R3K3"));
+		return FENs;
+	}
+}
 
 IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChessGameCoordinateTest, "ChessGame.Logic.Coordinates", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
 
@@ -29,12 +52,8 @@ IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChessGameInitialSetupTest, "ChessGame.Logic.In
 
 bool FChessGameInitialSetupTest::RunTest(const FString& Parameters)
 {
-	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
-	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
-	WorldContext.SetCurrentWorld(World);
-
 	UChessRuleSet* RuleSet = NewObject<UChessRuleSet>();
-	RuleSet->Initialize(World);
+	RuleSet->Initialize();
 
 	UChessBoardState* Board = NewObject<UChessBoardState>();
 	RuleSet->SetupInitialBoardState(Board);
@@ -56,9 +75,6 @@ bool FChessGameInitialSetupTest::RunTest(const FString& Parameters)
 		TestEqual(TEXT("Is King"), Piece->Type, EPieceType::King);
 	}
 
-	GEngine->DestroyWorldContext(World);
-	World->DestroyWorld(false);
-
 	return true;
 }
 
@@ -66,13 +82,8 @@ IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChessGamePawnMoveTest, "ChessGame.Logic.PawnMo
 
 bool FChessGamePawnMoveTest::RunTest(const FString& Parameters)
 {
-	// Create Temp World for Actors
-	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
-	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
-	WorldContext.SetCurrentWorld(World);
-
 	UChessRuleSet* RuleSet = NewObject<UChessRuleSet>();
-	RuleSet->Initialize(World);
+	RuleSet->Initialize();
 	UChessBoardState* Board = NewObject<UChessBoardState>();
 	Board->InitializeEmpty();
 
@@ -100,9 +111,1195 @@ bool FChessGamePawnMoveTest::RunTest(const FString& Parameters)
 	TestTrue(TEXT("Found E4"), bFoundE4);
 	TestTrue(TEXT("Found Capture D3"), bFoundD3);
 
-	// Clean up
-	GEngine->DestroyWorldContext(World);
-	World->DestroyWorld(false);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChessGameBitboardSyncTest, "ChessGame.Logic.BitboardSync", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FChessGameBitboardSyncTest::RunTest(const FString& Parameters)
+{
+	UChessBoardState* Board = NewObject<UChessBoardState>();
+	Board->InitializeEmpty();
+
+	Board->AddPiece(0, EPieceType::Rook, EPieceColor::White, FBoardCoord(0, 0));
+	Board->AddPiece(1, EPieceType::Knight, EPieceColor::Black, FBoardCoord(1, 7));
+	TestEqual(TEXT("Occupancy after add"), Board->GetOccupancy(), ChessBitboard::SquareBit(0) | ChessBitboard::SquareBit(57));
+	TestEqual(TEXT("White rooks"), Board->GetPieceOccupancy(EPieceColor::White, EPieceType::Rook), ChessBitboard::SquareBit(0));
+
+	Board->MovePiece(0, FBoardCoord(0, 0), FBoardCoord(0, 4));
+	TestTrue(TEXT("A1 empty after move"), Board->IsSquareEmpty(FBoardCoord(0, 0)));
+	TestTrue(TEXT("A5 white after move"), Board->IsSquareColor(FBoardCoord(0, 4), EPieceColor::White));
+
+	Board->SetPieceMask(1, EPieceType::Pawn);
+	TestEqual(TEXT("Pawn mask set"), Board->GetMaskOccupancy(EPieceType::Pawn), ChessBitboard::SquareBit(57));
+
+	Board->RemovePiece(1);
+	TestEqual(TEXT("Black empty after remove"), Board->GetColorOccupancy(EPieceColor::Black), (uint64)0);
+	TestEqual(TEXT("Square cleared after remove"), Board->GetPieceIdAt(FBoardCoord(1, 7)), -1);
+
+	// Round trip through the replicated struct must rebuild identical sets
+	UChessBoardState* Copy = NewObject<UChessBoardState>();
+	Copy->FromStruct(Board->ToStruct());
+	TestEqual(TEXT("FromStruct occupancy"), Copy->GetOccupancy(), Board->GetOccupancy());
+	TestEqual(TEXT("FromStruct rooks"), Copy->GetTypeOccupancy(EPieceType::Rook), Board->GetTypeOccupancy(EPieceType::Rook));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChessGameSlidingAttackTest, "ChessGame.Logic.SlidingAttacks", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FChessGameSlidingAttackTest::RunTest(const FString& Parameters)
+{
+	FChessAttackTables::Initialize();
+
+	// Compare table lookups against a plain ray walk for pseudo-random occupancies
+	auto RayWalk = [](int32 Square, uint64 Occupied, bool bDiagonal) {
+		const int32 Dirs[2][4][2] = { { {1, 0}, {-1, 0}, {0, 1}, {0, -1} }, { {1, 1}, {1, -1}, {-1, 1}, {-1, -1} } };
+		uint64 Result = 0;
+		for (const auto& Dir : Dirs[bDiagonal ? 1 : 0])
+		{
+			for (int32 f = Square % 8 + Dir[0], r = Square / 8 + Dir[1]; f >= 0 && f < 8 && r >= 0 && r < 8; f += Dir[0], r += Dir[1])
+			{
+				Result |= ChessBitboard::SquareBit(r * 8 + f);
+				if (Occupied & ChessBitboard::SquareBit(r * 8 + f)) break;
+			}
+		}
+		return Result;
+	};
+
+	FRandomStream Random(1234);
+	for (int32 Iteration = 0; Iteration < 2000; ++Iteration)
+	{
+		const uint64 Occupied = ((uint64)Random.GetUnsignedInt() << 32 | Random.GetUnsignedInt()) & ((uint64)Random.GetUnsignedInt() << 32 | Random.GetUnsignedInt());
+		const int32 Square = Random.RandRange(0, 63);
+		if (FChessAttackTables::RookAttacks(Square, Occupied) != RayWalk(Square, Occupied, false)
+			|| FChessAttackTables::BishopAttacks(Square, Occupied) != RayWalk(Square, Occupied, true))
+		{
+			AddError(FString::Printf(TEXT("Slider attack mismatch on square %d"), Square));
+			return false;
+		}
+	}
+
+	TestEqual(TEXT("Between A1 H8"), FChessAttackTables::Between(0, 63), 0x0040201008040200ull);
+	TestEqual(TEXT("Between A1 B3 (unaligned)"), FChessAttackTables::Between(0, 17), (uint64)0);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChessGameMakeUnmakeTest, "ChessGame.Logic.MakeUnmake", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FChessGameMakeUnmakeTest::RunTest(const FString& Parameters)
+{
+	UChessRuleSet* RuleSet = NewObject<UChessRuleSet>();
+	RuleSet->Initialize();
+	UChessBoardState* Board = NewObject<UChessBoardState>();
+	Board->InitializeEmpty();
+
+	// Castling on both wings, an en passant capture and a capturing promotion are all available to White
+	Board->AddPiece(0, EPieceType::King, EPieceColor::White, FBoardCoord(4, 0));
+	Board->AddPiece(1, EPieceType::Rook, EPieceColor::White, FBoardCoord(0, 0));
+	Board->AddPiece(2, EPieceType::Rook, EPieceColor::White, FBoardCoord(7, 0));
+	Board->AddPiece(3, EPieceType::Pawn, EPieceColor::White, FBoardCoord(4, 4));
+	Board->AddPiece(4, EPieceType::Pawn, EPieceColor::White, FBoardCoord(1, 6));
+	Board->AddPiece(10, EPieceType::King, EPieceColor::Black, FBoardCoord(7, 7));
+	Board->AddPiece(11, EPieceType::Pawn, EPieceColor::Black, FBoardCoord(3, 6));
+	Board->AddPiece(12, EPieceType::Rook, EPieceColor::Black, FBoardCoord(0, 7));
+
+	// Black double step creates the en passant target
+	FChessMove DoubleStep;
+	DoubleStep.From = FBoardCoord(3, 6);
+	DoubleStep.To = FBoardCoord(3, 4);
+	DoubleStep.MovingPieceId = 11;
+	Board->SideToMove = EPieceColor::Black;
+	FMoveUndoRecord DoubleStepUndo;
+	Board->MakeMove(DoubleStep, DoubleStepUndo);
+	TestTrue(TEXT("En passant target set"), Board->bHasEnPassantTarget && Board->EnPassantTarget == FBoardCoord(3, 5));
+
+	const FChessBoardStateData Before = Board->ToStruct();
+	const FChessBitboards BitsBefore = Board->GetBitboards();
+	const uint64 HashBefore = Board->GetHash();
+
+	int32 NumCastles = 0, NumEnPassant = 0, NumPromotions = 0;
+	uint64 WhitePieces = Board->GetColorOccupancy(EPieceColor::White);
+	while (WhitePieces)
+	{
+		TArray<FChessMove> Moves;
+		RuleSet->GenerateLegalMoves(Board, Board->Squares[ChessBitboard::PopLsb(WhitePieces)], Moves);
+		for (const FChessMove& Move : Moves)
+		{
+			NumCastles += Move.SpecialType == ESpecialMoveType::Castling;
+			NumEnPassant += Move.SpecialType == ESpecialMoveType::EnPassant;
+			NumPromotions += Move.SpecialType == ESpecialMoveType::Promotion;
+
+			FMoveUndoRecord Undo;
+			Board->MakeMove(Move, Undo);
+			Board->UnmakeMove(Undo);
+
+			const FChessBoardStateData After = Board->ToStruct();
+			bool bSame = After.Squares == Before.Squares && After.SideToMove == Before.SideToMove
+				&& After.bHasEnPassantTarget == Before.bHasEnPassantTarget && After.EnPassantTarget == Before.EnPassantTarget
+				&& After.HalfmoveClock == Before.HalfmoveClock && After.FullmoveNumber == Before.FullmoveNumber
+				&& After.PiecesArray.Num() == Before.PiecesArray.Num()
+				&& FMemory::Memcmp(&BitsBefore, &Board->GetBitboards(), sizeof(FChessBitboards)) == 0
+				&& Board->GetHash() == HashBefore;
+			for (const FPieceInstance& Piece : Before.PiecesArray)
+			{
+				const FPieceInstance* Restored = Board->GetPiece(Piece.PieceId);
+				bSame &= Restored && Restored->Type == Piece.Type && Restored->bHasMoved == Piece.bHasMoved && Restored->MaskType == Piece.MaskType;
+			}
+			if (!bSame)
+			{
+				AddError(FString::Printf(TEXT("Unmake did not restore the board after %s -> %s"), *Move.From.ToString(), *Move.To.ToString()));
+			}
+		}
+	}
+
+	TestEqual(TEXT("Both castles generated"), NumCastles, 2);
+	TestEqual(TEXT("En passant generated"), NumEnPassant, 1);
+	TestEqual(TEXT("Promotions generated (push + capture)"), NumPromotions, 8);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChessGameSquareAttackedTest, "ChessGame.Logic.SquareAttacked", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FChessGameSquareAttackedTest::RunTest(const FString& Parameters)
+{
+	UChessRuleSet* RuleSet = NewObject<UChessRuleSet>();
+	RuleSet->Initialize();
+	UChessBoardState* Board = NewObject<UChessBoardState>();
+	Board->InitializeEmpty();
+
+	Board->AddPiece(0, EPieceType::King, EPieceColor::White, FBoardCoord(4, 0));
+	Board->AddPiece(1, EPieceType::Rook, EPieceColor::White, FBoardCoord(7, 0));
+	Board->AddPiece(2, EPieceType::Rook, EPieceColor::White, FBoardCoord(0, 0));
+	Board->AddPiece(10, EPieceType::King, EPieceColor::Black, FBoardCoord(4, 7));
+	Board->AddPiece(11, EPieceType::Rook, EPieceColor::Black, FBoardCoord(5, 7)); // Covers f1
+	Board->AddPiece(12, EPieceType::Pawn, EPieceColor::Black, FBoardCoord(1, 2)); // Covers a2 and c2
+
+	TestTrue(TEXT("Standard rules detected"), RuleSet->UsesStandardRules());
+	TestTrue(TEXT("F1 attacked by rook"), RuleSet->IsSquareAttacked(Board, FBoardCoord(5, 0), EPieceColor::Black));
+	TestTrue(TEXT("C2 attacked by pawn"), RuleSet->IsSquareAttacked(Board, FBoardCoord(2, 1), EPieceColor::Black));
+	TestFalse(TEXT("B2 not attacked by pawn"), RuleSet->IsSquareAttacked(Board, FBoardCoord(1, 1), EPieceColor::Black));
+	TestFalse(TEXT("White king not in check"), RuleSet->IsKingInCheck(Board, EPieceColor::White));
+
+	TArray<FChessMove> Moves;
+	RuleSet->GenerateLegalMoves(Board, 0, Moves);
+	bool bKingside = false, bQueenside = false;
+	for (const FChessMove& Move : Moves)
+	{
+		if (Move.SpecialType == ESpecialMoveType::Castling)
+		{
+			bKingside |= Move.To.File == 6;
+			bQueenside |= Move.To.File == 2;
+		}
+	}
+	TestFalse(TEXT("Cannot castle through attacked f1"), bKingside);
+	TestTrue(TEXT("Can castle queenside"), bQueenside);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChessGameLegalEdgeCaseTest, "ChessGame.Logic.LegalMoveEdgeCases", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FChessGameLegalEdgeCaseTest::RunTest(const FString& Parameters)
+{
+	UChessRuleSet* RuleSet = NewObject<UChessRuleSet>();
+	RuleSet->Initialize();
+	UChessBoardState* Board = NewObject<UChessBoardState>();
+
+	// En passant that would remove both pawns from the king's rank exposes it to the rook
+	Board->InitializeEmpty();
+	Board->AddPiece(0, EPieceType::King, EPieceColor::White, FBoardCoord(0, 4));
+	Board->AddPiece(1, EPieceType::Pawn, EPieceColor::White, FBoardCoord(1, 4));
+	Board->AddPiece(10, EPieceType::King, EPieceColor::Black, FBoardCoord(7, 7));
+	Board->AddPiece(11, EPieceType::Pawn, EPieceColor::Black, FBoardCoord(2, 4));
+	Board->AddPiece(12, EPieceType::Rook, EPieceColor::Black, FBoardCoord(7, 4));
+	Board->bHasEnPassantTarget = true;
+	Board->EnPassantTarget = FBoardCoord(2, 5);
+
+	TArray<FChessMove> Moves;
+	RuleSet->GenerateLegalMoves(Board, 1, Moves);
+	bool bFoundEnPassant = false;
+	for (const FChessMove& Move : Moves)
+	{
+		bFoundEnPassant |= Move.SpecialType == ESpecialMoveType::EnPassant;
+	}
+	TestFalse(TEXT("En passant exposing the king is illegal"), bFoundEnPassant);
+	TestEqual(TEXT("Pawn push still legal"), Moves.Num(), 1);
+
+	// Double check: only the king may move, even if another piece could capture a checker
+	Board->InitializeEmpty();
+	Board->AddPiece(0, EPieceType::King, EPieceColor::White, FBoardCoord(4, 0));
+	Board->AddPiece(1, EPieceType::Queen, EPieceColor::White, FBoardCoord(3, 0));
+	Board->AddPiece(10, EPieceType::King, EPieceColor::Black, FBoardCoord(0, 7));
+	Board->AddPiece(11, EPieceType::Rook, EPieceColor::Black, FBoardCoord(4, 7));
+	Board->AddPiece(12, EPieceType::Knight, EPieceColor::Black, FBoardCoord(3, 2));
+
+	Moves.Reset();
+	RuleSet->GenerateLegalMoves(Board, 1, Moves);
+	TestEqual(TEXT("Queen has no moves in double check"), Moves.Num(), 0);
+
+	Moves.Reset();
+	RuleSet->GenerateLegalMoves(Board, 0, Moves);
+	TestTrue(TEXT("King has evasions"), Moves.Num() > 0);
+	for (const FChessMove& Move : Moves)
+	{
+		TestTrue(TEXT("King leaves the e-file"), Move.To.File != 4);
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChessGameZobristHashTest, "ChessGame.Logic.ZobristHash", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FChessGameZobristHashTest::RunTest(const FString& Parameters)
+{
+	UChessRuleSet* RuleSet = NewObject<UChessRuleSet>();
+	RuleSet->Initialize();
+	UChessBoardState* Board = NewObject<UChessBoardState>();
+	RuleSet->SetupInitialBoardState(Board);
+
+	UChessBoardState* Scratch = NewObject<UChessBoardState>();
+	auto RecomputedHash = [Board, Scratch]()
+	{
+		Scratch->FromStruct(Board->ToStruct());
+		return Scratch->GetHash();
+	};
+
+	auto Play = [this, Board, RuleSet](FBoardCoord From, FBoardCoord To) -> bool
+	{
+		TArray<FChessMove> Moves;
+		RuleSet->GenerateLegalMoves(Board, Board->GetPieceIdAt(From), Moves);
+		for (const FChessMove& Move : Moves)
+		{
+			if (Move.To == To)
+			{
+				FMoveUndoRecord Undo;
+				Board->MakeMove(Move, Undo);
+				return true;
+			}
+		}
+		AddError(FString::Printf(TEXT("Move %s -> %s not found"), *From.ToString(), *To.ToString()));
+		return false;
+	};
+
+	const uint64 StartHash = Board->GetHash();
+	TestEqual(TEXT("Initial hash matches a full recompute"), StartHash, RecomputedHash());
+
+	// Knight shuffle returns to the start position: same key despite different move counters
+	Play(FBoardCoord(6, 0), FBoardCoord(5, 2));
+	TestNotEqual(TEXT("Hash changes after a move"), Board->GetHash(), StartHash);
+	Play(FBoardCoord(1, 7), FBoardCoord(2, 5));
+	Play(FBoardCoord(5, 2), FBoardCoord(6, 0));
+	Play(FBoardCoord(2, 5), FBoardCoord(1, 7));
+	TestEqual(TEXT("Transposition back to the start"), Board->GetHash(), StartHash);
+
+	// A king step and back loses castling rights, so the position is different
+	Play(FBoardCoord(4, 1), FBoardCoord(4, 3));
+	Play(FBoardCoord(4, 6), FBoardCoord(4, 4));
+	const uint64 BeforeKingWalk = Board->GetHash();
+	Play(FBoardCoord(4, 0), FBoardCoord(4, 1));
+	Play(FBoardCoord(4, 7), FBoardCoord(4, 6));
+	Play(FBoardCoord(4, 1), FBoardCoord(4, 0));
+	Play(FBoardCoord(4, 6), FBoardCoord(4, 7));
+	TestNotEqual(TEXT("Castling rights are part of the key"), Board->GetHash(), BeforeKingWalk);
+	TestEqual(TEXT("Incremental hash matches a full recompute"), Board->GetHash(), RecomputedHash());
+
+	// Masks are hashed, and clearing one restores the key
+	const uint64 BeforeMask = Board->GetHash();
+	const int32 MaskedId = Board->GetPieceIdAt(FBoardCoord(3, 0));
+	Board->SetPieceMask(MaskedId, EPieceType::Knight);
+	TestNotEqual(TEXT("Mask changes the key"), Board->GetHash(), BeforeMask);
+	TestEqual(TEXT("Masked hash matches a full recompute"), Board->GetHash(), RecomputedHash());
+	Board->SetPieceMask(MaskedId, EPieceType::None);
+	TestEqual(TEXT("Removing the mask restores the key"), Board->GetHash(), BeforeMask);
+
+	// En passant only counts when the capture is available
+	Play(FBoardCoord(3, 1), FBoardCoord(3, 3));
+	TestEqual(TEXT("Unusable en passant target is not hashed"), Board->GetHash(), RecomputedHash());
+	Play(FBoardCoord(4, 4), FBoardCoord(3, 3));
+	Play(FBoardCoord(2, 1), FBoardCoord(2, 3));
+	const uint64 WithEnPassant = Board->GetHash();
+	Board->bHasEnPassantTarget = false;
+	TestNotEqual(TEXT("Capturable en passant target is hashed"), Board->GetHash(), WithEnPassant);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChessGameDrawRulesTest, "ChessGame.Logic.DrawRules", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FChessGameDrawRulesTest::RunTest(const FString& Parameters)
+{
+	auto MakeMove = [](UChessGameModel* Model, FBoardCoord From, FBoardCoord To)
+	{
+		FChessMove Move;
+		Move.From = From;
+		Move.To = To;
+		Move.MovingPieceId = Model->BoardState->GetPieceIdAt(From);
+		return Model->TryApplyMove(Move);
+	};
+
+	// Threefold repetition: the start position recurs after each knight shuffle
+	{
+		UChessGameModel* Model = NewObject<UChessGameModel>();
+		Model->InitializeGame();
+		for (int32 Cycle = 0; Cycle < 2; ++Cycle)
+		{
+			TestEqual(TEXT("Repetition count before cycle"), Model->GetRepetitionCount(), Cycle + 1);
+			TestFalse(TEXT("Game continues before the third occurrence"), Model->BoardState->bIsGameOver);
+			MakeMove(Model, FBoardCoord(6, 0), FBoardCoord(5, 2));
+			MakeMove(Model, FBoardCoord(6, 7), FBoardCoord(5, 5));
+			MakeMove(Model, FBoardCoord(5, 2), FBoardCoord(6, 0));
+			MakeMove(Model, FBoardCoord(5, 5), FBoardCoord(6, 7));
+		}
+		TestTrue(TEXT("Threefold repetition ends the game"), Model->BoardState->bIsGameOver && Model->BoardState->bIsDraw);
+		TestEqual(TEXT("Repetition reason"), Model->BoardState->GameEndReason, EChessGameEndReason::ThreefoldRepetition);
+		TestFalse(TEXT("No moves after the game ended"), MakeMove(Model, FBoardCoord(4, 1), FBoardCoord(4, 3)));
+	}
+
+	// A pawn move clears the history, so the shuffle has to start over
+	{
+		UChessGameModel* Model = NewObject<UChessGameModel>();
+		Model->InitializeGame();
+		MakeMove(Model, FBoardCoord(6, 0), FBoardCoord(5, 2));
+		MakeMove(Model, FBoardCoord(6, 7), FBoardCoord(5, 5));
+		MakeMove(Model, FBoardCoord(5, 2), FBoardCoord(6, 0));
+		MakeMove(Model, FBoardCoord(5, 5), FBoardCoord(6, 7));
+		TestEqual(TEXT("Start position seen twice"), Model->GetRepetitionCount(), 2);
+		MakeMove(Model, FBoardCoord(4, 1), FBoardCoord(4, 3));
+		TestEqual(TEXT("History reset after a pawn move"), Model->GetRepetitionCount(), 1);
+	}
+
+	// Fifty-move rule: the hundredth quiet ply ends the game
+	{
+		UChessGameModel* Model = NewObject<UChessGameModel>();
+		Model->InitializeGame();
+		Model->BoardState->HalfmoveClock = 99;
+		MakeMove(Model, FBoardCoord(6, 0), FBoardCoord(5, 2));
+		TestEqual(TEXT("Fifty-move reason"), Model->BoardState->GameEndReason, EChessGameEndReason::FiftyMoveRule);
+		TestTrue(TEXT("Fifty-move draw"), Model->BoardState->bIsDraw);
+	}
+
+	// Insufficient material
+	{
+		UChessGameModel* Model = NewObject<UChessGameModel>();
+		Model->InitMode = EChessInitMode::Empty;
+		Model->InitializeGame();
+		UChessBoardState* Board = Model->BoardState;
+		Board->AddPiece(0, EPieceType::King, EPieceColor::White, FBoardCoord(4, 0));
+		Board->AddPiece(1, EPieceType::Bishop, EPieceColor::White, FBoardCoord(2, 0)); // c1, dark
+		Board->AddPiece(10, EPieceType::King, EPieceColor::Black, FBoardCoord(4, 7));
+		Board->AddPiece(11, EPieceType::Knight, EPieceColor::Black, FBoardCoord(1, 7));
+		TestFalse(TEXT("Bishop vs knight can still mate"), Model->RuleSet->IsInsufficientMaterial(Board));
+
+		Board->RemovePiece(11);
+		Board->AddPiece(12, EPieceType::Bishop, EPieceColor::Black, FBoardCoord(5, 7)); // f8, dark
+		TestTrue(TEXT("Same-coloured bishops are dead"), Model->RuleSet->IsInsufficientMaterial(Board));
+
+		Board->SetPieceMask(12, EPieceType::Queen);
+		TestTrue(TEXT("Masks do not add mating material"), Model->RuleSet->IsInsufficientMaterial(Board));
+
+		Board->RemovePiece(12);
+		Board->AddPiece(13, EPieceType::Bishop, EPieceColor::Black, FBoardCoord(2, 7)); // c8, light
+		TestFalse(TEXT("Opposite-coloured bishops can mate"), Model->RuleSet->IsInsufficientMaterial(Board));
+
+		Board->RemovePiece(13);
+		Board->AddPiece(14, EPieceType::Pawn, EPieceColor::Black, FBoardCoord(0, 6));
+		MakeMove(Model, FBoardCoord(2, 0), FBoardCoord(0, 2));
+		MakeMove(Model, FBoardCoord(0, 6), FBoardCoord(0, 5));
+		MakeMove(Model, FBoardCoord(0, 2), FBoardCoord(1, 3));
+		TestFalse(TEXT("Pawn keeps the game alive"), Model->BoardState->bIsGameOver);
+		MakeMove(Model, FBoardCoord(0, 5), FBoardCoord(0, 4));
+		MakeMove(Model, FBoardCoord(1, 3), FBoardCoord(0, 4)); // Bxa5 leaves K+B vs K
+		TestEqual(TEXT("Insufficient material reason"), Model->BoardState->GameEndReason, EChessGameEndReason::InsufficientMaterial);
+	}
+
+	// A pawn mask can push to the last rank and promote, whatever is under it
+	{
+		UChessGameModel* Model = NewObject<UChessGameModel>();
+		Model->InitMode = EChessInitMode::Empty;
+		Model->InitializeGame();
+		UChessBoardState* Board = Model->BoardState;
+		Board->AddPiece(0, EPieceType::King, EPieceColor::White, FBoardCoord(4, 0));
+		Board->AddPiece(1, EPieceType::Knight, EPieceColor::White, FBoardCoord(1, 6)); // b7
+		Board->AddPiece(10, EPieceType::King, EPieceColor::Black, FBoardCoord(7, 7));
+		Board->SetPieceMask(1, EPieceType::Pawn);
+		TestFalse(TEXT("Knight in a pawn mask is not dead material"), Model->RuleSet->IsInsufficientMaterial(Board));
+
+		TestTrue(TEXT("b7b8=Q through the mask"), Model->TryApplyMove(FChessPackedMove::Make(49, 57, ESpecialMoveType::Promotion, EPieceType::Queen).ToMove(Board)));
+		TestEqual(TEXT("Promoted to a queen"), Board->GetPiece(1)->Type, EPieceType::Queen);
+		TestFalse(TEXT("Game goes on after the promotion"), Board->bIsGameOver);
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChessGameFENTest, "ChessGame.Logic.FEN", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FChessGameFENTest::RunTest(const FString& Parameters)
+{
+	UChessRuleSet* RuleSet = NewObject<UChessRuleSet>();
+	RuleSet->Initialize();
+	UChessBoardState* Board = NewObject<UChessBoardState>();
+	UChessBoardState* Loaded = NewObject<UChessBoardState>();
+
+	// The hard-coded start position and its FEN describe the same position
+	const FString StartFEN = TEXT("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+	RuleSet->SetupInitialBoardState(Board);
+	TestEqual(TEXT("Start position exports to the standard FEN"), Board->ToFEN(), StartFEN);
+	RuleSet->SetupInitialBoardState(Loaded, EChessInitMode::FromFEN, StartFEN);
+	TestEqual(TEXT("FromFEN start position hashes like the built-in one"), Loaded->GetHash(), Board->GetHash());
+
+	// Round trips, including en passant, partial castling rights and clocks
+	const TCHAR* RoundTrips[] = {
+		TEXT("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"),
+		TEXT("rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w Kq f6 0 3"),
+		TEXT("8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 12 40"),
+	};
+	for (const TCHAR* FEN : RoundTrips)
+	{
+		TestTrue(FString::Printf(TEXT("Parses %s"), FEN), Board->LoadFromFEN(FEN));
+		TestEqual(FString::Printf(TEXT("Round trip %s"), FEN), Board->ToFEN(), FString(FEN));
+	}
+
+	// Mask extension survives a round trip and keeps the hash
+	RuleSet->SetupInitialBoardState(Board, EChessInitMode::Test_MaskedPawns);
+	const FString MaskedFEN = Board->ToFEN();
+	TestEqual(TEXT("Mask field written"), MaskedFEN, FString(TEXT("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1 pppppppp/pppppppp/8/8/8/8/PPPPPPPP/PPPPPPPP")));
+	TestTrue(TEXT("Masked FEN parses"), Loaded->LoadFromFEN(MaskedFEN));
+	TestEqual(TEXT("Masked hash preserved"), Loaded->GetHash(), Board->GetHash());
+	TestEqual(TEXT("Mask applied to bitboards"), Loaded->GetMaskOccupancy(EPieceType::Pawn), Loaded->GetOccupancy());
+
+	// A piece masked as king on an unmoved corner setup keeps its castling rights
+	TestTrue(TEXT("Masked king FEN parses"), Loaded->LoadFromFEN(TEXT("4k3/8/8/8/8/8/8/R2Q3R w KQ - 0 1 8/8/8/8/8/8/8/3K4")));
+	TestFalse(TEXT("Masked king is unmoved"), Loaded->GetPiece(Loaded->GetPieceIdAt(FBoardCoord(3, 0)))->bHasMoved);
+	TestEqual(TEXT("Masked king castling rights exported"), Loaded->ToFEN(), FString(TEXT("4k3/8/8/8/8/8/8/R2Q3R w KQ - 0 1 8/8/8/8/8/8/8/3K4")));
+
+	// Malformed input is rejected and leaves an empty board
+	const TCHAR* Malformed[] = {
+		TEXT(""),
+		TEXT("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP w KQkq - 0 1"),
+		TEXT("rnbqkbnr/pppppppp/9/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"),
+		TEXT("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNX w KQkq - 0 1"),
+		TEXT("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR x KQkq - 0 1"),
+		TEXT("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq z9 0 1"),
+		TEXT("8/8/8/8/8/8/8/4K3 w - - 0 1 8/8/8/8/8/8/8/Q7"),
+	};
+	for (const TCHAR* FEN : Malformed)
+	{
+		TestFalse(FString::Printf(TEXT("Rejects '%s'"), FEN), Board->LoadFromFEN(FEN));
+		TestEqual(TEXT("Board left empty"), Board->GetOccupancy(), (uint64)0);
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChessMoveListTest, "ChessGame.Logic.MoveList", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FChessMoveListTest::RunTest(const FString& Parameters)
+{
+	UChessRuleSet* RuleSet = NewObject<UChessRuleSet>();
+	RuleSet->Initialize();
+	UChessBoardState* Board = NewObject<UChessBoardState>();
+
+	// Known maximum: 218 legal moves, which must fit the inline capacity of a single list
+	TestTrue(TEXT("Position parsed"), Board->LoadFromFEN(TEXT("R6R/3Q4/1Q4Q1/4Q3/2Q4Q/Q4Q2/pp1Q4/kBNN1KB1 w - - 0 1")));
+
+	FChessMoveList Moves;
+	uint64 WhitePieces = Board->GetColorOccupancy(EPieceColor::White);
+	while (WhitePieces)
+	{
+		const int32 PieceId = Board->Squares[ChessBitboard::PopLsb(WhitePieces)];
+		const int32 Before = Moves.Num();
+		RuleSet->GenerateLegalMoves(Board, PieceId, Moves);
+
+		// The Blueprint overload returns the same moves in the same order
+		TArray<FChessMove> ArrayMoves;
+		RuleSet->GenerateLegalMoves(Board, PieceId, ArrayMoves);
+		bool bSame = ArrayMoves.Num() == Moves.Num() - Before;
+		for (int32 i = 0; bSame && i < ArrayMoves.Num(); ++i)
+		{
+			bSame = ArrayMoves[i].To == Moves[Before + i].To && ArrayMoves[i].PromotionType == Moves[Before + i].PromotionType;
+		}
+		TestTrue(TEXT("TArray and move list overloads agree"), bSame);
+	}
+	TestEqual(TEXT("Maximum position move count"), Moves.Num(), 218);
+	TestTrue(TEXT("Fits in the inline buffer"), Moves.Num() <= ChessMoves::MaxMoves);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChessPackedMoveTest, "ChessGame.Logic.PackedMove", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FChessPackedMoveTest::RunTest(const FString& Parameters)
+{
+	TestEqual(TEXT("Packed move is two bytes"), (int32)sizeof(FChessPackedMove), 2);
+
+	UChessRuleSet* RuleSet = NewObject<UChessRuleSet>();
+	RuleSet->Initialize();
+	UChessBoardState* Board = NewObject<UChessBoardState>();
+
+	// Castling, en passant, promotions (with and without capture) and mask moves all survive a round trip
+	const TCHAR* Positions[] = {
+		TEXT("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"),
+		TEXT("rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3"),
+		TEXT("r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 b kq - 0 1"),
+		TEXT("4k3/8/8/8/8/8/PPPP4/R3K3 w Q - 0 1 8/8/8/8/8/8/NBRQ4/8"),
+	};
+	for (const TCHAR* FEN : Positions)
+	{
+		TestTrue(FString::Printf(TEXT("Parses %s"), FEN), Board->LoadFromFEN(FEN));
+
+		FChessMoveList Moves;
+		uint64 SidePieces = Board->GetColorOccupancy(Board->SideToMove);
+		while (SidePieces)
+		{
+			RuleSet->GenerateLegalMoves(Board, Board->Squares[ChessBitboard::PopLsb(SidePieces)], Moves);
+		}
+
+		FChessPackedMoveList PackedMoves;
+		SidePieces = Board->GetColorOccupancy(Board->SideToMove);
+		while (SidePieces)
+		{
+			RuleSet->GenerateLegalMoves(Board, Board->Squares[ChessBitboard::PopLsb(SidePieces)], PackedMoves);
+		}
+		TestEqual(TEXT("Packed generator yields the same number of moves"), PackedMoves.Num(), Moves.Num());
+
+		for (int32 i = 0; i < Moves.Num(); ++i)
+		{
+			const FChessMove& Move = Moves[i];
+			const FChessPackedMove Packed = FChessPackedMove::FromMove(Move);
+			const FChessMove Unpacked = Packed.ToMove(Board);
+			const bool bLossless = Unpacked.From == Move.From && Unpacked.To == Move.To
+				&& Unpacked.MovingPieceId == Move.MovingPieceId && Unpacked.CapturedPieceId == Move.CapturedPieceId
+				&& Unpacked.SpecialType == Move.SpecialType && Unpacked.PromotionType == Move.PromotionType;
+			TestTrue(FString::Printf(TEXT("Round trip %s in %s"), *FChessPerft::MoveToString(Move), FEN), bLossless);
+			TestTrue(TEXT("Packed generator emits the same move"), PackedMoves.IsValidIndex(i) && PackedMoves[i] == Packed);
+		}
+	}
+
+	// The game's move log replays to the same position
+	UChessGameModel* Model = NewObject<UChessGameModel>();
+	Model->InitializeGame();
+	// Submitted the way clients send moves: packed, then expanded against the model's board
+	auto Play = [Model](int32 From, int32 To)
+	{
+		return Model->TryApplyMove(FChessPackedMove::Make(From, To).ToMove(Model->BoardState));
+	};
+	TestTrue(TEXT("e2e4"), Play(12, 28));
+	TestTrue(TEXT("d7d5"), Play(51, 35));
+	TestTrue(TEXT("e4xd5"), Play(28, 35));
+	TestTrue(TEXT("g8f6"), Play(62, 45));
+	TestEqual(TEXT("Every move logged"), Model->GetMoveLog().Num(), 4);
+
+	RuleSet->SetupInitialBoardState(Board);
+	for (const FChessPackedMove Move : Model->GetMoveLog())
+	{
+		FMoveUndoRecord Undo;
+		Board->MakeMove(Move, Undo);
+	}
+	TestEqual(TEXT("Replayed log reaches the same position"), Board->GetHash(), Model->BoardState->GetHash());
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChessPieceTableTest, "ChessGame.Logic.PieceTable", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FChessPieceTableTest::RunTest(const FString& Parameters)
+{
+	UChessRuleSet* RuleSet = NewObject<UChessRuleSet>();
+	RuleSet->Initialize();
+	UChessBoardState* Board = NewObject<UChessBoardState>();
+
+	// Every live piece's cached square must hold it, every occupied square's piece must point back, and colour lists must agree
+	auto IsConsistent = [](const UChessBoardState* State)
+	{
+		int32 OnBoard = 0;
+		for (uint64 Ids = State->GetPieceIds(); Ids; )
+		{
+			const int32 PieceId = ChessBitboard::PopLsb(Ids);
+			const int32 Square = State->GetPieceSquare(PieceId);
+			if (Square < 0 || State->Squares[Square] != PieceId || !(State->GetPieceIds(State->GetPiece(PieceId)->Color) & (1ull << PieceId)))
+			{
+				return false;
+			}
+			++OnBoard;
+		}
+		return OnBoard == ChessBitboard::PopCount(State->GetOccupancy())
+			&& (State->GetPieceIds(EPieceColor::White) | State->GetPieceIds(EPieceColor::Black)) == State->GetPieceIds()
+			&& (State->GetPieceIds(EPieceColor::White) & State->GetPieceIds(EPieceColor::Black)) == 0;
+	};
+
+	// Kiwipete: the side to move has captures and both castles
+	Board->LoadFromFEN(TEXT("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"));
+	TestTrue(TEXT("Consistent after FEN"), IsConsistent(Board));
+	TestEqual(TEXT("Piece count"), Board->GetNumPieces(), 32);
+	TestEqual(TEXT("GetAllPieces matches count"), Board->GetAllPieces().Num(), 32);
+	TestEqual(TEXT("King found by id"), Board->FindPieceCoord(Board->GetPieceIdAt(FBoardCoord(4, 0))), FBoardCoord(4, 0));
+
+	bool bAllConsistent = true;
+	uint64 SidePieces = Board->GetColorOccupancy(Board->SideToMove);
+	while (SidePieces)
+	{
+		FChessMoveList Moves;
+		RuleSet->GenerateLegalMoves(Board, Board->Squares[ChessBitboard::PopLsb(SidePieces)], Moves);
+		for (const FChessMove& Move : Moves)
+		{
+			FMoveUndoRecord Undo;
+			Board->MakeMove(Move, Undo);
+			bAllConsistent &= IsConsistent(Board);
+			bAllConsistent &= Board->FindPieceCoord(Move.MovingPieceId) == Move.To;
+			bAllConsistent &= Move.CapturedPieceId == -1 || !Board->HasPiece(Move.CapturedPieceId);
+			Board->UnmakeMove(Undo);
+			bAllConsistent &= IsConsistent(Board) && Board->FindPieceCoord(Move.MovingPieceId) == Move.From;
+		}
+	}
+	TestTrue(TEXT("Piece table tracks make/unmake"), bAllConsistent);
+
+	// Replication rebuilds the table from the flat array
+	UChessBoardState* Copy = NewObject<UChessBoardState>();
+	Copy->FromStruct(Board->ToStruct());
+	TestTrue(TEXT("Consistent after FromStruct"), IsConsistent(Copy));
+	TestEqual(TEXT("Same pieces after FromStruct"), Copy->GetPieceIds(), Board->GetPieceIds());
+	TestEqual(TEXT("Same hash after FromStruct"), Copy->GetHash(), Board->GetHash());
+
+	// CopyFrom carries the derived state over instead of rebuilding it
+	UChessBoardState* Direct = NewObject<UChessBoardState>();
+	Direct->LoadFromFEN(TEXT("8/8/8/8/8/8/8/4K2k w - - 0 1"));
+	Direct->CopyFrom(*Board);
+	TestTrue(TEXT("Consistent after CopyFrom"), IsConsistent(Direct));
+	TestEqual(TEXT("Same hash after CopyFrom"), Direct->GetHash(), Board->GetHash());
+	TestEqual(TEXT("Same eval after CopyFrom"), Direct->GetEvalScore(), Board->GetEvalScore());
+	TestEqual(TEXT("Same FEN after CopyFrom"), Direct->ToFEN(), Board->ToFEN());
+
+	Board->RemovePiece(Board->GetPieceIdAt(FBoardCoord(0, 0)));
+	TestTrue(TEXT("Consistent after RemovePiece"), IsConsistent(Board));
+	TestEqual(TEXT("Square cleared"), Board->GetPieceIdAt(FBoardCoord(0, 0)), -1);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChessHasAnyLegalMoveTest, "ChessGame.Logic.HasAnyLegalMove", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FChessHasAnyLegalMoveTest::RunTest(const FString& Parameters)
+{
+	UChessRuleSet* RuleSet = NewObject<UChessRuleSet>();
+	RuleSet->Initialize();
+	UChessBoardState* Board = NewObject<UChessBoardState>();
+
+	auto CountLegalMoves = [RuleSet](UChessBoardState* State)
+	{
+		FChessMoveList Moves;
+		uint64 SidePieces = State->GetColorOccupancy(State->SideToMove);
+		while (SidePieces)
+		{
+			RuleSet->GenerateLegalMoves(State, State->Squares[ChessBitboard::PopLsb(SidePieces)], Moves);
+		}
+		return Moves.Num();
+	};
+
+	// Fool's mate, plain stalemate, and the same stalemate broken by a rook mask on a blocked pawn
+	Board->LoadFromFEN(TEXT("rnb1kbnr/pppp1ppp/8/4p3/6Pq/5P2/PPPPP2P/RNBQKBNR w KQkq - 1 3"));
+	TestFalse(TEXT("Checkmate has no legal move"), RuleSet->HasAnyLegalMove(Board, Board->SideToMove));
+	Board->LoadFromFEN(TEXT("7k/5Q2/6K1/p7/P7/8/8/8 b - - 0 1"));
+	TestFalse(TEXT("Stalemate has no legal move"), RuleSet->HasAnyLegalMove(Board, Board->SideToMove));
+	Board->LoadFromFEN(TEXT("7k/5Q2/6K1/p7/P7/8/8/8 b - - 0 1 8/8/8/r7/8/8/8/8"));
+	TestTrue(TEXT("Mask moves count as legal moves"), RuleSet->HasAnyLegalMove(Board, Board->SideToMove));
+
+	// Agrees with full generation at each root and after every reply, which covers checks, pins and double checks
+	bool bAllAgree = true;
+	for (const FChessPerftPosition& Position : FChessPerft::GetStandardPositions())
+	{
+		Board->LoadFromFEN(Position.FEN);
+		FChessMoveList Moves;
+		uint64 SidePieces = Board->GetColorOccupancy(Board->SideToMove);
+		while (SidePieces)
+		{
+			RuleSet->GenerateLegalMoves(Board, Board->Squares[ChessBitboard::PopLsb(SidePieces)], Moves);
+		}
+
+		bAllAgree &= RuleSet->HasAnyLegalMove(Board, Board->SideToMove) == (Moves.Num() > 0);
+		for (const FChessMove& Move : Moves)
+		{
+			FMoveUndoRecord Undo;
+			Board->MakeMove(Move, Undo);
+			if (RuleSet->HasAnyLegalMove(Board, Board->SideToMove) != (CountLegalMoves(Board) > 0))
+			{
+				AddInfo(FString::Printf(TEXT("Disagreement after %s in %s"), *FChessPerft::MoveToString(Move), Position.Name));
+				bAllAgree = false;
+			}
+			Board->UnmakeMove(Undo);
+		}
+	}
+	TestTrue(TEXT("HasAnyLegalMove matches full generation"), bAllAgree);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChessLegalMoveCacheTest, "ChessGame.Logic.LegalMoveCache", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FChessLegalMoveCacheTest::RunTest(const FString& Parameters)
+{
+	UChessGameModel* Model = NewObject<UChessGameModel>();
+	Model->InitializeGame();
+
+	// Cached per-square moves must equal fresh generation for every piece of either colour
+	auto MatchesGenerator = [Model]()
+	{
+		for (int32 Square = 0; Square < 64; ++Square)
+		{
+			const int32 PieceId = Model->BoardState->Squares[Square];
+			if (PieceId == -1)
+			{
+				continue;
+			}
+			TArray<FChessMove> Cached, Fresh;
+			Model->GetLegalMovesForCoord(FBoardCoord::FromIndex(Square), Cached);
+			Model->RuleSet->GenerateLegalMoves(Model->BoardState, PieceId, Fresh);
+			if (Cached.Num() != Fresh.Num())
+			{
+				return false;
+			}
+			for (int32 i = 0; i < Cached.Num(); ++i)
+			{
+				if (FChessPackedMove::FromMove(Cached[i]) != FChessPackedMove::FromMove(Fresh[i]) || Cached[i].CapturedPieceId != Fresh[i].CapturedPieceId)
+				{
+					return false;
+				}
+			}
+		}
+		return true;
+	};
+
+	auto Play = [Model](int32 From, int32 To)
+	{
+		return Model->TryApplyMove(FChessPackedMove::Make(From, To).ToMove(Model->BoardState));
+	};
+
+	TestTrue(TEXT("Start position"), MatchesGenerator());
+	TestFalse(TEXT("Illegal move rejected"), Play(12, 36));
+	TestTrue(TEXT("e2e4"), Play(12, 28));
+	TestTrue(TEXT("After a move"), MatchesGenerator());
+	TestTrue(TEXT("e7e5"), Play(52, 36));
+
+	// A rook mask lets the blocked e4 pawn slide along the rank and back down the e-file
+	const int32 PawnId = Model->BoardState->Squares[28];
+	TArray<FChessMove> Moves;
+	Model->GetLegalMovesForPiece(PawnId, Moves);
+	TestEqual(TEXT("Blocked pawn has no moves"), Moves.Num(), 0);
+	Model->SetPieceMask(PawnId, EPieceType::Rook);
+	Moves.Reset();
+	Model->GetLegalMovesForPiece(PawnId, Moves);
+	TestEqual(TEXT("Masked pawn gains rook moves"), Moves.Num(), 9);
+	TestTrue(TEXT("After a mask change"), MatchesGenerator());
+
+	Model->RemovePiece(Model->BoardState->Squares[36]);
+	TestTrue(TEXT("After a removal"), MatchesGenerator());
+	TestTrue(TEXT("Pawn advances once the blocker is gone"), Play(28, 36));
+
+	// Edits made straight on the board change the hash, so the cache cannot serve the old position
+	TestTrue(TEXT("FEN loads"), Model->BoardState->LoadFromFEN(TEXT("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1")));
+	TestTrue(TEXT("After a direct board edit"), MatchesGenerator());
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChessAllLegalMovesTest, "ChessGame.Logic.AllLegalMoves", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FChessAllLegalMovesTest::RunTest(const FString& Parameters)
+{
+	UChessRuleSet* RuleSet = NewObject<UChessRuleSet>();
+	RuleSet->Initialize();
+	UChessBoardState* Board = NewObject<UChessBoardState>();
+
+	// The shared positions, and a double check where only the king may move
+	TArray<FString> FENs = GetTestFENs();
+	FENs.Add(TEXT("k3r3/8/8/8/8/3n4/8/3QK3 w - - 0 1"));
+
+	for (const FString& FEN : FENs)
+	{
+		TestTrue(FString::Printf(TEXT("Parsed %s"), *FEN), Board->LoadFromFEN(FEN));
+
+		// Reference: the per-piece API in square order
+		FChessMoveList Expected;
+		uint64 SidePieces = Board->GetColorOccupancy(Board->SideToMove);
+		while (SidePieces)
+		{
+			RuleSet->GenerateLegalMoves(Board, Board->Squares[ChessBitboard::PopLsb(SidePieces)], Expected);
+		}
+
+		FChessMoveList Moves;
+		FChessPackedMoveList PackedMoves;
+		TArray<FChessMove> ArrayMoves;
+		RuleSet->GenerateAllLegalMoves(Board, Board->SideToMove, Moves);
+		RuleSet->GenerateAllLegalMoves(Board, Board->SideToMove, PackedMoves);
+		RuleSet->GenerateAllLegalMoves(Board, Board->SideToMove, ArrayMoves);
+
+		bool bSame = Moves.Num() == Expected.Num() && PackedMoves.Num() == Expected.Num() && ArrayMoves.Num() == Expected.Num();
+		for (int32 i = 0; bSame && i < Expected.Num(); ++i)
+		{
+			const FChessPackedMove Reference = FChessPackedMove::FromMove(Expected[i]);
+			bSame = FChessPackedMove::FromMove(Moves[i]) == Reference && PackedMoves[i] == Reference && FChessPackedMove::FromMove(ArrayMoves[i]) == Reference
+				&& Moves[i].CapturedPieceId == Expected[i].CapturedPieceId;
+		}
+		TestTrue(FString::Printf(TEXT("Whole-side generation matches per-piece generation: %s"), *FEN), bSame);
+	}
+
+	return true;
+}
 
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChessTacticalMovesTest, "ChessGame.Logic.TacticalMoves", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FChessTacticalMovesTest::RunTest(const FString& Parameters)
+{
+	UChessBoardState* Board = NewObject<UChessBoardState>();
+
+	TArray<FString> FENs = GetTestFENs();
+	FENs.Add(TEXT("k3r3/8/8/8/8/3n4/8/3QK3 w - - 0 1"));
+	FENs.Add(TEXT("k7/1N6/8/8/8/8/8/4K3 w - - 0 1 8/1P6/8/8/8/8/8/8"));
+
+	for (const FString& FEN : FENs)
+	{
+		TestTrue(FString::Printf(TEXT("Parsed %s"), *FEN), Board->LoadFromFEN(FEN));
+
+		FChessCheckInfo Info;
+		Info.Init(Board, Board->SideToMove);
+
+		// Reference: every capture and promotion out of the full list, in generation order
+		FChessMoveList AllMoves;
+		FChessLegalMoveGenerator::GenerateAllMoves(Board, Info, AllMoves);
+		FChessPackedMoveList Expected;
+		for (const FChessMove& Move : AllMoves)
+		{
+			if (Move.CapturedPieceId != -1 || Move.SpecialType == ESpecialMoveType::Promotion)
+			{
+				Expected.Add(FChessPackedMove::FromMove(Move));
+			}
+		}
+
+		FChessPackedMoveList Tactical;
+		FChessLegalMoveGenerator::GenerateTacticalMoves(Board, Info, Tactical);
+
+		bool bSame = Tactical.Num() == Expected.Num();
+		for (int32 i = 0; bSame && i < Expected.Num(); ++i)
+		{
+			bSame = Tactical[i] == Expected[i];
+		}
+		TestTrue(FString::Printf(TEXT("Tactical generation matches the filtered full list: %s"), *FEN), bSame);
+	}
+
+	// The last position's knight is masked as a pawn one step from promoting; quiescence must still see it
+	FChessCheckInfo Info;
+	Info.Init(Board, Board->SideToMove);
+	FChessPackedMoveList Tactical;
+	FChessLegalMoveGenerator::GenerateTacticalMoves(Board, Info, Tactical);
+	TestTrue(TEXT("Mask-pawn promotion is tactical"), Tactical.Contains(FChessPackedMove::Make(49, 57, ESpecialMoveType::Promotion, EPieceType::Queen)));
+
+	return true;
+}
+
+namespace
+{
+	// Walks every line to Depth and reports the first node whose running score disagrees with a full rescore
+	bool CheckEvalScoreTree(UChessBoardState* Board, const FChessEvalParams& Params, int32 Depth)
+	{
+		if (Board->GetEvalScore() != FChessEvaluation::ComputeBoardScore(Board, Params))
+		{
+			return false;
+		}
+		if (Depth == 0)
+		{
+			return true;
+		}
+
+		FChessCheckInfo Info;
+		Info.Init(Board, Board->SideToMove);
+		FChessPackedMoveList Moves;
+		FChessLegalMoveGenerator::GenerateAllMoves(Board, Info, Moves);
+		for (FChessPackedMove Move : Moves)
+		{
+			const int32 Before = Board->GetEvalScore();
+			FMoveUndoRecord Undo;
+			Board->MakeMove(Move, Undo);
+			const bool bOk = CheckEvalScoreTree(Board, Params, Depth - 1);
+			Board->UnmakeMove(Undo);
+			if (!bOk || Board->GetEvalScore() != Before)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChessIncrementalEvalTest, "ChessGame.Logic.IncrementalEval", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FChessIncrementalEvalTest::RunTest(const FString& Parameters)
+{
+	UChessBoardState* Board = NewObject<UChessBoardState>();
+	const FChessEvalParams& Default = FChessEvalParams::GetDefault();
+
+	// Mirrored sides cancel exactly, leaving only the tempo for the side to move
+	Board->LoadFromFEN(TEXT("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"));
+	TestEqual(TEXT("Start position scores level"), Board->GetEvalScore(), 0);
+	TestEqual(TEXT("Start position evaluates to the tempo"), FChessEvaluation::Evaluate(Board), Default.TempoBonus);
+
+	// An extra queen for White reads positive for White and negative for Black
+	Board->LoadFromFEN(TEXT("4k3/8/8/8/8/8/8/3QK3 w - - 0 1"));
+	const int32 WhiteView = FChessEvaluation::Evaluate(Board);
+	Board->LoadFromFEN(TEXT("4k3/8/8/8/8/8/8/3QK3 b - - 0 1"));
+	TestTrue(TEXT("Material favours its owner"), WhiteView > 800);
+	TestEqual(TEXT("Evaluation flips with the side to move"), FChessEvaluation::Evaluate(Board), -WhiteView + 2 * Default.TempoBonus);
+
+	// Make/unmake of every line, with castling, en passant, promotions and masked pieces in play
+	for (const FString& FEN : GetTestFENs())
+	{
+		Board->LoadFromFEN(FEN);
+		TestTrue(FString::Printf(TEXT("Running score matches a rescore on every line: %s"), *FEN), CheckEvalScoreTree(Board, Default, 3));
+	}
+
+	// Masking a queen as a pawn earns the deception bonus; unmasking takes it back
+	Board->LoadFromFEN(TEXT("4k3/8/8/8/8/8/8/3QK3 w - - 0 1"));
+	const int32 Unmasked = Board->GetEvalScore();
+	const int32 QueenId = Board->GetPieceIdAt(FBoardCoord(3, 0));
+	Board->SetPieceMask(QueenId, EPieceType::Pawn);
+	const int32 ExpectedBonus = FChessEvalParams::DefaultMaskFlatBonus
+		+ (FChessEvalParams::DefaultMaterial[(uint8)EPieceType::Queen] - FChessEvalParams::DefaultMaterial[(uint8)EPieceType::Pawn]) * FChessEvalParams::DefaultMaskGapPercent / 100;
+	TestEqual(TEXT("Mask adds the deception bonus"), Board->GetEvalScore(), Unmasked + ExpectedBonus);
+	Board->SetPieceMask(QueenId, EPieceType::None);
+	TestEqual(TEXT("Removing the mask restores the score"), Board->GetEvalScore(), Unmasked);
+
+	// Swapping the weights rescores the board, and later moves keep using the new ones
+	int32 Material[ChessBitboard::NumPieceTypes];
+	FMemory::Memcpy(Material, FChessEvalParams::DefaultMaterial, sizeof(Material));
+	Material[(uint8)EPieceType::Queen] = 1200;
+	FChessEvalParams Custom;
+	Custom.Build(Material, FChessEvalParams::DefaultSquareBonus, 0, 0);
+	Board->SetEvalParams(&Custom);
+	TestEqual(TEXT("New weights apply at once"), Board->GetEvalScore(), Unmasked + 300);
+	TestTrue(TEXT("New weights are kept up to date"), CheckEvalScoreTree(Board, Custom, 3));
+	Board->SetEvalParams(nullptr);
+	TestEqual(TEXT("Null restores the built-in weights"), Board->GetEvalScore(), Unmasked);
+
+	return true;
+}
+
+namespace
+{
+	// A weight file of reproducible noise, scaled so the accumulators regularly cross both ends of the clipped ReLU
+	TArray<uint8> MakeTestNetworkBytes()
+	{
+		TArray<uint8> Bytes;
+		Bytes.SetNumZeroed((int32)ChessNNUE::GetFileSize());
+
+		const ChessNNUE::FFileHeader Header;
+		FMemory::Memcpy(Bytes.GetData(), &Header, sizeof(Header));
+
+		uint32 State = 0x2545F491;
+		auto Next = [&State](int32 Min, int32 Max)
+		{
+			State ^= State << 13;
+			State ^= State >> 17;
+			State ^= State << 5;
+			return Min + (int32)(State % (uint32)(Max - Min + 1));
+		};
+
+		// Sections in file order, each starting on a 64-byte boundary
+		int64 Offset = sizeof(ChessNNUE::FFileHeader);
+		auto Fill = [&](int32 Count, int32 ElementSize, int32 Min, int32 Max)
+		{
+			for (int32 i = 0; i < Count; ++i)
+			{
+				const int32 Value = Next(Min, Max);
+				FMemory::Memcpy(Bytes.GetData() + Offset + (int64)i * ElementSize, &Value, ElementSize);
+			}
+			Offset += ((int64)Count * ElementSize + 63) & ~int64(63);
+		};
+		Fill(ChessNNUE::L1, sizeof(int16), 0, 64);
+		Fill(ChessNNUE::NumFeatures * ChessNNUE::L1, sizeof(int16), -12, 12);
+		Fill(ChessNNUE::L2, sizeof(int32), -2000, 2000);
+		Fill(ChessNNUE::L2 * 2 * ChessNNUE::L1, sizeof(int8), -8, 8);
+		Fill(1, sizeof(int32), -500, 500);
+		Fill(ChessNNUE::L2, sizeof(int8), -128, 127);
+		return Bytes;
+	}
+
+	// Walks every line to Depth comparing the board-maintained accumulator with a fresh one, and the vector
+	// kernels with the scalar ones
+	bool CheckNNUETree(UChessBoardState* Board, const FChessNNUENetwork& Network, int32 Depth)
+	{
+		FChessNNUEAccumulator Fresh(Network);
+		Fresh.Refresh(Board);
+		const FChessNNUEAccumulator& Live = *Board->GetNNUEAccumulator();
+		if (FMemory::Memcmp(Fresh.Values, Live.Values, sizeof(Fresh.Values)) != 0
+			|| Network.Evaluate(Live, Board->SideToMove) != Network.EvaluateScalar(Live, Board->SideToMove))
+		{
+			return false;
+		}
+		if (Depth == 0)
+		{
+			return true;
+		}
+
+		FChessCheckInfo Info;
+		Info.Init(Board, Board->SideToMove);
+		FChessPackedMoveList Moves;
+		FChessLegalMoveGenerator::GenerateAllMoves(Board, Info, Moves);
+		for (FChessPackedMove Move : Moves)
+		{
+			FMoveUndoRecord Undo;
+			Board->MakeMove(Move, Undo);
+			const bool bOk = CheckNNUETree(Board, Network, Depth - 1);
+			Board->UnmakeMove(Undo);
+			if (!bOk)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChessNNUETest, "ChessGame.Logic.NNUE", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FChessNNUETest::RunTest(const FString& Parameters)
+{
+	const TArray<uint8> Bytes = MakeTestNetworkBytes();
+
+	// Malformed files are refused
+	TArray<uint8> Truncated = Bytes;
+	Truncated.SetNum(Truncated.Num() - 64);
+	TestFalse(TEXT("Truncated file is refused"), FChessNNUENetwork::CreateFromBytes(MoveTemp(Truncated)).IsValid());
+	TArray<uint8> WrongMagic = Bytes;
+	WrongMagic[0] ^= 0xFF;
+	TestFalse(TEXT("Foreign file is refused"), FChessNNUENetwork::CreateFromBytes(MoveTemp(WrongMagic)).IsValid());
+
+	TArray<uint8> Copy = Bytes;
+	TSharedPtr<const FChessNNUENetwork, ESPMode::ThreadSafe> Network = FChessNNUENetwork::CreateFromBytes(MoveTemp(Copy));
+	if (!TestTrue(TEXT("Network created"), Network.IsValid()))
+	{
+		return false;
+	}
+
+	UChessBoardState* Board = NewObject<UChessBoardState>();
+	FChessNNUEAccumulator Accumulator(*Network);
+	Board->SetNNUEAccumulator(&Accumulator);
+
+	// Each side sees the symmetric start position as the other does
+	Board->LoadFromFEN(TEXT("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"));
+	const int32 WhiteToMove = FChessEvaluation::Evaluate(Board);
+	TestEqual(TEXT("Board evaluation goes through the network"), WhiteToMove, Network->Evaluate(Accumulator, EPieceColor::White));
+	Board->SideToMove = EPieceColor::Black;
+	TestEqual(TEXT("Perspectives mirror each other"), FChessEvaluation::Evaluate(Board), WhiteToMove);
+
+	for (const FString& FEN : GetTestFENs())
+	{
+		Board->LoadFromFEN(FEN);
+		TestTrue(FString::Printf(TEXT("Accumulator and kernels agree on every line: %s"), *FEN), CheckNNUETree(Board, *Network, 2));
+	}
+
+	// Mask changes light and clear the mask feature
+	Board->SetPieceMask(Board->GetPieceIdAt(FBoardCoord(4, 0)), EPieceType::Queen);
+	TestTrue(TEXT("Accumulator follows a mask change"), CheckNNUETree(Board, *Network, 0));
+
+	// The same weights read back through a mapped file
+	const FString Path = FPaths::CreateTempFilename(*FPaths::ProjectIntermediateDir(), TEXT("ChessNNUE"), TEXT(".nnue"));
+	if (TestTrue(TEXT("Weight file written"), FFileHelper::SaveArrayToFile(Bytes, *Path)))
+	{
+		TSharedPtr<const FChessNNUENetwork, ESPMode::ThreadSafe> Mapped = FChessNNUENetwork::LoadFromFile(Path);
+		if (TestTrue(TEXT("Weight file loaded"), Mapped.IsValid()))
+		{
+			FChessNNUEAccumulator MappedAccumulator(*Mapped);
+			MappedAccumulator.Refresh(Board);
+			TestEqual(TEXT("Loaded weights evaluate identically"), Mapped->Evaluate(MappedAccumulator, Board->SideToMove), Network->Evaluate(Accumulator, Board->SideToMove));
+		}
+		IFileManager::Get().Delete(*Path);
+	}
+
+	Board->SetNNUEAccumulator(nullptr);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChessMaskBeliefTest, "ChessGame.Logic.MaskBelief", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FChessMaskBeliefTest::RunTest(const FString& Parameters)
+{
+	auto TypeBit = [](EPieceType Type) { return (uint8)(1 << (uint8)Type); };
+
+	// Black's a7 knight wears a pawn mask and its h7 pawn a knight mask
+	UChessGameModel* Model = NewObject<UChessGameModel>();
+	Model->InitMode = EChessInitMode::FromFEN;
+	Model->InitFEN = TEXT("4k3/n6p/8/8/8/8/8/4K3 b - - 0 1 8/p6n/8/8/8/8/8/8");
+	Model->InitializeGame();
+	UChessBoardState* Board = Model->BoardState;
+	const int32 KnightId = Board->GetPieceIdAt(FBoardCoord(0, 6));
+	const int32 PawnId = Board->GetPieceIdAt(FBoardCoord(7, 6));
+	auto Play = [Model](int32 From, int32 To)
+	{
+		return Model->TryApplyMove(FChessPackedMove::Make(From, To).ToMove(Model->BoardState));
+	};
+
+	const FChessMaskBelief& Belief = Model->GetMaskBelief(EPieceColor::White);
+	const uint8 Either = TypeBit(EPieceType::Pawn) | TypeBit(EPieceType::Knight);
+	TestEqual(TEXT("One slot per masked piece"), Belief.GetNumSlots(), 2);
+	TestEqual(TEXT("Only the pool's types are possible"), Belief.GetPossibleTypes(Board, KnightId), Either);
+	TestTrue(TEXT("Knight is hidden"), Belief.IsHidden(KnightId));
+	TestFalse(TEXT("Unmasked king is not"), Belief.IsHidden(Board->GetPieceIdAt(FBoardCoord(4, 7))));
+	TestEqual(TEXT("Even odds to start"), Belief.GetProbability(Board, KnightId, EPieceType::Pawn), 0.5f);
+	TestEqual(TEXT("Black sees nothing hidden"), Model->GetMaskBelief(EPieceColor::Black).GetNumSlots(), 0);
+
+	// A step its mask allows tells White nothing
+	TestTrue(TEXT("a7a6"), Play(48, 40));
+	TestTrue(TEXT("Mask move leaves the knight hidden"), Belief.IsHidden(KnightId));
+
+	FRandomStream Rng(7);
+	bool bDrawsKeepCounts = true;
+	for (int32 i = 0; i < 64; ++i)
+	{
+		EPieceType Drawn[FChessMaskBelief::MaxSlots];
+		Belief.Sample(Rng, Drawn);
+		bDrawsKeepCounts &= (TypeBit(Drawn[KnightId]) | TypeBit(Drawn[PawnId])) == Either;
+	}
+	TestTrue(TEXT("Every draw deals one pawn and one knight"), bDrawsKeepCounts);
+
+	// A jump its mask cannot explain gives it away, and the count gives the other one away too
+	TestTrue(TEXT("e1d1"), Play(4, 3));
+	TestTrue(TEXT("a6b4"), Play(40, 25));
+	TestEqual(TEXT("Jumper is a knight"), Belief.GetPossibleTypes(Board, KnightId), TypeBit(EPieceType::Knight));
+	TestEqual(TEXT("So the other is the pawn"), Belief.GetPossibleTypes(Board, PawnId), TypeBit(EPieceType::Pawn));
+	TestFalse(TEXT("Nothing left hidden"), Belief.IsHidden(PawnId));
+
+	// Beliefs never rule out the truth, through random play of a fully masked game
+	Model->InitMode = EChessInitMode::Test_MaskSwap;
+	Model->InitializeGame();
+	Board = Model->BoardState;
+	TestEqual(TEXT("Every opponent piece has a slot"), Model->GetMaskBelief(EPieceColor::White).GetNumSlots(), 16);
+
+	bool bSound = true;
+	for (int32 Ply = 0; Ply < 80 && !Board->bIsGameOver; ++Ply)
+	{
+		FChessMoveList Moves;
+		Model->RuleSet->GenerateAllLegalMoves(Board, Board->SideToMove, Moves);
+		if (Moves.Num() == 0 || !Model->TryApplyMove(Moves[Rng.RandRange(0, Moves.Num() - 1)]))
+		{
+			break;
+		}
+
+		for (const EPieceColor Observer : { EPieceColor::White, EPieceColor::Black })
+		{
+			const FChessMaskBelief& Tracked = Model->GetMaskBelief(Observer);
+			EPieceType Drawn[FChessMaskBelief::MaxSlots];
+			Tracked.Sample(Rng, Drawn);
+			for (uint64 Ids = Board->GetPieceIds(Observer == EPieceColor::White ? EPieceColor::Black : EPieceColor::White); Ids; )
+			{
+				const int32 PieceId = ChessBitboard::PopLsb(Ids);
+				const uint8 Possible = Tracked.GetPossibleTypes(Board, PieceId);
+				bSound &= (Possible & TypeBit(Board->GetPiece(PieceId)->Type)) != 0;
+				bSound &= !Tracked.IsHidden(PieceId) || (Possible & TypeBit(Drawn[PieceId])) != 0;
+			}
+		}
+	}
+	TestTrue(TEXT("True types stay possible and draws stay within the sets"), bSound);
 	return true;
 }
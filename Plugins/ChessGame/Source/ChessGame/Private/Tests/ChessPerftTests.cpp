@@ -0,0 +1,92 @@
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Logic/ChessBoardState.h"
+#include "Logic/ChessRuleSet.h"
+#include "Logic/ChessPerft.h"
+
+namespace
+{
+	/** Runs one of FChessPerft's standard positions at its reference depth and reports throughput. */
+	bool RunStandardPerft(FAutomationTestBase& Test, const TCHAR* Name)
+	{
+		const FChessPerftPosition* Position = FChessPerft::GetStandardPositions().FindByPredicate(
+			[Name](const FChessPerftPosition& Candidate) { return FString(Candidate.Name) == Name; });
+		if (!Position)
+		{
+			Test.AddError(FString::Printf(TEXT("Unknown perft position %s"), Name));
+			return false;
+		}
+
+		UChessRuleSet* RuleSet = NewObject<UChessRuleSet>();
+		RuleSet->Initialize();
+		UChessBoardState* Board = NewObject<UChessBoardState>();
+
+		bool bPassed = Test.TestTrue(TEXT("Position parsed"), Board->LoadFromFEN(Position->FEN));
+		if (bPassed)
+		{
+			const FChessBoardStateData Before = Board->ToStruct();
+			const uint64 HashBefore = Board->GetHash();
+
+			const FChessPerftResult Result = FChessPerft::Divide(RuleSet, Board, Position->Depth);
+			if (Result.Nodes != Position->ExpectedNodes)
+			{
+				// Divide output pinpoints the faulty subtree when compared against a reference engine
+				for (const FChessPerftDivideEntry& Entry : Result.Divide)
+				{
+					Test.AddInfo(FString::Printf(TEXT("%s: %llu"), *FChessPerft::MoveToString(Entry.Move), Entry.Nodes));
+				}
+				Test.AddError(FString::Printf(TEXT("%s depth %d: %llu nodes, expected %llu"), Name, Position->Depth, Result.Nodes, Position->ExpectedNodes));
+				bPassed = false;
+			}
+
+			bPassed &= Test.TestTrue(TEXT("Board restored after perft"), Board->GetHash() == HashBefore && Board->ToStruct().Squares == Before.Squares);
+
+			Test.AddInfo(FString::Printf(TEXT("%s depth %d: %llu nodes in %.3fs (%.0f nps)"),
+				Name, Position->Depth, Result.Nodes, Result.Seconds, Result.GetNodesPerSecond()));
+		}
+
+		return bPassed;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChessPerftStartPositionTest, "ChessGame.Perf.StartPosition", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FChessPerftStartPositionTest::RunTest(const FString& Parameters)
+{
+	return RunStandardPerft(*this, TEXT("StartPosition"));
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChessPerftKiwipeteTest, "ChessGame.Perf.Kiwipete", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FChessPerftKiwipeteTest::RunTest(const FString& Parameters)
+{
+	return RunStandardPerft(*this, TEXT("Kiwipete"));
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChessPerftEnPassantPinsTest, "ChessGame.Perf.EnPassantPins", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FChessPerftEnPassantPinsTest::RunTest(const FString& Parameters)
+{
+	return RunStandardPerft(*this, TEXT("EnPassantPins"));
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChessPerftCastlingPromotionTest, "ChessGame.Perf.CastlingPromotion", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FChessPerftCastlingPromotionTest::RunTest(const FString& Parameters)
+{
+	return RunStandardPerft(*this, TEXT("CastlingPromotion"));
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChessPerftPromotionChecksTest, "ChessGame.Perf.PromotionChecks", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FChessPerftPromotionChecksTest::RunTest(const FString& Parameters)
+{
+	return RunStandardPerft(*this, TEXT("PromotionChecks"));
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChessPerftMiddlegameTest, "ChessGame.Perf.Middlegame", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FChessPerftMiddlegameTest::RunTest(const FString& Parameters)
+{
+	return RunStandardPerft(*this, TEXT("Middlegame"));
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Logic/ChessData.h"
+#include "Logic/ChessPackedMove.h"
+#include "ChessAIPlayerComponent.generated.h"
+
+class AChessBoardActor;
+class UChessGameModel;
+class UChessEvalWeights;
+class FChessTranspositionTable;
+struct FChessAISearchJob;
+struct FChessEvalParams;
+class FChessNNUENetwork;
+
+/**
+ * Computer opponent for one side of a board. Server only.
+ * Each turn the position is copied into private boards, one per search thread, and searched on background
+ * tasks; the game thread never waits on them. The chosen move goes back through the owning controller's Server_SubmitMove, so the AI is
+ * validated exactly like a human player. Only the stock rules are supported.
+ */
+UCLASS( ClassGroup=(Chess), meta=(BlueprintSpawnableComponent) )
+class CHESSGAME_API UChessAIPlayerComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UChessAIPlayerComponent();
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Chess AI")
+	EPieceColor AIColor = EPieceColor::Black;
+
+	// Wall-clock budget per move; zero means depth/node limits only
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Chess AI", meta = (ClampMin = "0.0"))
+	float SearchTimeSeconds = 1.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Chess AI", meta = (ClampMin = "1", ClampMax = "64"))
+	int32 MaxDepth = 64;
+
+	// Node budget per move; zero means unlimited
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Chess AI", meta = (ClampMin = "0"))
+	int64 MaxNodes = 0;
+
+	// Transposition table size, kept for the whole match; capped by the process-wide Chess.AI.HashBudgetMB
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Chess AI", meta = (ClampMin = "1"))
+	int32 HashSizeMB = 16;
+
+	// Search threads per move (Lazy SMP); zero uses the Chess.AI.Threads cvar
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Chess AI", meta = (ClampMin = "0", ClampMax = "64"))
+	int32 SearchThreads = 0;
+
+	// Evaluation weights; the built-in ones when unset. Read when play starts.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Chess AI")
+	UChessEvalWeights* EvalWeights;
+
+	// Neural network weights (see ChessNNUE.h); when set, the search evaluates with them instead of EvalWeights.
+	// Stage the file as a loose non-asset file so it can be memory mapped. Loaded when play starts.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Chess AI", meta = (FilePathFilter = "nnue", RelativeToGameDir))
+	FFilePath NeuralNetworkFile;
+
+	// While the opponent has masked pieces, search with ISMCTS over guesses of what they are instead of reading their true types
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Chess AI")
+	bool bRespectMasks = true;
+
+	// Start playing on BeginPlay instead of waiting for StartPlaying
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Chess AI")
+	bool bAutoStart = true;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Chess AI")
+	AChessBoardActor* Board;
+
+	/** Begins answering AIColor's turns on Board. Retries each tick for a while if the board has no game model yet. */
+	UFUNCTION(BlueprintCallable, Category = "Chess AI")
+	void StartPlaying();
+
+	/** Begins answering AIColor's turns on Model directly. With no Board set, moves are applied to Model itself. */
+	void PlayOn(UChessGameModel* Model);
+
+	/** Cancels any running search and stops reacting to turns. */
+	UFUNCTION(BlueprintCallable, Category = "Chess AI")
+	void StopPlaying();
+
+	UFUNCTION(BlueprintPure, Category = "Chess AI")
+	bool IsThinking() const { return ActiveJob.IsValid(); }
+
+protected:
+	UFUNCTION()
+	void OnTurnChanged(EPieceColor SideToMove);
+
+	UFUNCTION()
+	void OnGameEnded(bool bIsDraw, EPieceColor Winner);
+
+	void StartSearch();
+	void CancelSearch();
+	void OnSearchFinished(const TSharedRef<FChessAISearchJob, ESPMode::ThreadSafe>& Job, FChessPackedMove BestMove);
+	void SubmitMove(FChessPackedMove Move);
+
+	// Ticks StartPlaying waits for the board's game model before giving up
+	static constexpr int32 MaxStartRetries = 120;
+
+	UPROPERTY(Transient)
+	UChessGameModel* BoundModel;
+
+	TSharedPtr<FChessAISearchJob, ESPMode::ThreadSafe> ActiveJob;
+
+	// Ticks StartPlaying has waited so far
+	int32 StartRetries = 0;
+
+	// Allocated by StartPlaying and shared with each job, so a cancelled search can finish with it after we let go
+	TSharedPtr<FChessTranspositionTable, ESPMode::ThreadSafe> Table;
+
+	// Built from EvalWeights by StartPlaying; shared with each job for the same reason as the table
+	TSharedPtr<FChessEvalParams, ESPMode::ThreadSafe> EvalParams;
+
+	// Loaded from NeuralNetworkFile by StartPlaying, if set
+	TSharedPtr<const FChessNNUENetwork, ESPMode::ThreadSafe> Network;
+};
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AI/ChessSearchTypes.h"
+#include <atomic>
+
+class UChessBoardState;
+struct FChessMaskBelief;
+
+struct FChessISMCTSSettings
+{
+	// Tree size limit; once it is full, iterations keep refining the existing nodes without adding more
+	int32 MaxTreeNodes = 1 << 18;
+
+	// UCB exploration constant; rewards are in [0, 1]
+	float Exploration = 0.7f;
+
+	// Random plies played past the tree before the static evaluation is read
+	int32 PlayoutPlies = 4;
+
+	// Centipawn difference that turns into roughly 10:1 odds when evaluations are read as rewards
+	float RewardScale = 400.0f;
+};
+
+/**
+ * Single-observer information set Monte Carlo tree search for positions with masked pieces.
+ *
+ * The searching side sees its own pieces as they are and the opponent's masked pieces only by their masks. Each
+ * iteration draws a determinization: the opponent's masked pieces get their true types shuffled among them,
+ * so the set of types is known but not which piece holds which, or drawn from an FChessMaskBelief that has
+ * narrowed them down from the moves seen so far. Piece counts are treated as public. The tree is keyed by
+ * moves rather than positions, and a move's UCB score counts how often it was available, not how often its parent was
+ * visited. Opponent replies are chosen from the determinized position, as if the opponent saw everything.
+ *
+ * Several threads run iterations against one shared tree, each on its own board. A thread descending through a node
+ * adds a virtual loss to it until its result is backed up, which steers the others to different lines.
+ */
+class CHESSGAME_API FChessISMCTS
+{
+public:
+	/**
+	 * Boards[i] is worker i's, laid out as for ChessSearch::RunWithHelpers. The boards hold true types; the search only
+	 * reads them for the observer's own pieces and for the legal move list at the root, which the game shows the player anyway.
+	 */
+	FChessISMCTS(TArrayView<UChessBoardState* const> InBoards, const FChessISMCTSSettings& InSettings = FChessISMCTSSettings());
+	~FChessISMCTS();
+
+	/**
+	 * Searches the side to move's best move. MaxSeconds and MaxNodes (iterations, across all threads) bound the search;
+	 * MaxDepth is ignored, and a fixed iteration budget applies when neither of the others is set. Score is the best move's average reward expressed in centipawns.
+	 */
+	FChessSearchResult Search(const FChessSearchLimits& Limits, const std::atomic<bool>* StopFlag = nullptr);
+
+	/**
+	 * Draws determinizations from Belief, which must be the searching side's and must outlive the search, instead of
+	 * shuffling all the hidden types uniformly. Null goes back to shuffling.
+	 */
+	void SetBelief(const FChessMaskBelief* InBelief) { Belief = InBelief; }
+
+	/** True if Observer's opponent has masked pieces, i.e. if a perfect-information search would be reading hidden types. */
+	static bool HasHiddenPieces(const UChessBoardState* Board, EPieceColor Observer);
+
+	int32 GetNumThreads() const { return Boards.Num(); }
+
+private:
+	struct FNode;
+	struct FWorker;
+
+	// Helper thread loop: runs iterations until the main thread stops the search
+	void RunWorker(FWorker& Worker);
+	void RunIteration(FWorker& Worker);
+
+	// Assigns the hidden pieces a draw from the belief, or a shuffle of their true types without one. Draws that leave
+	// the opponent without exactly one king, or with it in check on the observer's move, are redrawn; false if none fits.
+	bool Determinize(FWorker& Worker);
+
+	// Plays the playout and returns the reward for the side to move at its start
+	float Playout(FWorker& Worker);
+
+	int32 AllocateNode(FChessPackedMove Move);
+	int32 FindOrAddChild(int32 Parent, FChessPackedMove Move);
+
+	TArray<UChessBoardState*> Boards;
+	TArray<TUniquePtr<FWorker>> Workers;
+	FChessISMCTSSettings Settings;
+
+	FNode* Nodes = nullptr;
+	std::atomic<int32> NumNodes{ 0 };
+
+	// Legal for the observer at the root under the true types, which is what the game lets them play
+	FChessPackedMoveList RootMoves;
+
+	// The observer's opponent's masked pieces and their true types, the pool each determinization shuffles
+	TArray<int32> HiddenIds;
+	TArray<EPieceType> HiddenTypes;
+
+	const FChessMaskBelief* Belief = nullptr;
+
+	EPieceColor Observer = EPieceColor::White;
+
+	// Whether the opponent really has a king, which every determinization must then give them
+	bool bOpponentHasKing = false;
+	std::atomic<bool> bStop{ false };
+	std::atomic<uint64> Iterations{ 0 };
+	uint64 MaxIterations = 0;
+};
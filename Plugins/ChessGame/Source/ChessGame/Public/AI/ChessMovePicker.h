@@ -0,0 +1,63 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AI/ChessSearchTypes.h"
+#include "Logic/ChessBitboards.h"
+#include "Logic/ChessData.h"
+#include "Logic/ChessPackedMove.h"
+
+class UChessBoardState;
+
+/**
+ * Quiet-move ordering statistics gathered during one search thread's work.
+ * Killers are quiet moves that caused a cutoff at the same ply in a sibling subtree; history scores how often a
+ * from/to pair caused cutoffs anywhere. Neither is shared between threads.
+ */
+struct CHESSGAME_API FChessSearchHeuristics
+{
+	// History scores stay within +-MaxHistory, leaving room below the capture and killer bands
+	static constexpr int32 MaxHistory = 16384;
+
+	FChessPackedMove Killers[ChessSearch::MaxPly][2];
+	int32 History[ChessBitboard::NumColors][64][64];
+
+	FChessSearchHeuristics() { Clear(); }
+
+	void Clear();
+
+	/** Called when a new search starts: killers belong to the old position, history only fades. */
+	void NewSearch();
+
+	/** Rewards the quiet move that failed high and penalises the quiet moves tried before it. */
+	void UpdateQuietCutoff(EPieceColor Side, int32 Ply, int32 Depth, FChessPackedMove Best, const FChessPackedMove* TriedQuiets, int32 NumTriedQuiets);
+
+	FORCEINLINE int32 GetHistory(EPieceColor Side, FChessPackedMove Move) const
+	{
+		return History[(uint8)Side][Move.GetFrom()][Move.GetTo()];
+	}
+};
+
+/**
+ * Yields a node's moves best-first: the transposition table move, then captures and queen promotions by
+ * MVV-LVA, then the two killers, then the remaining quiet moves by history, and last the captures that static
+ * exchange evaluation says lose material.
+ * Moves are scored once up front and selected lazily, so a node that cuts off on its first move never pays
+ * for sorting the rest.
+ */
+class CHESSGAME_API FChessMovePicker
+{
+public:
+	FChessMovePicker(const UChessBoardState* Board, FChessPackedMoveList& InMoves, FChessPackedMove TableMove,
+		const FChessSearchHeuristics& Heuristics, int32 Ply);
+
+	/** Returns false once every move has been handed out. */
+	bool Next(FChessPackedMove& OutMove);
+
+	/** Captures (including en passant) and promotions; everything else is quiet and eligible for killer/history. */
+	static bool IsTactical(const UChessBoardState* Board, FChessPackedMove Move);
+
+private:
+	FChessPackedMoveList& Moves;
+	TArray<int32, TInlineAllocator<ChessMoves::MaxMoves>> Scores;
+	int32 Cursor = 0;
+};
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AI/ChessSearch.h"
+
+class UChessBoardState;
+class FChessTranspositionTable;
+
+/**
+ * Lazy SMP: several FChessSearch instances search the same position at once, sharing only the transposition
+ * table. Helpers never exchange moves or bounds directly; what they store in the table steers and shortcuts the
+ * main thread, whose result is the one returned. Each thread keeps its own killers and history.
+ */
+class CHESSGAME_API FChessParallelSearch
+{
+public:
+	/** Boards all hold the position to search and belong to this search alone; Boards[i] is thread i's (see ChessSearch::RunWithHelpers). */
+	FChessParallelSearch(TArrayView<UChessBoardState* const> InBoards, FChessTranspositionTable* InTable);
+
+	/**
+	 * Searches on the calling thread and Boards.Num() - 1 helper tasks. The limits bind the main thread only; helpers
+	 * run until it returns. Node counts include the helpers.
+	 */
+	FChessSearchResult Search(const FChessSearchLimits& Limits, const std::atomic<bool>* StopFlag = nullptr);
+
+	/** Hands every thread the game positions before the root; see FChessSearch::SetGameHistory. */
+	void SetGameHistory(TArrayView<const uint64> Keys);
+
+	int32 GetNumThreads() const { return Boards.Num(); }
+
+	/**
+	 * Thread count for a search: Requested if positive, otherwise the Chess.AI.Threads cvar. Clamped to the
+	 * machine's logical cores and ChessSearch::MaxThreads.
+	 */
+	static int32 ResolveThreadCount(int32 Requested);
+
+private:
+	TArray<UChessBoardState*> Boards;
+	TArray<TUniquePtr<FChessSearch>> Searches;
+};
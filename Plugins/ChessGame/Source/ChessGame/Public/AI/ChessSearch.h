@@ -0,0 +1,63 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AI/ChessSearchTypes.h"
+#include "AI/ChessMovePicker.h"
+#include <atomic>
+
+class UChessBoardState;
+class FChessTranspositionTable;
+
+/**
+ * Iterative-deepening alpha-beta search for the stock rules.
+ * The searched board must be private to the search: it is played on with MakeMove/UnmakeMove and left as it
+ * was found. No other UObject is touched and nothing is allocated per node, so a search may run on any thread.
+ * The optional transposition table may be shared with other searches, including ones running concurrently.
+ */
+class CHESSGAME_API FChessSearch
+{
+public:
+	/** ThreadIndex is nonzero for Lazy SMP helpers, which stagger their iteration depths to diversify the shared table. */
+	explicit FChessSearch(FChessTranspositionTable* InTable = nullptr, int32 InThreadIndex = 0) : Table(InTable), ThreadIndex(InThreadIndex) {}
+
+	/** Searches Board's side to move. StopFlag may be raised from another thread to end the search early. */
+	FChessSearchResult Search(UChessBoardState* InBoard, const FChessSearchLimits& InLimits, const std::atomic<bool>* InStopFlag = nullptr);
+
+	/**
+	 * Keys of the game positions played before the root since the last irreversible move, oldest first. The search
+	 * scores repeating one of them as a draw, just like a repetition on its own path. Kept until replaced.
+	 */
+	void SetGameHistory(TArrayView<const uint64> Keys);
+
+private:
+	int32 AlphaBeta(int32 Depth, int32 Ply, int32 Alpha, int32 Beta);
+
+	// Resolves captures and promotions past the horizon so leaves are not evaluated mid-exchange
+	int32 Quiesce(int32 Ply, int32 Alpha, int32 Beta);
+	int32 Evaluate() const;
+
+	// Fifty-move rule, or a repetition of a position earlier on the current search path or in the game before it
+	bool IsDraw(int32 Ply, uint64 Hash) const;
+
+	void CheckLimits();
+
+	UChessBoardState* Board = nullptr;
+	FChessTranspositionTable* Table = nullptr;
+	int32 ThreadIndex = 0;
+	FChessSearchLimits Limits;
+	const std::atomic<bool>* StopFlag = nullptr;
+
+	double StartTime = 0.0;
+	uint64 Nodes = 0;
+	bool bStopped = false;
+
+	// Move ordering state; persists across Search calls on the same instance
+	FChessSearchHeuristics Heuristics;
+
+	// Position keys along the current line, indexed by ply
+	uint64 PathHashes[ChessSearch::MaxPly + 1] = {};
+
+	// The latest game positions before the root, oldest first; IsDraw reads them as negative plies
+	uint64 GameHashes[ChessSearch::MaxPly] = {};
+	int32 NumGameHashes = 0;
+};
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Logic/ChessBitboards.h"
+#include "Logic/ChessPackedMove.h"
+#include "Tasks/Task.h"
+#include <atomic>
+
+namespace ChessSearch
+{
+	constexpr int32 MaxPly = 128;
+
+	// Scores are centipawns from the side to move's point of view; mates count down from MateScore by ply
+	constexpr int32 Infinity = 32001;
+	constexpr int32 MateScore = 32000;
+	constexpr int32 MateThreshold = MateScore - MaxPly;
+
+	// Upper bound on threads per search, whatever the configuration asks for
+	constexpr int32 MaxThreads = 64;
+
+	/**
+	 * Threading for the multi-threaded searches: Helper(Index) runs on a background task for each Index from 1 to
+	 * NumThreads - 1 while Main() runs on the calling thread. Once Main returns, bStopHelpers is raised and every
+	 * helper is waited for, so helpers must poll the flag. Searches give each index its own board.
+	 */
+	template <typename HelperType, typename MainType>
+	void RunWithHelpers(int32 NumThreads, std::atomic<bool>& bStopHelpers, HelperType&& Helper, MainType&& Main)
+	{
+		TArray<UE::Tasks::TTask<void>> Helpers;
+		for (int32 Index = 1; Index < NumThreads; ++Index)
+		{
+			Helpers.Add(UE::Tasks::Launch(UE_SOURCE_LOCATION, [&Helper, Index]()
+			{
+				Helper(Index);
+			}, ETaskPriority::BackgroundNormal));
+		}
+
+		Main();
+
+		bStopHelpers = true;
+		for (UE::Tasks::TTask<void>& Task : Helpers)
+		{
+			Task.Wait();
+		}
+	}
+}
+
+struct CHESSGAME_API FChessSearchLimits
+{
+	// Deepest iteration to start
+	int32 MaxDepth = 64;
+
+	// Wall-clock budget; zero or less means no time limit
+	double MaxSeconds = 1.0;
+
+	// Node budget; zero means unlimited. Checked every thousand or so nodes, so it may be overshot slightly.
+	uint64 MaxNodes = 0;
+};
+
+struct CHESSGAME_API FChessSearchResult
+{
+	// Null only when the side to move has no legal move
+	FChessPackedMove BestMove;
+
+	int32 Score = 0;
+
+	// Last fully completed iteration; zero if the search was stopped before finishing depth 1
+	int32 Depth = 0;
+
+	uint64 Nodes = 0;
+	double Seconds = 0.0;
+};
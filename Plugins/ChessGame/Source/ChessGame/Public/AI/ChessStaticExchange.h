@@ -0,0 +1,18 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Logic/ChessPackedMove.h"
+
+class UChessBoardState;
+
+/**
+ * Static exchange evaluation: the material balance of the capture sequence a move starts on its target square,
+ * assuming both sides recapture with their least valuable attacker and may stop whenever continuing would lose.
+ * Works on true piece types through the board's attack primitives, so sliders lined up behind the first
+ * attacker join in as the square opens. Pins are ignored.
+ */
+struct CHESSGAME_API FChessStaticExchange
+{
+	/** Expected gain in centipawns for the side making Move; zero for quiet moves. */
+	static int32 Evaluate(const UChessBoardState* Board, FChessPackedMove Move);
+};
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Logic/ChessPackedMove.h"
+#include <atomic>
+
+enum class EChessBound : uint8
+{
+	None = 0,
+	Upper = 1,	// Fail-low: the true score is at most Score
+	Lower = 2,	// Fail-high: the true score is at least Score
+	Exact = 3
+};
+
+struct FChessTTEntry
+{
+	FChessPackedMove Move;
+	int32 Score = 0;
+	int32 Depth = 0;
+	EChessBound Bound = EChessBound::None;
+};
+
+/**
+ * Fixed-size transposition table keyed by Zobrist hash, safe to share between concurrent searches without locks.
+ * Each slot is two 64-bit words, the key XORed with the data and the data itself. A torn read from a racing
+ * writer fails the XOR check and reads as a miss, so no entry is ever trusted for the wrong position.
+ *
+ * Entries carry the generation they were written in. Bumping the generation between searches keeps old results
+ * usable while letting them lose replacement contests to anything fresh, so one table can serve a whole match.
+ *
+ * Every table in the process draws from the Chess.AI.HashBudgetMB budget; a table that would exceed it gets
+ * whatever is left, down to a small floor.
+ */
+class CHESSGAME_API FChessTranspositionTable
+{
+public:
+	FChessTranspositionTable() = default;
+	explicit FChessTranspositionTable(int32 SizeMB) { Resize(SizeMB); }
+	~FChessTranspositionTable();
+
+	FChessTranspositionTable(const FChessTranspositionTable&) = delete;
+	FChessTranspositionTable& operator=(const FChessTranspositionTable&) = delete;
+
+	/** Reallocates and clears. Must not run while a search is using the table. */
+	void Resize(int32 SizeMB);
+
+	/** Forgets every entry. Must not run while a search is using the table. */
+	void Clear();
+
+	/** Starts a new age. Call once per move from the owning thread; safe while a cancelled search is still winding down. */
+	void NewSearch() { Generation.store((Generation.load(std::memory_order_relaxed) + 1) & GenerationMask, std::memory_order_relaxed); }
+
+	/** Looks up Key. Mate scores are converted from root- to Ply-relative. */
+	bool Probe(uint64 Key, int32 Ply, FChessTTEntry& OutEntry) const;
+
+	/** Records a search result. Mate scores are converted from Ply- to root-relative so they stay valid at other plies. */
+	void Store(uint64 Key, int32 Ply, int32 Score, int32 Depth, EChessBound Bound, FChessPackedMove Move);
+
+	/** Allocated size in bytes; may be less than requested once the process budget runs out. */
+	SIZE_T GetSizeBytes() const { return NumBuckets * sizeof(FBucket); }
+
+	/** Per-mille of sampled slots written in the current generation. */
+	int32 GetUsagePermille() const;
+
+private:
+	struct FSlot
+	{
+		std::atomic<uint64> KeyXorData;
+		std::atomic<uint64> Data;
+	};
+
+	// One cache line per bucket, so a probe costs a single memory fetch
+	static constexpr int32 BucketSize = 4;
+	struct alignas(64) FBucket
+	{
+		FSlot Slots[BucketSize];
+	};
+
+	static constexpr uint8 GenerationMask = 63;
+
+	void Free();
+
+	FBucket* Buckets = nullptr;
+	uint64 NumBuckets = 0;
+	std::atomic<uint8> Generation{ 0 };
+};
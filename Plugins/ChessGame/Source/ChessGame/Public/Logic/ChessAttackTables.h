@@ -0,0 +1,97 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ChessData.h"
+#include "ChessBitboards.h"
+
+// Use BMI2 PEXT for slider indexing when the compiler targets it; magic multiplication otherwise.
+#if defined(__BMI2__) && !defined(CHESS_USE_PEXT)
+	#define CHESS_USE_PEXT 1
+#endif
+#ifndef CHESS_USE_PEXT
+	#define CHESS_USE_PEXT 0
+#endif
+
+#if CHESS_USE_PEXT
+	#include <immintrin.h>
+#endif
+
+/**
+ * Magic bitboard entry for one square of one slider kind.
+ */
+struct FChessMagic
+{
+	uint64 Mask = 0;    // Relevant occupancy (ray squares minus board edges)
+	uint64 Magic = 0;
+	uint64* Attacks = nullptr; // Slice of the shared attack table owned by this square
+	uint32 Shift = 0;
+
+	FORCEINLINE uint32 Index(uint64 Occupied) const
+	{
+#if CHESS_USE_PEXT
+		return (uint32)_pext_u64(Occupied, Mask);
+#else
+		return (uint32)(((Occupied & Mask) * Magic) >> Shift);
+#endif
+	}
+};
+
+/**
+ * Precomputed attack sets for every piece type.
+ * Built once by FChessGameModule::StartupModule; all lookups are branch-free table reads afterwards.
+ */
+class CHESSGAME_API FChessAttackTables
+{
+public:
+	/** Builds every table. Safe to call more than once; later calls are no-ops. */
+	static void Initialize();
+
+	static bool IsInitialized() { return bInitialized; }
+
+	FORCEINLINE static uint64 RookAttacks(int32 Square, uint64 Occupied)
+	{
+		const FChessMagic& M = RookMagics[Square];
+		return M.Attacks[M.Index(Occupied)];
+	}
+
+	FORCEINLINE static uint64 BishopAttacks(int32 Square, uint64 Occupied)
+	{
+		const FChessMagic& M = BishopMagics[Square];
+		return M.Attacks[M.Index(Occupied)];
+	}
+
+	FORCEINLINE static uint64 QueenAttacks(int32 Square, uint64 Occupied)
+	{
+		return RookAttacks(Square, Occupied) | BishopAttacks(Square, Occupied);
+	}
+
+	FORCEINLINE static uint64 KnightAttacks(int32 Square) { return KnightTable[Square]; }
+	FORCEINLINE static uint64 KingAttacks(int32 Square) { return KingTable[Square]; }
+
+	/** Squares a pawn of Color standing on Square attacks (diagonal captures only). */
+	FORCEINLINE static uint64 PawnAttacks(EPieceColor Color, int32 Square) { return PawnTable[(uint8)Color][Square]; }
+
+	/** Squares strictly between A and B if they share a rank, file or diagonal; 0 otherwise. */
+	FORCEINLINE static uint64 Between(int32 A, int32 B) { return BetweenTable[A][B]; }
+
+	/** The full edge-to-edge line through A and B if they are aligned; 0 otherwise. */
+	FORCEINLINE static uint64 Line(int32 A, int32 B) { return LineTable[A][B]; }
+
+	/** Attacks for a piece type from Square given the occupancy. Pawns are not handled here (colour dependent). */
+	static uint64 AttacksFor(EPieceType Type, int32 Square, uint64 Occupied);
+
+private:
+	static bool bInitialized;
+
+	static FChessMagic RookMagics[64];
+	static FChessMagic BishopMagics[64];
+
+	static uint64 RookTable[0x19000];
+	static uint64 BishopTable[0x1480];
+
+	static uint64 KnightTable[64];
+	static uint64 KingTable[64];
+	static uint64 PawnTable[2][64];
+	static uint64 BetweenTable[64][64];
+	static uint64 LineTable[64][64];
+};
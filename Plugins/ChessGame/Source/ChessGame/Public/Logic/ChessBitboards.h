@@ -0,0 +1,129 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ChessData.h"
+
+/**
+ * Bitboard helpers. Bit N of a bitboard corresponds to square index N (Rank * 8 + File, A1 = 0).
+ */
+namespace ChessBitboard
+{
+	constexpr uint64 Empty = 0ull;
+	constexpr uint64 All = ~0ull;
+
+	constexpr uint64 FileA = 0x0101010101010101ull;
+	constexpr uint64 FileH = FileA << 7;
+	constexpr uint64 Rank1 = 0xFFull;
+	constexpr uint64 Rank8 = Rank1 << 56;
+	constexpr uint64 DarkSquares = 0xAA55AA55AA55AA55ull; // a1 is dark
+
+	constexpr int32 NumColors = 2;
+	constexpr int32 NumPieceTypes = 6; // Pawn..King, excludes EPieceType::None
+
+	FORCEINLINE constexpr uint64 SquareBit(int32 Square)
+	{
+		return 1ull << Square;
+	}
+
+	FORCEINLINE uint64 SquareBit(FBoardCoord Coord)
+	{
+		return Coord.IsValid() ? SquareBit(Coord.ToIndex()) : Empty;
+	}
+
+	FORCEINLINE constexpr uint64 FileMask(int32 File)
+	{
+		return FileA << File;
+	}
+
+	FORCEINLINE constexpr uint64 RankMask(int32 Rank)
+	{
+		return Rank1 << (Rank * 8);
+	}
+
+	FORCEINLINE int32 PopCount(uint64 Bitboard)
+	{
+		return FMath::CountBits(Bitboard);
+	}
+
+	/** Index of the least significant set bit. Bitboard must be non-zero. */
+	FORCEINLINE int32 Lsb(uint64 Bitboard)
+	{
+		return (int32)FMath::CountTrailingZeros64(Bitboard);
+	}
+
+	/** Returns the least significant set bit index and clears it. Bitboard must be non-zero. */
+	FORCEINLINE int32 PopLsb(uint64& Bitboard)
+	{
+		const int32 Square = Lsb(Bitboard);
+		Bitboard &= Bitboard - 1;
+		return Square;
+	}
+
+	FORCEINLINE constexpr bool IsValidType(EPieceType Type)
+	{
+		return (uint8)Type < NumPieceTypes;
+	}
+}
+
+/**
+ * Occupancy sets mirroring UChessBoardState::Squares.
+ * Per-colour and per-type sets describe TRUE identities; per-mask sets describe the disguise a piece wears.
+ */
+struct CHESSGAME_API FChessBitboards
+{
+	uint64 ByColor[ChessBitboard::NumColors] = {};
+	uint64 ByType[ChessBitboard::NumPieceTypes] = {};
+	uint64 ByMask[ChessBitboard::NumPieceTypes] = {};
+
+	void Reset()
+	{
+		*this = FChessBitboards();
+	}
+
+	FORCEINLINE uint64 Occupied() const
+	{
+		return ByColor[0] | ByColor[1];
+	}
+
+	FORCEINLINE uint64 Pieces(EPieceColor Color, EPieceType Type) const
+	{
+		return ChessBitboard::IsValidType(Type) ? (ByColor[(uint8)Color] & ByType[(uint8)Type]) : ChessBitboard::Empty;
+	}
+
+	/** True type of the piece on Square, or None if it is empty. */
+	FORCEINLINE EPieceType TypeAt(int32 Square) const
+	{
+		const uint64 Bit = ChessBitboard::SquareBit(Square);
+		for (int32 Type = 0; Type < ChessBitboard::NumPieceTypes; ++Type)
+		{
+			if (ByType[Type] & Bit)
+			{
+				return (EPieceType)Type;
+			}
+		}
+		return EPieceType::None;
+	}
+
+	void AddPiece(int32 Square, const FPieceInstance& Piece)
+	{
+		const uint64 Bit = ChessBitboard::SquareBit(Square);
+		ByColor[(uint8)Piece.Color] |= Bit;
+		if (ChessBitboard::IsValidType(Piece.Type))
+		{
+			ByType[(uint8)Piece.Type] |= Bit;
+		}
+		if (ChessBitboard::IsValidType(Piece.MaskType))
+		{
+			ByMask[(uint8)Piece.MaskType] |= Bit;
+		}
+	}
+
+	/** Clears a square from every set regardless of what the caller believes lives there. */
+	void ClearSquare(int32 Square)
+	{
+		const uint64 Keep = ~ChessBitboard::SquareBit(Square);
+		for (uint64& Set : ByColor) Set &= Keep;
+		for (uint64& Set : ByType) Set &= Keep;
+		for (uint64& Set : ByMask) Set &= Keep;
+	}
+};
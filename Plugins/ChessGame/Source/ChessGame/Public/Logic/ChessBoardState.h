@@ -3,8 +3,14 @@
 #include "CoreMinimal.h"
 #include "UObject/NoExportTypes.h"
 #include "ChessData.h"
+#include "ChessBitboards.h"
+#include "ChessZobrist.h"
+#include "ChessPackedMove.h"
 #include "ChessBoardState.generated.h"
 
+struct FChessEvalParams;
+struct FChessNNUEAccumulator;
+
 /**
  * Holds the current state of the chess board.
  * Pure data container with helper accessors.
@@ -17,14 +23,13 @@ class CHESSGAME_API UChessBoardState : public UObject
 public:
 	UChessBoardState();
 
+	// Piece ids index a fixed table. Every setup path numbers pieces from 0 and a board has at most 64 of them.
+	static constexpr int32 MaxPieces = 64;
+
 	// Squares: 0-63. Stores PieceId or -1 if empty.
 	UPROPERTY(BlueprintReadOnly)
 	TArray<int32> Squares;
 
-	// Pieces: Map PieceId -> PieceInstance
-	UPROPERTY(BlueprintReadOnly)
-	TMap<int32, FPieceInstance> Pieces;
-
 	UPROPERTY(BlueprintReadOnly)
 	EPieceColor SideToMove;
 
@@ -52,6 +57,9 @@ public:
 	UPROPERTY(BlueprintReadOnly)
 	bool bIsDraw = false;
 
+	UPROPERTY(BlueprintReadOnly)
+	EChessGameEndReason GameEndReason = EChessGameEndReason::None;
+
 	UPROPERTY(BlueprintReadOnly)
 	bool bInCheck = false;
 
@@ -69,7 +77,129 @@ public:
 	void RemovePiece(int32 PieceId);
 	const FPieceInstance* GetPiece(int32 PieceId) const;
 
+	FORCEINLINE bool HasPiece(int32 PieceId) const
+	{
+		return PieceId >= 0 && PieceId < MaxPieces && (PieceIds & (1ull << PieceId)) != 0;
+	}
+
+	// Live piece ids as bitsets (bit N = PieceId N); walk them with ChessBitboard::PopLsb
+	FORCEINLINE uint64 GetPieceIds() const { return PieceIds; }
+	FORCEINLINE uint64 GetPieceIds(EPieceColor Color) const { return ColorPieceIds[(uint8)Color]; }
+	FORCEINLINE int32 GetNumPieces() const { return ChessBitboard::PopCount(PieceIds); }
+
+	// Square index of PieceId, or -1 if it is not on the board
+	FORCEINLINE int32 GetPieceSquare(int32 PieceId) const { return HasPiece(PieceId) ? PieceSquares[PieceId] : -1; }
+
+	// Blueprint views of the piece table
+	UFUNCTION(BlueprintCallable)
+	bool FindPiece(int32 PieceId, FPieceInstance& OutPiece) const;
+
+	UFUNCTION(BlueprintCallable)
+	TArray<FPieceInstance> GetAllPieces() const;
+
+	// In-place move application. MakeMove fills OutUndo with everything UnmakeMove needs to restore the
+	// exact previous state (captures, en passant, castling rook, promotion, bHasMoved, counters, side to move).
+	// Neither allocates, so they are safe to call in tight loops (legality checks, search).
+	void MakeMove(const FChessMove& Move, FMoveUndoRecord& OutUndo);
+	void MakeMove(FChessPackedMove Move, FMoveUndoRecord& OutUndo) { MakeMove(Move.ToMove(this), OutUndo); }
+	void UnmakeMove(const FMoveUndoRecord& Undo);
+
+	// Identity changes (promotion, masks) must go through these so the bitboards stay in sync
+	void SetPieceType(int32 PieceId, EPieceType NewType);
+	void SetPieceMask(int32 PieceId, EPieceType NewMask);
+
+	// Returns the square holding PieceId, or an invalid coord if it is not on the board
+	FBoardCoord FindPieceCoord(int32 PieceId) const;
+
+	// Bitboard queries (bit N = square index N)
+	FORCEINLINE const FChessBitboards& GetBitboards() const { return Bitboards; }
+	FORCEINLINE uint64 GetOccupancy() const { return Bitboards.Occupied(); }
+	FORCEINLINE uint64 GetColorOccupancy(EPieceColor Color) const { return Bitboards.ByColor[(uint8)Color]; }
+	FORCEINLINE uint64 GetTypeOccupancy(EPieceType Type) const { return ChessBitboard::IsValidType(Type) ? Bitboards.ByType[(uint8)Type] : 0; }
+	FORCEINLINE uint64 GetPieceOccupancy(EPieceColor Color, EPieceType Type) const { return Bitboards.Pieces(Color, Type); }
+	FORCEINLINE uint64 GetMaskOccupancy(EPieceType MaskType) const { return ChessBitboard::IsValidType(MaskType) ? Bitboards.ByMask[(uint8)MaskType] : 0; }
+
+	FORCEINLINE bool IsSquareEmpty(FBoardCoord Coord) const
+	{
+		return Coord.IsValid() && !(GetOccupancy() & ChessBitboard::SquareBit(Coord.ToIndex()));
+	}
+
+	FORCEINLINE bool IsSquareColor(FBoardCoord Coord, EPieceColor Color) const
+	{
+		return Coord.IsValid() && (GetColorOccupancy(Color) & ChessBitboard::SquareBit(Coord.ToIndex())) != 0;
+	}
+
+	// Attack queries on TRUE piece types (masks never attack). Occupied lets callers test hypothetical occupancy.
+	uint64 GetAttackersTo(int32 Square, uint64 Occupied) const;
+	bool IsSquareAttacked(int32 Square, EPieceColor ByColor, uint64 Occupied) const;
+	FORCEINLINE bool IsSquareAttacked(int32 Square, EPieceColor ByColor) const { return IsSquareAttacked(Square, ByColor, GetOccupancy()); }
+
+	// Zobrist key of the position: pieces, masks, castling rights, side to move and en passant file.
+	// Piece placement is maintained incrementally; side/en passant terms are folded in on read.
+	uint64 GetHash() const;
+
+	UFUNCTION(BlueprintCallable)
+	int64 GetPositionHash() const { return (int64)GetHash(); }
+
+	// Material, piece-square and mask terms of the evaluation, from White's point of view. Maintained incrementally
+	// with the placement hash, so reading it is free.
+	FORCEINLINE int32 GetEvalScore() const { return EvalScore; }
+	FORCEINLINE const FChessEvalParams& GetEvalParams() const { return *EvalParams; }
+
+	// Switches the weights behind GetEvalScore and rescores the board. Params must outlive the board, or the next
+	// call; nullptr restores the built-in weights.
+	void SetEvalParams(const FChessEvalParams* Params);
+
+	// Optional neural evaluation input, kept current alongside the eval score. The accumulator must outlive the
+	// board, or the next call; nullptr detaches it.
+	FORCEINLINE const FChessNNUEAccumulator* GetNNUEAccumulator() const { return NNUEAccumulator; }
+	void SetNNUEAccumulator(FChessNNUEAccumulator* Accumulator);
+
+	// Recomputes piece squares, bitboards, the placement hash, the eval score and any accumulator from Squares and the piece table. Only needed
+	// after editing Squares directly.
+	void RebuildDerivedState();
+
 	// Replication Helpers
 	FChessBoardStateData ToStruct() const;
 	void FromStruct(const FChessBoardStateData& Data);
+
+	// Makes this board an exact copy of Other, derived state included, without allocating (after the first call) or
+	// rebuilding anything. Other's eval weights are shared; any NNUE accumulator of this board is detached.
+	void CopyFrom(const UChessBoardState& Other);
+
+	// FEN: the six standard fields plus an optional seventh holding MaskType per square, laid out like the
+	// placement field ("8/8/8/8/8/8/PPPP4/8", letter case ignored, "-" when nothing is masked).
+	// Castling letters refer to the side's king (or the piece masked as king) and the rook in the corner of its rank.
+	// Piece ids are assigned in square order from a1. Returns false and leaves the board empty on malformed input.
+	UFUNCTION(BlueprintCallable)
+	bool LoadFromFEN(const FString& FEN);
+
+	UFUNCTION(BlueprintCallable)
+	FString ToFEN() const;
+
+private:
+	FPieceInstance* GetMutablePiece(int32 PieceId) { return HasPiece(PieceId) ? &PieceTable[PieceId] : nullptr; }
+	void InsertPiece(const FPieceInstance& Piece);
+	void ErasePiece(int32 PieceId);
+
+	// Dense piece storage indexed by PieceId. Only entries whose bit is set in PieceIds are live; erased entries
+	// keep their data, so pointers into the table stay valid across MakeMove/UnmakeMove.
+	FPieceInstance PieceTable[MaxPieces];
+
+	// Square of each live piece, or -1 while it is off the board
+	int8 PieceSquares[MaxPieces];
+
+	uint64 PieceIds = 0;
+	uint64 ColorPieceIds[2] = {};
+
+	FChessBitboards Bitboards;
+
+	// XOR of ChessZobrist::PieceSquareKey for every occupied square
+	uint64 PlacementHash = 0;
+
+	// Sum of EvalParams->PieceScore for every occupied square
+	const FChessEvalParams* EvalParams = nullptr;
+	int32 EvalScore = 0;
+
+	FChessNNUEAccumulator* NNUEAccumulator = nullptr;
 };
@@ -41,7 +41,19 @@ enum class EChessInitMode : uint8
 	Test_KingsOnly,
 	Test_MaskedPawns,
 	Test_MaskSwap, // New Mode
-	Random960
+	Random960,
+	FromFEN
+};
+
+UENUM(BlueprintType)
+enum class EChessGameEndReason : uint8
+{
+	None,
+	Checkmate,
+	Stalemate,
+	ThreefoldRepetition,
+	FiftyMoveRule,
+	InsufficientMaterial
 };
 
 /**
@@ -167,6 +179,18 @@ struct CHESSGAME_API FChessMove
 	FChessMove() {}
 };
 
+namespace ChessMoves
+{
+	// Upper bound on the moves generated from one position (218 in orthodox chess); mask moves rarely add more
+	constexpr int32 MaxMoves = 256;
+
+	// Promotion choices in generation order
+	inline constexpr EPieceType PromotionTypes[] = { EPieceType::Queen, EPieceType::Rook, EPieceType::Bishop, EPieceType::Knight };
+}
+
+// Move buffer for generation. Lives on the stack up to ChessMoves::MaxMoves, so generating moves does not touch the heap.
+using FChessMoveList = TArray<FChessMove, TInlineAllocator<ChessMoves::MaxMoves>>;
+
 /**
  * Minimal state needed to undo a move
  */
@@ -178,12 +202,21 @@ struct CHESSGAME_API FMoveUndoRecord
 	UPROPERTY()
 	FChessMove Move;
 
+	UPROPERTY()
+	bool bPreviousHasEnPassantTarget = false;
+
 	UPROPERTY()
 	FBoardCoord PreviousEnPassantTarget;
 
 	UPROPERTY()
 	bool bPreviousHasMoved = false; // For the moving piece
 
+	UPROPERTY()
+	EPieceType PreviousType = EPieceType::None; // For the moving piece (promotion changes it)
+
+	UPROPERTY()
+	int32 CastlingRookId = -1; // Only relevant for Castling
+
 	UPROPERTY()
 	bool bPreviousRookHasMoved = false; // Only relevant for Castling
 
@@ -193,6 +226,12 @@ struct CHESSGAME_API FMoveUndoRecord
 	UPROPERTY()
 	FBoardCoord CapturedPieceCoord; // Where the piece was (might be different from To in EnPassant)
 
+	UPROPERTY()
+	FPieceInstance CapturedPiece; // Full copy so the piece can be restored exactly
+
+	UPROPERTY()
+	int32 PreviousHalfmoveClock = 0;
+
 	FMoveUndoRecord() {}
 };
 
@@ -242,6 +281,9 @@ struct CHESSGAME_API FChessBoardStateData
 	UPROPERTY(BlueprintReadOnly)
 	bool bIsDraw = false;
 
+	UPROPERTY(BlueprintReadOnly)
+	EChessGameEndReason GameEndReason = EChessGameEndReason::None;
+
 	UPROPERTY(BlueprintReadOnly)
 	bool bInCheck = false;
 
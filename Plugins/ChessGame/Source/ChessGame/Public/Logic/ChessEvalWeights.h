@@ -0,0 +1,54 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "Logic/ChessData.h"
+#include "ChessEvalWeights.generated.h"
+
+struct FChessEvalParams;
+
+USTRUCT(BlueprintType)
+struct FChessPieceEvalWeights
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Evaluation")
+	int32 Material = 0;
+
+	// 64 bonuses as White sees the board: rank 8 first, a-file first in each rank. Black uses it mirrored.
+	// Any other length keeps the built-in table for this piece.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Evaluation")
+	TArray<int32> SquareBonus;
+};
+
+/**
+ * Designer-tunable evaluation weights for the AI, in centipawns.
+ * Pieces missing from the map keep the built-in values.
+ */
+UCLASS(BlueprintType)
+class CHESSGAME_API UChessEvalWeights : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Pieces")
+	TMap<EPieceType, FChessPieceEvalWeights> Pieces;
+
+	// Value of keeping the opponent guessing, paid for any piece whose mask differs from its true type
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Masks")
+	int32 MaskFlatBonus = 10;
+
+	// Plus this percentage of the material gap between the true type and the mask
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Masks", meta = (ClampMin = "0", ClampMax = "100"))
+	int32 MaskGapPercent = 10;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Bonuses")
+	int32 BishopPairBonus = 30;
+
+	// Credit for having the move
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Bonuses")
+	int32 TempoBonus = 10;
+
+	/** Flattens the asset into the tables boards score with. */
+	void BuildParams(FChessEvalParams& OutParams) const;
+};
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ChessData.h"
+#include "ChessBitboards.h"
+
+class UChessBoardState;
+
+/**
+ * Evaluation weights in the form the board consumes. Material, piece-square and mask terms are folded into
+ * one signed table per piece, from White's point of view, so a board keeps their sum up to date with one lookup
+ * per piece it places or lifts. Built from UChessEvalWeights, or the built-in defaults.
+ */
+struct CHESSGAME_API FChessEvalParams
+{
+	// Material plus square bonus for a piece of [Color][Type] on [Square]; Black's entries are negative
+	int32 PieceSquare[ChessBitboard::NumColors][ChessBitboard::NumPieceTypes][64] = {};
+
+	// Extra value of a [Color][Type] piece wearing a [Mask], signed like PieceSquare; zero for an honest mask
+	int32 Mask[ChessBitboard::NumColors][ChessBitboard::NumPieceTypes][ChessBitboard::NumPieceTypes] = {};
+
+	// Terms worked out at evaluation time rather than maintained by the board
+	int32 BishopPairBonus = 0;
+	int32 TempoBonus = 0;
+
+	/**
+	 * Fills the tables. Material is indexed by EPieceType. SquareBonus holds one 64-entry table per type, laid out
+	 * as White sees the board: rank 8 first, a-file first in each rank. Black uses the same tables mirrored.
+	 * A masked piece is worth MaskFlatBonus plus MaskGapPercent of the material gap between what it is and what it shows.
+	 */
+	void Build(const int32 (&Material)[ChessBitboard::NumPieceTypes], const int32 (&SquareBonus)[ChessBitboard::NumPieceTypes][64],
+		int32 MaskFlatBonus, int32 MaskGapPercent);
+
+	/** What Piece on Square contributes to the board's running score. */
+	FORCEINLINE int32 PieceScore(const FPieceInstance& Piece, int32 Square) const
+	{
+		if (!ChessBitboard::IsValidType(Piece.Type))
+		{
+			return 0;
+		}
+		int32 Score = PieceSquare[(uint8)Piece.Color][(uint8)Piece.Type][Square];
+		if (ChessBitboard::IsValidType(Piece.MaskType))
+		{
+			Score += Mask[(uint8)Piece.Color][(uint8)Piece.Type][(uint8)Piece.MaskType];
+		}
+		return Score;
+	}
+
+	/** Built-in weights, used by every board until it is given others. */
+	static const FChessEvalParams& GetDefault();
+
+	// Built-in material and square tables, in the layout Build expects
+	static const int32 DefaultMaterial[ChessBitboard::NumPieceTypes];
+	static const int32 DefaultSquareBonus[ChessBitboard::NumPieceTypes][64];
+	static constexpr int32 DefaultMaskFlatBonus = 10;
+	static constexpr int32 DefaultMaskGapPercent = 10;
+	static constexpr int32 DefaultBishopPairBonus = 30;
+	static constexpr int32 DefaultTempoBonus = 10;
+};
+
+/**
+ * Static evaluation for search leaves. The board's running score supplies material, squares and masks; the
+ * few remaining terms only need bitboard counts, so a call costs the same whatever the position.
+ */
+struct CHESSGAME_API FChessEvaluation
+{
+	/** Centipawns from the side to move's point of view. Boards with a neural accumulator attached use the network instead. */
+	static int32 Evaluate(const UChessBoardState* Board);
+
+	/** Sums the board's running score from scratch. Matches UChessBoardState::GetEvalScore on a consistent board. */
+	static int32 ComputeBoardScore(const UChessBoardState* Board, const FChessEvalParams& Params);
+};
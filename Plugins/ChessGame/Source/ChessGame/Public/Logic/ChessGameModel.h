@@ -5,6 +5,9 @@
 #include "ChessData.h"
 #include "ChessBoardState.h"
 #include "ChessRuleSet.h"
+#include "ChessPositionHistory.h"
+#include "ChessLegalMoveCache.h"
+#include "ChessMaskBelief.h"
 #include "ChessGameModel.generated.h"
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnMoveApplied, const FChessMove&, Move);
@@ -54,6 +57,10 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Chess Configuration")
 	EChessInitMode InitMode = EChessInitMode::Standard;
 
+	// Starting position when InitMode is FromFEN (see UChessBoardState::LoadFromFEN for the mask extension)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Chess Configuration")
+	FString InitFEN;
+
 	// API
 	UFUNCTION(BlueprintCallable)
 	void InitializeGame();
@@ -70,6 +77,40 @@ public:
 	UFUNCTION(BlueprintCallable)
 	void SetPieceMask(int32 PieceId, EPieceType NewMask);
 
+	// Takes PieceId off the board outside of a move (card effects) and broadcasts OnPieceCaptured
+	UFUNCTION(BlueprintCallable)
+	void RemovePiece(int32 PieceId);
+
+	// How many times the current position has occurred since the last irreversible move
+	UFUNCTION(BlueprintCallable)
+	int32 GetRepetitionCount() const;
+
+	// Position keys since the last irreversible move, oldest first and ending with the current position
+	void GetPositionKeys(TArray<uint64>& OutKeys) const;
+
+	// Moves played since InitializeGame, packed. Replaying them from the starting position reproduces the game.
+	const TArray<FChessPackedMove>& GetMoveLog() const { return MoveLog; }
+
+	// What Observer can tell about the true types behind the other side's masks, kept current move by move
+	const FChessMaskBelief& GetMaskBelief(EPieceColor Observer) const { return MaskBeliefs[(uint8)Observer]; }
+
 protected:
 	void ApplyMoveInternal(const FChessMove& Move);
+
+	// Returns true (after broadcasting) if the position just reached ends the game
+	bool CheckGameEnd();
+	void EndGame(bool bIsDraw, EPieceColor Winner, EChessGameEndReason Reason);
+
+	// Positions since the last capture or pawn move, for repetition detection
+	FChessPositionHistory PositionHistory;
+
+	// Legal moves of the side to move, generated on first use so highlights, clicks and validation share one pass
+	const FChessLegalMoveCache& GetLegalMoveCache();
+	FChessLegalMoveCache LegalMoveCache;
+
+	// Indexed by the observing side
+	FChessMaskBelief MaskBeliefs[2];
+
+	UPROPERTY()
+	TArray<FChessPackedMove> MoveLog;
 };
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ChessData.h"
+
+/**
+ * Legal moves of the side to move in one position, grouped by from-square.
+ * Entries are tagged with the position's hash, so a board edited behind the owner's back (replication,
+ * debug tools) never serves stale moves; the owner still invalidates explicitly whenever it changes the board.
+ */
+struct FChessLegalMoveCache
+{
+	bool IsValidFor(uint64 Hash) const { return bValid && PositionHash == Hash; }
+
+	void Invalidate() { bValid = false; }
+
+	/** Replaces the contents. Moves must be grouped by ascending from-square, the order side-wide generation yields. */
+	void Fill(uint64 Hash, const FChessMove* InMoves, int32 NumMoves)
+	{
+		Moves.Reset();
+		Moves.Append(InMoves, NumMoves);
+
+		// FirstMove[Square] is the first move starting on Square or later; FirstMove[64] closes the last range
+		int32 Index = 0;
+		for (int32 Square = 0; Square <= 64; ++Square)
+		{
+			while (Index < Moves.Num() && Moves[Index].From.ToIndex() < Square)
+			{
+				++Index;
+			}
+			FirstMove[Square] = Index;
+		}
+
+		PositionHash = Hash;
+		bValid = true;
+	}
+
+	TArrayView<const FChessMove> GetMovesFrom(int32 Square) const
+	{
+		if (Square < 0 || Square >= 64)
+		{
+			return TArrayView<const FChessMove>();
+		}
+		return TArrayView<const FChessMove>(Moves.GetData() + FirstMove[Square], FirstMove[Square + 1] - FirstMove[Square]);
+	}
+
+	const TArray<FChessMove>& GetMoves() const { return Moves; }
+
+private:
+	TArray<FChessMove> Moves;
+	int32 FirstMove[65] = {};
+	uint64 PositionHash = 0;
+	bool bValid = false;
+};
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ChessData.h"
+#include "ChessBitboards.h"
+#include "ChessPackedMove.h"
+
+class UChessBoardState;
+
+/**
+ * Check and pin information for one side, computed once per position.
+ */
+struct CHESSGAME_API FChessCheckInfo
+{
+	EPieceColor Us = EPieceColor::White;
+	EPieceColor Them = EPieceColor::Black;
+	int32 KingSquare = -1;
+
+	// Enemy pieces currently giving check
+	uint64 Checkers = 0;
+
+	// Own pieces that are the only blocker between our king and an enemy slider
+	uint64 Pinned = 0;
+
+	// Squares a non-king move must land on to resolve a single check (checker + interposition squares); all squares otherwise
+	uint64 CheckMask = ChessBitboard::All;
+
+	/** Fills the info for Side. Returns false if Side does not have exactly one king (callers must fall back to simulation). */
+	bool Init(const UChessBoardState* Board, EPieceColor Side);
+
+	FORCEINLINE bool IsInCheck() const { return Checkers != 0; }
+	FORCEINLINE bool IsDoubleCheck() const { return (Checkers & (Checkers - 1)) != 0; }
+
+	/** Destination squares that keep the king safe for a non-king piece standing on FromSquare. */
+	uint64 GetTargetMask(int32 FromSquare) const;
+};
+
+/**
+ * Fully legal move generator for the stock rules.
+ * Ordinary moves are filtered with the check/pin masks; castling and en passant get an exact test on the occupancy
+ * the move would leave. Nothing here writes to the board.
+ * Mask moves follow UChessRuleSet semantics: the mask type's non-capturing moves, deduplicated by target square.
+ */
+class CHESSGAME_API FChessLegalMoveGenerator
+{
+public:
+	/** Appends every legal move of PieceId. Info must have been built for the piece's colour on the same position. */
+	static void GeneratePieceMoves(const UChessBoardState* Board, const FChessCheckInfo& Info, int32 PieceId, FChessMoveList& OutMoves);
+	static void GeneratePieceMoves(const UChessBoardState* Board, const FChessCheckInfo& Info, int32 PieceId, FChessPackedMoveList& OutMoves);
+
+	/** Appends every legal move of Info's side in ascending from-square order, sharing one check/pin computation. */
+	static void GenerateAllMoves(const UChessBoardState* Board, const FChessCheckInfo& Info, FChessMoveList& OutMoves);
+	static void GenerateAllMoves(const UChessBoardState* Board, const FChessCheckInfo& Info, FChessPackedMoveList& OutMoves);
+
+	/** Appends only Info's side's legal captures (en passant included) and promotions, mask-pawn promotions included. */
+	static void GenerateTacticalMoves(const UChessBoardState* Board, const FChessCheckInfo& Info, FChessPackedMoveList& OutMoves);
+
+	/** True if Info's side has at least one legal move. Tries the king, then unpinned, then pinned pieces and stops at the first hit. */
+	static bool HasAnyLegalMove(const UChessBoardState* Board, const FChessCheckInfo& Info);
+
+	/** Exact legality test for castling and en passant, worked out from bitboards without playing the move. */
+	static bool IsSpecialMoveLegal(const UChessBoardState* Board, const FChessMove& Move);
+};
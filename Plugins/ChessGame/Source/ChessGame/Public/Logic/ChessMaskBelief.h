@@ -0,0 +1,95 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ChessData.h"
+#include "ChessBitboards.h"
+
+class UChessBoardState;
+struct FRandomStream;
+
+/**
+ * What one player can work out about the true types behind the opponent's masks.
+ *
+ * Every opponent piece that is masked when the game starts gets a slot holding a bitset of the types it could
+ * still be. The number of each true type among the slots is taken as public, as Test_MaskSwap deals each side the
+ * standard set, so the slots form an exact pool. Observing a move narrows the mover's set: a masked piece may also
+ * make its mask's quiet moves, so only moves the mask cannot explain (captures, en passant, castling past a
+ * non-king mask, anything off the mask's pattern) say anything about the piece underneath. Narrowed sets then
+ * propagate through the counts: once all the knights are accounted for, nobody else can be one, and the last
+ * pieces that could be a rook must be the rooks.
+ *
+ * A captured or promoted piece keeps its slot off the board, so the counts stay exact without anyone learning
+ * what it was. Pieces whose type the observer has seen (unmasked, or masked later in the game) get no slot.
+ *
+ * Each observation costs a few passes over the slots; nothing is replayed from the game history.
+ */
+struct CHESSGAME_API FChessMaskBelief
+{
+	static constexpr int32 MaxSlots = 64;
+	static constexpr uint8 AllTypes = (1 << ChessBitboard::NumPieceTypes) - 1;
+
+	FChessMaskBelief() { FMemory::Memset(PieceSlots, 0xFF, sizeof(PieceSlots)); }
+
+	/** Starts tracking Observer's opponent's masked pieces on Board, with nothing ruled out beyond the counts. */
+	void Reset(const UChessBoardState* Board, EPieceColor InObserver);
+
+	/** Narrows the beliefs with Move, which Board is about to make. Call before the board changes. */
+	void ObserveMove(const UChessBoardState* Board, const FChessMove& Move);
+
+	/** Accounts for PieceId having just had its mask set or cleared on Board. */
+	void ObserveMaskChange(const UChessBoardState* Board, int32 PieceId);
+
+	/** Accounts for PieceId having left the board outside of a move. */
+	void ObserveRemoval(int32 PieceId);
+
+	/** True if PieceId is an opponent piece whose type the observer does not know for certain. */
+	bool IsHidden(int32 PieceId) const;
+
+	/** Bitset over EPieceType of what PieceId could be; only its own type for pieces without a slot. */
+	uint8 GetPossibleTypes(const UChessBoardState* Board, int32 PieceId) const;
+
+	/** Rough chance that PieceId is Type: the pool's remaining counts shared over its possible types. */
+	float GetProbability(const UChessBoardState* Board, int32 PieceId, EPieceType Type) const;
+
+	/**
+	 * Draws true types for every hidden piece, consistent with the sets and the counts, into OutTypes indexed by
+	 * piece id. Entries for other pieces are left alone. One pass over the slots, most constrained first; a draw
+	 * that paints itself into a corner is retried, and the last attempt relaxes the counts rather than fail.
+	 */
+	void Sample(FRandomStream& Rng, EPieceType (&OutTypes)[MaxSlots]) const;
+
+	EPieceColor GetObserver() const { return Observer; }
+	int32 GetNumSlots() const { return NumSlots; }
+
+private:
+	struct FSlot
+	{
+		// Bitset over EPieceType
+		uint8 Possible = AllTypes;
+		int8 PieceId = INDEX_NONE;
+		bool bOnBoard = false;
+	};
+
+	// Intersects a slot's set with Types, ignoring observations that would leave it empty
+	bool Restrict(int32 Slot, uint8 Types);
+
+	// Applies the count rules until nothing changes, then refreshes SampleOrder
+	void Propagate();
+
+	// Slot of an opponent piece still wearing its original uncertainty, or INDEX_NONE
+	int32 GetSlot(int32 PieceId) const;
+
+	FSlot Slots[MaxSlots];
+	int32 NumSlots = 0;
+
+	// Slot index per piece id, INDEX_NONE for pieces without one
+	int8 PieceSlots[MaxSlots];
+
+	// How many slots hold each true type, on the board or not
+	int8 Counts[ChessBitboard::NumPieceTypes] = {};
+
+	// Slots in the order Sample assigns them: fewest possibilities first
+	int8 SampleOrder[MaxSlots];
+
+	EPieceColor Observer = EPieceColor::White;
+};
@@ -1,29 +1,36 @@
 #pragma once
 
 #include "CoreMinimal.h"
-#include "GameFramework/Actor.h"
+#include "UObject/Object.h"
 #include "ChessData.h"
 #include "ChessBoardState.h"
 #include "ChessMoveRule.generated.h"
 
 /**
- * Base class for move rules. Note: Inherits from AActor.
+ * Base class for move rules. Plain UObjects with no world or game state: a rule only reads the board it is given,
+ * so one instance can serve any number of boards. Blueprint subclasses override GenerateMoves for custom rules.
  */
-UCLASS(Abstract, Blueprintable)
-class CHESSGAME_API AChessMoveRule : public AActor
+UCLASS(Abstract, Blueprintable, EditInlineNew)
+class CHESSGAME_API UChessMoveRule : public UObject
 {
 	GENERATED_BODY()
 
 public:
-	AChessMoveRule();
-
 	UFUNCTION(BlueprintNativeEvent, BlueprintCallable)
 	void GenerateMoves(const UChessBoardState* Board, FBoardCoord From, const FPieceInstance& Piece, TArray<FChessMove>& OutMoves) const;
-	virtual void GenerateMoves_Implementation(const UChessBoardState* Board, FBoardCoord From, const FPieceInstance& Piece, TArray<FChessMove>& OutMoves) const PURE_VIRTUAL(AChessMoveRule::GenerateMoves_Implementation, );
+	virtual void GenerateMoves_Implementation(const UChessBoardState* Board, FBoardCoord From, const FPieceInstance& Piece, TArray<FChessMove>& OutMoves) const;
+
+	// C++ entry point. Native rules are called directly, skipping the Blueprint event dispatch, which also makes
+	// them safe to use off the game thread; Blueprint rules still go through GenerateMoves.
+	void Generate(const UChessBoardState* Board, FBoardCoord From, const FPieceInstance& Piece, FChessMoveList& OutMoves) const;
 
 protected:
+	// Native generation into a stack buffer. Native subclasses override this; GenerateMoves_Implementation forwards
+	// here so Blueprint callers see the same moves. The base generates nothing.
+	virtual void GenerateNativeMoves(const UChessBoardState* Board, FBoardCoord From, const FPieceInstance& Piece, FChessMoveList& OutMoves) const;
+
 	// Helpers commonly used in move generation
-	void AddMove(TArray<FChessMove>& OutMoves, FBoardCoord From, FBoardCoord To, const FPieceInstance& MovingPiece, int32 CapturedPieceId = -1) const;
+	void AddMove(FChessMoveList& OutMoves, FBoardCoord From, FBoardCoord To, const FPieceInstance& MovingPiece, int32 CapturedPieceId = -1) const;
 	bool IsSameColor(const UChessBoardState* Board, FBoardCoord Coord, EPieceColor Color) const;
 	bool IsEnemy(const UChessBoardState* Board, FBoardCoord Coord, EPieceColor Color) const;
 	bool IsEmpty(const UChessBoardState* Board, FBoardCoord Coord) const;
@@ -33,7 +40,7 @@ protected:
  * Rule for Sliding pieces (Rook, Bishop, Queen)
  */
 UCLASS()
-class CHESSGAME_API AChessMoveRule_Sliding : public AChessMoveRule
+class CHESSGAME_API UChessMoveRule_Sliding : public UChessMoveRule
 {
 	GENERATED_BODY()
 
@@ -44,41 +51,42 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	bool bOrthogonal = false;
 
-	virtual void GenerateMoves_Implementation(const UChessBoardState* Board, FBoardCoord From, const FPieceInstance& Piece, TArray<FChessMove>& OutMoves) const override;
+protected:
+	virtual void GenerateNativeMoves(const UChessBoardState* Board, FBoardCoord From, const FPieceInstance& Piece, FChessMoveList& OutMoves) const override;
 };
 
 /**
  * Rule for Knights
  */
 UCLASS()
-class CHESSGAME_API AChessMoveRule_Knight : public AChessMoveRule
+class CHESSGAME_API UChessMoveRule_Knight : public UChessMoveRule
 {
 	GENERATED_BODY()
 
-public:
-	virtual void GenerateMoves_Implementation(const UChessBoardState* Board, FBoardCoord From, const FPieceInstance& Piece, TArray<FChessMove>& OutMoves) const override;
+protected:
+	virtual void GenerateNativeMoves(const UChessBoardState* Board, FBoardCoord From, const FPieceInstance& Piece, FChessMoveList& OutMoves) const override;
 };
 
 /**
  * Rule for Pawns
  */
 UCLASS()
-class CHESSGAME_API AChessMoveRule_Pawn : public AChessMoveRule
+class CHESSGAME_API UChessMoveRule_Pawn : public UChessMoveRule
 {
 	GENERATED_BODY()
 
-public:
-	virtual void GenerateMoves_Implementation(const UChessBoardState* Board, FBoardCoord From, const FPieceInstance& Piece, TArray<FChessMove>& OutMoves) const override;
+protected:
+	virtual void GenerateNativeMoves(const UChessBoardState* Board, FBoardCoord From, const FPieceInstance& Piece, FChessMoveList& OutMoves) const override;
 };
 
 /**
  * Rule for King
  */
 UCLASS()
-class CHESSGAME_API AChessMoveRule_King : public AChessMoveRule
+class CHESSGAME_API UChessMoveRule_King : public UChessMoveRule
 {
 	GENERATED_BODY()
 
-public:
-	virtual void GenerateMoves_Implementation(const UChessBoardState* Board, FBoardCoord From, const FPieceInstance& Piece, TArray<FChessMove>& OutMoves) const override;
+protected:
+	virtual void GenerateNativeMoves(const UChessBoardState* Board, FBoardCoord From, const FPieceInstance& Piece, FChessMoveList& OutMoves) const override;
 };
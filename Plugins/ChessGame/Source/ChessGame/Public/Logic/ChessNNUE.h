@@ -0,0 +1,151 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ChessData.h"
+#include "ChessBitboards.h"
+
+class UChessBoardState;
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/**
+ * Efficiently updatable neural evaluation.
+ *
+ * Inputs are one-hot (relative colour, piece type, square) features seen from each side, plus the same again for
+ * masks, so a board position lights up at most two features per piece. The first layer is a plain sum of the
+ * weight rows of the lit features, kept per side in an FChessNNUEAccumulator that the board updates as pieces are
+ * placed and lifted. Evaluation then only runs the small dense layers:
+ *
+ *   [side to move, other side] accumulators (2 x L1 int16) -> clipped ReLU (uint8)
+ *   -> L2 (int8 weights) -> clipped ReLU (uint8) -> 1 (int8 weights) -> centipawns
+ *
+ * Kernels use AVX2, SSSE3 or NEON when the target guarantees them, and portable scalar code otherwise.
+ */
+namespace ChessNNUE
+{
+	constexpr int32 NumFeatures = 2 * 2 * ChessBitboard::NumPieceTypes * 64;
+	constexpr int32 L1 = 256;
+	constexpr int32 L2 = 32;
+
+	// Clipped ReLU ceiling for both hidden layers; also the fixed-point one of the accumulator
+	constexpr int32 ActivationMax = 127;
+
+	// L2 sums are scaled back down by this many bits before their activation
+	constexpr int32 L2Shift = 6;
+
+	// The output neuron counts in 1/OutputDivisor centipawns
+	constexpr int32 OutputDivisor = 16;
+
+	// Evaluations are clamped to this, well clear of the scores search uses for mates
+	constexpr int32 MaxScore = 30000;
+
+	constexpr uint32 FileMagic = 0x554E4E43; // "CNNU"
+	constexpr uint32 FileVersion = 1;
+
+	/**
+	 * Weight file layout, little endian. Every section starts on a 64-byte boundary, so a mapped file can be read
+	 * in place. Header fields other than the magic must match the constants above.
+	 *
+	 *   FFileHeader                      64 bytes
+	 *   int16 FeatureBias[L1]
+	 *   int16 FeatureWeights[NumFeatures][L1]
+	 *   int32 L2Bias[L2]
+	 *   int8  L2Weights[L2][2 * L1]
+	 *   int32 OutputBias                 padded to 64 bytes
+	 *   int8  OutputWeights[L2]          padded to 64 bytes
+	 */
+	struct FFileHeader
+	{
+		uint32 Magic = FileMagic;
+		uint32 Version = FileVersion;
+		uint32 NumFeatures = ChessNNUE::NumFeatures;
+		uint32 L1 = ChessNNUE::L1;
+		uint32 L2 = ChessNNUE::L2;
+		uint32 Reserved[11] = {};
+	};
+	static_assert(sizeof(FFileHeader) == 64, "Header must keep the sections that follow it 64-byte aligned");
+
+	/** Total size of a valid weight file. */
+	int64 GetFileSize();
+
+	/** Index of the feature a piece (or, with bMask, its mask type) of Color and Type on Square lights for Perspective. */
+	FORCEINLINE int32 FeatureIndex(EPieceColor Perspective, EPieceColor Color, EPieceType Type, int32 Square, bool bMask)
+	{
+		const int32 Relative = (Color == Perspective) ? 0 : 1;
+		const int32 Oriented = (Perspective == EPieceColor::White) ? Square : (Square ^ 56);
+		return (((bMask ? 2 : 0) + Relative) * ChessBitboard::NumPieceTypes + (int32)Type) * 64 + Oriented;
+	}
+}
+
+class FChessNNUENetwork;
+
+/**
+ * First-layer output for both perspectives. Attach one to a board with UChessBoardState::SetNNUEAccumulator and
+ * the board keeps it current through every placement change, make/unmake included.
+ */
+struct CHESSGAME_API FChessNNUEAccumulator
+{
+	explicit FChessNNUEAccumulator(const FChessNNUENetwork& InNetwork) : Network(&InNetwork) {}
+
+	void AddPiece(const FPieceInstance& Piece, int32 Square);
+	void RemovePiece(const FPieceInstance& Piece, int32 Square);
+
+	/** Recomputes both perspectives from the board's pieces. */
+	void Refresh(const UChessBoardState* Board);
+
+	const FChessNNUENetwork& GetNetwork() const { return *Network; }
+
+	// Indexed by EPieceColor
+	alignas(64) int16 Values[ChessBitboard::NumColors][ChessNNUE::L1];
+
+private:
+	const FChessNNUENetwork* Network;
+};
+
+/**
+ * A loaded set of weights. Immutable once created, so any number of searches may share one across threads.
+ */
+class CHESSGAME_API FChessNNUENetwork
+{
+public:
+	~FChessNNUENetwork();
+
+	/**
+	 * Maps a weight file into memory, falling back to reading it when the platform cannot map it (e.g. inside a pak).
+	 * Relative paths resolve against the project directory. Logs and returns null if the file is missing or malformed.
+	 */
+	static TSharedPtr<const FChessNNUENetwork, ESPMode::ThreadSafe> LoadFromFile(const FString& Path);
+
+	/** Takes ownership of a weight file already in memory. */
+	static TSharedPtr<const FChessNNUENetwork, ESPMode::ThreadSafe> CreateFromBytes(TArray<uint8>&& Bytes);
+
+	/** Centipawns from SideToMove's point of view, using the fastest kernels the target supports. */
+	int32 Evaluate(const FChessNNUEAccumulator& Accumulator, EPieceColor SideToMove) const;
+
+	/** Same result through the portable kernels only. */
+	int32 EvaluateScalar(const FChessNNUEAccumulator& Accumulator, EPieceColor SideToMove) const;
+
+	const int16* GetFeatureBias() const { return FeatureBias; }
+	const int16* GetFeatureRow(int32 Feature) const { return FeatureWeights + (int64)Feature * ChessNNUE::L1; }
+
+private:
+	FChessNNUENetwork() = default;
+
+	// Points the layer views into Data, which must hold a whole weight file. False if the header does not match.
+	bool Bind(const uint8* Data, int64 Size);
+
+	template <typename Kernels>
+	int32 Forward(const FChessNNUEAccumulator& Accumulator, EPieceColor SideToMove) const;
+
+	// Backing storage: either a mapped file or an owned copy
+	TUniquePtr<IMappedFileHandle> MappedFile;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+	TArray<uint8> Bytes;
+
+	const int16* FeatureBias = nullptr;
+	const int16* FeatureWeights = nullptr;
+	const int32* L2Bias = nullptr;
+	const int8* L2Weights = nullptr;
+	int32 OutputBias = 0;
+	const int8* OutputWeights = nullptr;
+};
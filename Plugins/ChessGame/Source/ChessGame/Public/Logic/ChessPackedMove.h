@@ -0,0 +1,57 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ChessData.h"
+#include "ChessPackedMove.generated.h"
+
+class UChessBoardState;
+
+/**
+ * A move in 16 bits: from square (0-5), to square (6-11), promotion piece (12-13) and special type (14-15).
+ * Piece ids are not stored; they are read back from the board the move is played on, so a packed move
+ * converts losslessly to the FChessMove the generators produced for that position.
+ * Used by generators, search and move logs where FChessMove's 28 bytes add up.
+ */
+USTRUCT()
+struct CHESSGAME_API FChessPackedMove
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	uint16 Data = 0;
+
+	FChessPackedMove() {}
+	explicit FChessPackedMove(uint16 InData) : Data(InData) {}
+
+	FORCEINLINE static FChessPackedMove Make(int32 From, int32 To, ESpecialMoveType Special = ESpecialMoveType::Normal, EPieceType Promotion = EPieceType::None)
+	{
+		// Promotion pieces Knight..Queen map to 0..3; anything else is stored as 0 and ignored on unpack
+		const uint32 PromotionBits = (Special == ESpecialMoveType::Promotion) ? ((uint32)Promotion - (uint32)EPieceType::Knight) & 3 : 0;
+		return FChessPackedMove((uint16)(From | (To << 6) | (PromotionBits << 12) | ((uint32)Special << 14)));
+	}
+
+	static FChessPackedMove FromMove(const FChessMove& Move)
+	{
+		return Make(Move.From.ToIndex(), Move.To.ToIndex(), Move.SpecialType, Move.PromotionType);
+	}
+
+	/** Rebuilds the full move for Board, the position the move is to be played from (piece ids come from its squares). */
+	FChessMove ToMove(const UChessBoardState* Board) const;
+
+	FORCEINLINE int32 GetFrom() const { return Data & 63; }
+	FORCEINLINE int32 GetTo() const { return (Data >> 6) & 63; }
+	FORCEINLINE ESpecialMoveType GetSpecialType() const { return (ESpecialMoveType)(Data >> 14); }
+	FORCEINLINE EPieceType GetPromotionType() const
+	{
+		return GetSpecialType() == ESpecialMoveType::Promotion ? (EPieceType)((uint32)EPieceType::Knight + ((Data >> 12) & 3)) : EPieceType::None;
+	}
+
+	// a1a1 is never a legal move, so all-zero doubles as "no move"
+	FORCEINLINE bool IsNull() const { return Data == 0; }
+
+	FORCEINLINE bool operator==(const FChessPackedMove& Other) const { return Data == Other.Data; }
+	FORCEINLINE bool operator!=(const FChessPackedMove& Other) const { return Data != Other.Data; }
+};
+
+// Packed counterpart of FChessMoveList
+using FChessPackedMoveList = TArray<FChessPackedMove, TInlineAllocator<ChessMoves::MaxMoves>>;
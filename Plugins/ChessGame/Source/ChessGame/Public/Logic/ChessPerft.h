@@ -0,0 +1,53 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ChessData.h"
+
+class UChessBoardState;
+class UChessRuleSet;
+
+/** Node count below one root move. */
+struct FChessPerftDivideEntry
+{
+	FChessMove Move;
+	uint64 Nodes = 0;
+};
+
+struct FChessPerftResult
+{
+	uint64 Nodes = 0;
+	double Seconds = 0.0;
+
+	// Per root move, in generation order
+	TArray<FChessPerftDivideEntry> Divide;
+
+	double GetNodesPerSecond() const { return Seconds > 0.0 ? Nodes / Seconds : 0.0; }
+};
+
+/** Reference position with a published node count. */
+struct FChessPerftPosition
+{
+	const TCHAR* Name;
+	const TCHAR* FEN;
+	int32 Depth;
+	uint64 ExpectedNodes;
+};
+
+/**
+ * Move generator correctness and throughput check: counts leaf nodes of the legal move tree.
+ * Walks the tree with MakeMove/UnmakeMove, so the board is left exactly as it was passed in.
+ */
+class CHESSGAME_API FChessPerft
+{
+public:
+	static uint64 Perft(UChessRuleSet* RuleSet, UChessBoardState* Board, int32 Depth);
+
+	/** Perft with per-root-move counts and timing. */
+	static FChessPerftResult Divide(UChessRuleSet* RuleSet, UChessBoardState* Board, int32 Depth);
+
+	/** Start position, Kiwipete and the usual en passant / castling / promotion edge cases. */
+	static const TArray<FChessPerftPosition>& GetStandardPositions();
+
+	/** Coordinate notation (e2e4, e7e8q) for divide output. */
+	static FString MoveToString(const FChessMove& Move);
+};
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Position keys played since the last irreversible move (capture, pawn move, loss of castling rights).
+ * Keys live in a fixed ring; a side table of occurrence counts makes each repetition check O(1) amortised
+ * instead of a scan back through the window.
+ */
+struct FChessPositionHistory
+{
+	// The fifty-move rule ends the game at 100 plies, so a window larger than that never wraps in practice
+	static constexpr int32 Capacity = 128;
+
+	/** Starts a new window holding only Key. */
+	void Reset(uint64 Key)
+	{
+		Counts.Reset();
+		Num = 0;
+		Head = 0;
+		Push(Key);
+	}
+
+	/** Appends Key and returns how many times it now occurs in the window (including this one). */
+	int32 Push(uint64 Key)
+	{
+		if (Num == Capacity)
+		{
+			// Oldest entry falls out of the window
+			Release(Keys[Head]);
+			Head = (Head + 1) % Capacity;
+			--Num;
+		}
+
+		Keys[(Head + Num) % Capacity] = Key;
+		++Num;
+		return ++Counts.FindOrAdd(Key);
+	}
+
+	/** Swaps the most recent key, for edits that change the current position without making a move. */
+	int32 ReplaceLatest(uint64 Key)
+	{
+		if (Num == 0)
+		{
+			return Push(Key);
+		}
+
+		uint64& Latest = Keys[(Head + Num - 1) % Capacity];
+		Release(Latest);
+		Latest = Key;
+		return ++Counts.FindOrAdd(Key);
+	}
+
+	int32 GetCount(uint64 Key) const
+	{
+		const int32* Count = Counts.Find(Key);
+		return Count ? *Count : 0;
+	}
+
+	int32 GetNum() const { return Num; }
+
+	/** Key at Index in the window, oldest first; GetNum() - 1 is the latest position. */
+	uint64 GetKey(int32 Index) const { return Keys[(Head + Index) % Capacity]; }
+
+private:
+	void Release(uint64 Key)
+	{
+		int32* Count = Counts.Find(Key);
+		if (Count && --(*Count) == 0)
+		{
+			Counts.Remove(Key);
+		}
+	}
+
+	uint64 Keys[Capacity] = {};
+	int32 Head = 0;
+	int32 Num = 0;
+	TMap<uint64, int32> Counts;
+};
@@ -18,30 +18,79 @@ class CHESSGAME_API UChessRuleSet : public UObject
 public:
 	UChessRuleSet();
 
+	// Creates the move rule objects. Rules need no world; the context parameter is only kept for existing callers.
 	UFUNCTION(BlueprintCallable)
 	void Initialize(UObject* WorldContextObject = nullptr);
 
-	// Setup
+	// Setup. FEN is only read for EChessInitMode::FromFEN
 	UFUNCTION(BlueprintCallable)
-	void SetupInitialBoardState(UChessBoardState* BoardState, EChessInitMode InitMode = EChessInitMode::Standard);
+	void SetupInitialBoardState(UChessBoardState* BoardState, EChessInitMode InitMode = EChessInitMode::Standard, const FString& FEN = TEXT(""));
 
 	// Move Generation
 	UFUNCTION(BlueprintCallable)
 	void GenerateLegalMoves(const UChessBoardState* Board, int32 PieceId, TArray<FChessMove>& OutMoves);
 
+	// Allocation-free overloads for C++ callers; append to OutMoves
+	void GenerateLegalMoves(const UChessBoardState* Board, int32 PieceId, FChessMoveList& OutMoves);
+	void GenerateLegalMoves(const UChessBoardState* Board, int32 PieceId, FChessPackedMoveList& OutMoves);
+
+	// Every legal move of Color, mask moves included, in ascending from-square order
+	UFUNCTION(BlueprintCallable)
+	void GenerateAllLegalMoves(const UChessBoardState* Board, EPieceColor Color, TArray<FChessMove>& OutMoves);
+
+	// Allocation-free overloads for C++ callers; append to OutMoves
+	void GenerateAllLegalMoves(const UChessBoardState* Board, EPieceColor Color, FChessMoveList& OutMoves);
+	void GenerateAllLegalMoves(const UChessBoardState* Board, EPieceColor Color, FChessPackedMoveList& OutMoves);
+
+	// True if Color has at least one legal move; stops at the first one found instead of generating them all
+	UFUNCTION(BlueprintCallable)
+	bool HasAnyLegalMove(const UChessBoardState* Board, EPieceColor Color);
+
 	UFUNCTION(BlueprintCallable)
 	bool IsKingInCheck(const UChessBoardState* Board, EPieceColor Color);
 
+	// True if any piece of ByColor attacks Square
+	UFUNCTION(BlueprintCallable)
+	bool IsSquareAttacked(const UChessBoardState* Board, FBoardCoord Square, EPieceColor ByColor);
+
+	// True when neither side can possibly deliver mate (bare kings, a single minor piece, or bishops all on one colour)
+	UFUNCTION(BlueprintCallable)
+	bool IsInsufficientMaterial(const UChessBoardState* Board) const;
+
+	// True when every piece type uses the stock native rule, so bitboard attack tables describe the rules exactly
+	bool UsesStandardRules() const { return bStandardRules; }
+
 protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	TMap<EPieceType, TSubclassOf<class AChessMoveRule>> MoveRuleClasses;
+	TMap<EPieceType, TSubclassOf<class UChessMoveRule>> MoveRuleClasses;
 
 	UPROPERTY()
-	TMap<EPieceType, class AChessMoveRule*> MoveRules;
+	TMap<EPieceType, class UChessMoveRule*> MoveRules;
+
+	bool bStandardRules = false;
+
+	// Private copies of the position that custom-rule legality checks play moves on. One per nesting level, so a
+	// Blueprint move rule that queries the rule set from inside a check gets its own.
+	UPROPERTY(Transient)
+	TArray<UChessBoardState*> ScratchBoards;
+
+	int32 NumScratchInUse = 0;
 
-	void GeneratePseudoLegalMoves(const UChessBoardState* Board, int32 PieceId, TArray<FChessMove>& OutMoves);
-	bool IsMoveLegal(const UChessBoardState* Board, const FChessMove& Move);
+	void GeneratePseudoLegalMoves(const UChessBoardState* Board, int32 PieceId, FChessMoveList& OutMoves);
+
+	// Copies Board into the next free scratch board (see UChessBoardState::CopyFrom) and hands it out until ReleaseScratch
+	UChessBoardState* AcquireScratch(const UChessBoardState* Board);
+	void ReleaseScratch();
+
+	// Custom-rule legal moves of PieceId on Board, tested on Scratch, which must hold the same position
+	void GenerateLegalMovesOnScratch(const UChessBoardState* Board, UChessBoardState* Scratch, int32 PieceId, FChessMoveList& OutMoves);
+
+	// Plays Move on Board and takes it back, so Board is written to in between; pass a scratch copy, never a caller's board
+	bool IsMoveLegal(UChessBoardState* Board, const FChessMove& Move);
 
 	// Helpers
 	FBoardCoord FindKing(const UChessBoardState* Board, EPieceColor Color) const;
+
+	// Slow path for custom (e.g. Blueprint) rules: generate the attacker's moves and look for the square
+	bool IsSquareAttackedByRules(const UChessBoardState* Board, FBoardCoord Square, EPieceColor ByColor);
 };
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ChessData.h"
+#include "ChessBitboards.h"
+
+/**
+ * Zobrist hashing keys. Generated at compile time from a fixed seed so every client and server
+ * derives identical hashes for identical positions.
+ */
+namespace ChessZobrist
+{
+	struct FKeys
+	{
+		uint64 Piece[ChessBitboard::NumColors][ChessBitboard::NumPieceTypes][64] = {};
+		uint64 Mask[ChessBitboard::NumPieceTypes][64] = {};
+		uint64 Castling[64] = {}; // Unmoved piece that can take part in castling, by square
+		uint64 EnPassant[8] = {}; // By file, only when the capture is actually available
+		uint64 BlackToMove = 0;
+	};
+
+	constexpr FKeys MakeKeys()
+	{
+		FKeys Keys;
+		uint64 State = 0x9E3779B97F4A7C15ull;
+		auto Next = [&State]() {
+			// xorshift64*
+			State ^= State >> 12;
+			State ^= State << 25;
+			State ^= State >> 27;
+			return State * 2685821657736338717ull;
+		};
+
+		for (auto& ByType : Keys.Piece)
+			for (auto& BySquare : ByType)
+				for (uint64& Key : BySquare)
+					Key = Next();
+		for (auto& BySquare : Keys.Mask)
+			for (uint64& Key : BySquare)
+				Key = Next();
+		for (uint64& Key : Keys.Castling)
+			Key = Next();
+		for (uint64& Key : Keys.EnPassant)
+			Key = Next();
+		Keys.BlackToMove = Next();
+		return Keys;
+	}
+
+	inline constexpr FKeys Keys = MakeKeys();
+
+	/**
+	 * An unmoved king (real or masked) or an unmoved rook on a corner file is what the castling rule keys on,
+	 * so hashing those pieces' unmoved status captures castling rights exactly.
+	 */
+	FORCEINLINE bool HasCastlingRights(const FPieceInstance& Piece, int32 Square)
+	{
+		if (Piece.bHasMoved)
+		{
+			return false;
+		}
+		const int32 File = Square % 8;
+		return Piece.Type == EPieceType::King || Piece.MaskType == EPieceType::King
+			|| (Piece.Type == EPieceType::Rook && (File == 0 || File == 7));
+	}
+
+	/** Everything a piece standing on Square contributes to the position key. */
+	FORCEINLINE uint64 PieceSquareKey(const FPieceInstance& Piece, int32 Square)
+	{
+		uint64 Key = ChessBitboard::IsValidType(Piece.Type) ? Keys.Piece[(uint8)Piece.Color][(uint8)Piece.Type][Square] : 0;
+		if (ChessBitboard::IsValidType(Piece.MaskType))
+		{
+			Key ^= Keys.Mask[(uint8)Piece.MaskType][Square];
+		}
+		if (HasCastlingRights(Piece, Square))
+		{
+			Key ^= Keys.Castling[Square];
+		}
+		return Key;
+	}
+}
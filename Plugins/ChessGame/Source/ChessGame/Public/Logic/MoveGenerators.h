@@ -15,10 +15,10 @@ class CHESSGAME_API UMoveGeneratorBase : public UObject
 	GENERATED_BODY()
 
 public:
-	virtual void GeneratePseudoMoves(const UChessBoardState* Board, FBoardCoord From, const FPieceInstance& Piece, TArray<FChessMove>& OutMoves) const PURE_VIRTUAL(UMoveGeneratorBase::GeneratePseudoMoves, );
+	virtual void GeneratePseudoMoves(const UChessBoardState* Board, FBoardCoord From, const FPieceInstance& Piece, FChessMoveList& OutMoves) const PURE_VIRTUAL(UMoveGeneratorBase::GeneratePseudoMoves, );
 	
 protected:
-	void AddMove(TArray<FChessMove>& OutMoves, FBoardCoord From, FBoardCoord To, const FPieceInstance& MovingPiece, int32 CapturedPieceId = -1) const;
+	void AddMove(FChessMoveList& OutMoves, FBoardCoord From, FBoardCoord To, const FPieceInstance& MovingPiece, int32 CapturedPieceId = -1) const;
 	bool IsSameColor(const UChessBoardState* Board, FBoardCoord Coord, EPieceColor Color) const;
 	bool IsEnemy(const UChessBoardState* Board, FBoardCoord Coord, EPieceColor Color) const;
 	bool IsEmpty(const UChessBoardState* Board, FBoardCoord Coord) const;
@@ -39,7 +39,7 @@ public:
 	UPROPERTY()
 	bool bOrthogonal = false;
 
-	virtual void GeneratePseudoMoves(const UChessBoardState* Board, FBoardCoord From, const FPieceInstance& Piece, TArray<FChessMove>& OutMoves) const override;
+	virtual void GeneratePseudoMoves(const UChessBoardState* Board, FBoardCoord From, const FPieceInstance& Piece, FChessMoveList& OutMoves) const override;
 };
 
 /**
@@ -51,7 +51,7 @@ class CHESSGAME_API UMoveGenerator_Knight : public UMoveGeneratorBase
 	GENERATED_BODY()
 
 public:
-	virtual void GeneratePseudoMoves(const UChessBoardState* Board, FBoardCoord From, const FPieceInstance& Piece, TArray<FChessMove>& OutMoves) const override;
+	virtual void GeneratePseudoMoves(const UChessBoardState* Board, FBoardCoord From, const FPieceInstance& Piece, FChessMoveList& OutMoves) const override;
 };
 
 /**
@@ -63,7 +63,7 @@ class CHESSGAME_API UMoveGenerator_Pawn : public UMoveGeneratorBase
 	GENERATED_BODY()
 
 public:
-	virtual void GeneratePseudoMoves(const UChessBoardState* Board, FBoardCoord From, const FPieceInstance& Piece, TArray<FChessMove>& OutMoves) const override;
+	virtual void GeneratePseudoMoves(const UChessBoardState* Board, FBoardCoord From, const FPieceInstance& Piece, FChessMoveList& OutMoves) const override;
 };
 
 /**
@@ -75,5 +75,5 @@ class CHESSGAME_API UMoveGenerator_King : public UMoveGeneratorBase
 	GENERATED_BODY()
 
 public:
-	virtual void GeneratePseudoMoves(const UChessBoardState* Board, FBoardCoord From, const FPieceInstance& Piece, TArray<FChessMove>& OutMoves) const override;
+	virtual void GeneratePseudoMoves(const UChessBoardState* Board, FBoardCoord From, const FPieceInstance& Piece, FChessMoveList& OutMoves) const override;
 };
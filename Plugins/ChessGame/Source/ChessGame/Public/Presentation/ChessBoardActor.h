@@ -44,6 +44,9 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Chess")
 	EChessInitMode InitMode = EChessInitMode::Standard;
 
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Chess", meta = (EditCondition = "InitMode == EChessInitMode::FromFEN"))
+	FString InitFEN = TEXT("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+
 	// State
 	UPROPERTY(BlueprintReadOnly, Category = "Chess")
 	UChessGameModel* GameModel;
@@ -95,10 +98,11 @@ public:
 
 	// Network
 	// ProcessMove called by PlayerController (Authority Only)
-	void ProcessMove(FChessMove Move);
+	void ProcessMove(FChessPackedMove Move);
 
+	// Moves travel packed (2 bytes); each side expands them against its own board before applying
 	UFUNCTION(NetMulticast, Reliable)
-	void Multicast_BroadcastMove(FChessMove Move);
+	void Multicast_BroadcastMove(FChessPackedMove Move);
 
 	// Card Effect RPCs - these replicate card effect changes to all clients
 	// Call these from effects - they will route through server if needed
@@ -23,10 +23,10 @@ public:
 	EPieceColor Color;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Chess")
-	TSubclassOf<class AChessMoveRule> MoveRuleClass;
+	TSubclassOf<class UChessMoveRule> MoveRuleClass;
 
 	UPROPERTY(BlueprintReadWrite, Category = "Chess")
-	class AChessMoveRule* MoveRuleInstance;
+	class UChessMoveRule* MoveRuleInstance;
 
 	// Visual Components
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Visuals")
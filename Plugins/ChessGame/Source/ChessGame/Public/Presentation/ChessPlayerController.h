@@ -3,6 +3,7 @@
 #include "CoreMinimal.h"
 #include "GameFramework/PlayerController.h"
 #include "Logic/ChessData.h"
+#include "Logic/ChessPackedMove.h"
 #include "Presentation/ChessBoardActor.h"
 #include "ChessPlayerController.generated.h"
 
@@ -64,9 +65,9 @@ public:
 	// Raycast helper
 	AChessBoardActor* FindBoardUnderCursor(FVector& OutHitLocation);
 
-	// Server RPC to submit move
+	// Server RPC to submit move (packed; the server rebuilds it against its own board)
 	UFUNCTION(Server, Reliable, WithValidation)
-	void Server_SubmitMove(AChessBoardActor* Board, FChessMove Move);
+	void Server_SubmitMove(AChessBoardActor* Board, FChessPackedMove Move);
 
 	// Server RPCs for card effects
 	UFUNCTION(Server, Reliable, WithValidation)
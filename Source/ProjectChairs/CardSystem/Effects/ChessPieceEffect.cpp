@@ -25,7 +25,7 @@ void UChessPieceEffect::OnRemove_Implementation(AChessPieceActor* TargetPiece)
 	// Base implementation does nothing - override in subclasses
 }
 
-TSubclassOf<AChessMoveRule> UChessPieceEffect::GetMoveRuleOverride_Implementation() const
+TSubclassOf<UChessMoveRule> UChessPieceEffect::GetMoveRuleOverride_Implementation() const
 {
 	// Base implementation returns nullptr (no override)
 	return nullptr;
@@ -7,7 +7,7 @@
 #include "ChessPieceEffect.generated.h"
 
 class AChessPieceActor;
-class AChessMoveRule;
+class UChessMoveRule;
 class UChessPieceEffectComponent;
 
 /**
@@ -48,7 +48,7 @@ public:
 
 	/** Returns the move rule class this effect provides, or nullptr for no override */
 	UFUNCTION(BlueprintNativeEvent, Category = "Effect")
-	TSubclassOf<AChessMoveRule> GetMoveRuleOverride() const;
+	TSubclassOf<UChessMoveRule> GetMoveRuleOverride() const;
 
 	/** Initialize the effect with its owning component */
 	void Initialize(UChessPieceEffectComponent* InOwningComponent);
@@ -104,14 +104,14 @@ void UChessPieceEffectComponent::RemoveEffectAtIndex(int32 Index)
 	RefreshMoveRule();
 }
 
-TSubclassOf<AChessMoveRule> UChessPieceEffectComponent::GetEffectiveMoveRuleClass() const
+TSubclassOf<UChessMoveRule> UChessPieceEffectComponent::GetEffectiveMoveRuleClass() const
 {
 	// Traverse stack top-to-bottom, return first non-null override
 	for (int32 i = EffectStack.Num() - 1; i >= 0; --i)
 	{
 		if (EffectStack[i])
 		{
-			TSubclassOf<AChessMoveRule> Override = EffectStack[i]->GetMoveRuleOverride();
+			TSubclassOf<UChessMoveRule> Override = EffectStack[i]->GetMoveRuleOverride();
 			if (Override)
 			{
 				return Override;
@@ -159,46 +159,36 @@ void UChessPieceEffectComponent::RefreshMoveRule()
 		return;
 	}
 
-	TSubclassOf<AChessMoveRule> EffectiveClass = GetEffectiveMoveRuleClass();
+	TSubclassOf<UChessMoveRule> EffectiveClass = GetEffectiveMoveRuleClass();
 
 	// Check if the class has changed
-	TSubclassOf<AChessMoveRule> CurrentClass = OwningPiece->MoveRuleInstance ?
+	TSubclassOf<UChessMoveRule> CurrentClass = OwningPiece->MoveRuleInstance ?
 		OwningPiece->MoveRuleInstance->GetClass() : nullptr;
 
 	if (EffectiveClass != CurrentClass)
 	{
-		// Destroy old instance
-		if (OwningPiece->MoveRuleInstance)
-		{
-			OwningPiece->MoveRuleInstance->Destroy();
-			OwningPiece->MoveRuleInstance = nullptr;
-		}
+		// Drop old instance (rules are plain objects, GC reclaims them)
+		OwningPiece->MoveRuleInstance = nullptr;
 
-		// Spawn new instance if we have a valid class
+		// Create new instance if we have a valid class
 		if (EffectiveClass)
 		{
-			UWorld* World = GetWorld();
-			if (World)
+			OwningPiece->MoveRuleInstance = NewObject<UChessMoveRule>(OwningPiece, EffectiveClass);
+			OwningPiece->MoveRuleClass = EffectiveClass;
+
+			// Configure sliding rule flags if applicable
+			UChessMoveRule_Sliding* SlidingRule = Cast<UChessMoveRule_Sliding>(OwningPiece->MoveRuleInstance);
+			if (SlidingRule)
 			{
-				FActorSpawnParameters SpawnParams;
-				SpawnParams.Owner = OwningPiece;
-				OwningPiece->MoveRuleInstance = World->SpawnActor<AChessMoveRule>(EffectiveClass, SpawnParams);
-				OwningPiece->MoveRuleClass = EffectiveClass;
-
-				// Configure sliding rule flags if applicable
-				AChessMoveRule_Sliding* SlidingRule = Cast<AChessMoveRule_Sliding>(OwningPiece->MoveRuleInstance);
-				if (SlidingRule)
+				// Find the top ChangeMoveset effect that provides this override
+				for (int32 i = EffectStack.Num() - 1; i >= 0; --i)
 				{
-					// Find the top ChangeMoveset effect that provides this override
-					for (int32 i = EffectStack.Num() - 1; i >= 0; --i)
+					UChessPieceEffect_ChangeMoveset* ChangeEffect = Cast<UChessPieceEffect_ChangeMoveset>(EffectStack[i]);
+					if (ChangeEffect && ChangeEffect->GetMoveRuleOverride() == EffectiveClass)
 					{
-						UChessPieceEffect_ChangeMoveset* ChangeEffect = Cast<UChessPieceEffect_ChangeMoveset>(EffectStack[i]);
-						if (ChangeEffect && ChangeEffect->GetMoveRuleOverride() == EffectiveClass)
-						{
-							SlidingRule->bDiagonal = ChangeEffect->bDiagonal;
-							SlidingRule->bOrthogonal = ChangeEffect->bOrthogonal;
-							break;
-						}
+						SlidingRule->bDiagonal = ChangeEffect->bDiagonal;
+						SlidingRule->bOrthogonal = ChangeEffect->bOrthogonal;
+						break;
 					}
 				}
 			}
@@ -8,7 +8,7 @@
 #include "ChessPieceEffectComponent.generated.h"
 
 class UChessPieceEffect;
-class AChessMoveRule;
+class UChessMoveRule;
 class AChessPieceActor;
 
 /**
@@ -29,7 +29,7 @@ public:
 
 	/** The original move rule class before any effects were applied */
 	UPROPERTY(BlueprintReadOnly, Category = "Effects")
-	TSubclassOf<AChessMoveRule> OriginalMoveRuleClass;
+	TSubclassOf<UChessMoveRule> OriginalMoveRuleClass;
 
 	/**
 	 * Creates and applies an effect of the specified class.
@@ -53,7 +53,7 @@ public:
 	 * If no override is found, returns the original move rule class.
 	 */
 	UFUNCTION(BlueprintCallable, Category = "Effects")
-	TSubclassOf<AChessMoveRule> GetEffectiveMoveRuleClass() const;
+	TSubclassOf<UChessMoveRule> GetEffectiveMoveRuleClass() const;
 
 	/**
 	 * Called when the turn changes. Decrements duration when the piece's turn ends.
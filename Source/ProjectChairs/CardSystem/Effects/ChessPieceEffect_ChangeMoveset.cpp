@@ -42,7 +42,7 @@ void UChessPieceEffect_ChangeMoveset::OnApply_Implementation(AChessPieceActor* T
 	// The sliding rule flags are configured there based on this effect's settings.
 }
 
-TSubclassOf<AChessMoveRule> UChessPieceEffect_ChangeMoveset::GetMoveRuleOverride_Implementation() const
+TSubclassOf<UChessMoveRule> UChessPieceEffect_ChangeMoveset::GetMoveRuleOverride_Implementation() const
 {
 	// For Queen, Rook, Bishop use the sliding rule
 	switch (TargetMoveSet)
@@ -50,16 +50,16 @@ TSubclassOf<AChessMoveRule> UChessPieceEffect_ChangeMoveset::GetMoveRuleOverride
 	case EMoveSet::Queen:
 	case EMoveSet::Rook:
 	case EMoveSet::Bishop:
-		return AChessMoveRule_Sliding::StaticClass();
+		return UChessMoveRule_Sliding::StaticClass();
 
 	case EMoveSet::Knight:
-		return AChessMoveRule_Knight::StaticClass();
+		return UChessMoveRule_Knight::StaticClass();
 
 	case EMoveSet::King:
-		return AChessMoveRule_King::StaticClass();
+		return UChessMoveRule_King::StaticClass();
 
 	case EMoveSet::Pawn:
-		return AChessMoveRule_Pawn::StaticClass();
+		return UChessMoveRule_Pawn::StaticClass();
 
 	case EMoveSet::None:
 	default:
@@ -32,5 +32,5 @@ public:
 	bool bOrthogonal;
 
 	virtual void OnApply_Implementation(AChessPieceActor* TargetPiece) override;
-	virtual TSubclassOf<AChessMoveRule> GetMoveRuleOverride_Implementation() const override;
+	virtual TSubclassOf<UChessMoveRule> GetMoveRuleOverride_Implementation() const override;
 };